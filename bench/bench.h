@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+// A tiny benchmark harness. The API mimics Google Benchmark, so the benchmarks can be moved to it later if needed:
+//
+//   void my_benchmark(bench::State& state) {
+//     for (auto _ : state)
+//       do_work();
+//   }
+//   BENCHMARK(my_benchmark);
+//
+// Every benchmark reports the time per iteration and, if set, the throughput in bytes and items (telegrams) per second
+// and the CPU cycles per item. run_all() prints a table or JSON that can be compared with bench/compare.py.
+namespace bench {
+
+// Returns the time stamp counter of the CPU, or 0 if the platform has none.
+// On x86 it counts at the nominal frequency of the CPU, so the "cycles" are only exact with frequency scaling disabled.
+inline uint64_t cycle_counter() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static const void* volatile sink;
+  sink = &value;
+#endif
+}
+
+class State final {
+  size_t _iterations;
+  size_t _bytes_per_iteration = 0;
+  size_t _items_per_iteration = 0;
+
+  class Iterator final {
+    size_t _remaining;
+
+  public:
+    struct [[maybe_unused]] Value final {};
+    explicit Iterator(size_t remaining) : _remaining(remaining) {}
+    Value operator*() const { return {}; }
+    Iterator& operator++() {
+      --_remaining;
+      return *this;
+    }
+    bool operator!=(const Iterator& other) const { return _remaining != other._remaining; }
+  };
+
+public:
+  explicit State(size_t iterations) : _iterations(iterations) {}
+  size_t iterations() const { return _iterations; }
+
+  // Enables the throughput column in the report
+  void set_bytes_per_iteration(size_t bytes) { _bytes_per_iteration = bytes; }
+  size_t bytes_per_iteration() const { return _bytes_per_iteration; }
+
+  // Enables the items/s and cycles/item columns. An item is usually a telegram.
+  void set_items_per_iteration(size_t items) { _items_per_iteration = items; }
+  size_t items_per_iteration() const { return _items_per_iteration; }
+
+  Iterator begin() const { return Iterator(_iterations); }
+  Iterator end() const { return Iterator(0); }
+};
+
+using BenchmarkFunction = void (*)(State&);
+
+struct Benchmark final {
+  const char* name;
+  BenchmarkFunction function;
+};
+
+inline std::vector<Benchmark>& registry() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+struct Registrar final {
+  Registrar(const char* name, BenchmarkFunction function) { registry().push_back({name, function}); }
+};
+
+struct Result final {
+  size_t iterations;
+  double ns_per_iteration;
+  double cycles_per_iteration; // 0 if the platform has no cycle counter
+  size_t bytes_per_iteration;
+  size_t items_per_iteration;
+
+  double bytes_per_second() const { return static_cast<double>(bytes_per_iteration) * 1e9 / ns_per_iteration; }
+  double items_per_second() const { return static_cast<double>(items_per_iteration) * 1e9 / ns_per_iteration; }
+  double cycles_per_item() const { return cycles_per_iteration / static_cast<double>(items_per_iteration); }
+};
+
+// Runs the benchmark with a growing number of iterations until it takes long enough to be measured reliably.
+// The measurement is then repeated and the fastest run is reported, to filter out noise from other processes.
+inline Result run(const Benchmark& benchmark) {
+  using Clock = std::chrono::steady_clock;
+  constexpr auto kMinDuration = std::chrono::milliseconds(100);
+  constexpr int kRepetitions = 5;
+
+  struct Measurement final {
+    Clock::duration elapsed;
+    uint64_t cycles;
+    size_t bytes;
+    size_t items;
+  };
+
+  auto measure = [&](size_t iterations) {
+    State state(iterations);
+    const auto start = Clock::now();
+    const auto start_cycles = cycle_counter();
+    benchmark.function(state);
+    const auto cycles = cycle_counter() - start_cycles;
+    return Measurement{Clock::now() - start, cycles, state.bytes_per_iteration(), state.items_per_iteration()};
+  };
+
+  size_t iterations = 1;
+  auto best = measure(iterations);
+  while (best.elapsed < kMinDuration) {
+    iterations *= 2;
+    best = measure(iterations);
+  }
+  for (int i = 1; i < kRepetitions; ++i) {
+    const auto measurement = measure(iterations);
+    if (measurement.elapsed < best.elapsed)
+      best = measurement;
+  }
+  const auto n = static_cast<double>(iterations);
+  return {iterations, std::chrono::duration<double, std::nano>(best.elapsed).count() / n, static_cast<double>(best.cycles) / n, best.bytes, best.items};
+}
+
+inline void print_text(const char* name, const Result& result) {
+  std::printf("%-60s %12.1f ns", name, result.ns_per_iteration);
+  if (result.bytes_per_iteration != 0)
+    std::printf(" %10.1f MB/s", result.bytes_per_second() / 1e6);
+  if (result.items_per_iteration != 0) {
+    std::printf(" %12.0f telegrams/s", result.items_per_second());
+    if (result.cycles_per_iteration != 0)
+      std::printf(" %10.0f cycles/telegram", result.cycles_per_item());
+  }
+  std::printf("\n");
+}
+
+// One benchmark per line, so two reports can be compared with a line based diff too
+inline void print_json(const char* name, const Result& result, bool last) {
+  std::printf("    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_iteration\": %.3f", name, result.iterations, result.ns_per_iteration);
+  if (result.cycles_per_iteration != 0)
+    std::printf(", \"cycles_per_iteration\": %.1f", result.cycles_per_iteration);
+  if (result.bytes_per_iteration != 0)
+    std::printf(", \"bytes_per_second\": %.0f", result.bytes_per_second());
+  if (result.items_per_iteration != 0) {
+    std::printf(", \"items_per_second\": %.1f", result.items_per_second());
+    if (result.cycles_per_iteration != 0)
+      std::printf(", \"cycles_per_item\": %.1f", result.cycles_per_item());
+  }
+  std::printf("}%s\n", last ? "" : ",");
+}
+
+inline int run_all(std::string_view filter, bool json) {
+  std::vector<const Benchmark*> selected;
+  for (const auto& benchmark : registry()) {
+    if (filter.empty() || std::string_view(benchmark.name).find(filter) != std::string_view::npos)
+      selected.push_back(&benchmark);
+  }
+
+  if (json)
+    std::printf("{\n  \"benchmarks\": [\n");
+  for (size_t i = 0; i < selected.size(); ++i) {
+    const auto result = run(*selected[i]);
+    if (json) {
+      print_json(selected[i]->name, result, i + 1 == selected.size());
+    } else {
+      print_text(selected[i]->name, result);
+    }
+    std::fflush(stdout);
+  }
+  if (json)
+    std::printf("  ]\n}\n");
+  return 0;
+}
+
+}
+
+#define BENCHMARK(function) static const bench::Registrar function##_registrar(#function, function)
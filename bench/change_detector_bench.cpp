@@ -0,0 +1,31 @@
+#include "bench.h"
+#include "dsmr_parser/change_detector.h"
+#include "field_sets.h"
+#include "telegrams.h"
+
+using namespace dsmr_parser;
+
+namespace {
+
+template <typename Data>
+struct Detector;
+
+template <typename... Ts>
+struct Detector<ParsedData<Ts...>> {
+  using type = ChangeDetector<Ts...>;
+};
+
+// Compares all fields of a telegram that didn't change, after it was parsed
+void detect_changes_dsmr5_full_telegram(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  bench::FieldsAll data;
+  DsmrParser::parse(data, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full));
+  Detector<bench::FieldsAll>::type detector;
+  for (auto _ : state)
+    bench::do_not_optimize(detector.update(data));
+}
+
+}
+
+BENCHMARK(detect_changes_dsmr5_full_telegram);
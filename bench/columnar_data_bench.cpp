@@ -0,0 +1,45 @@
+#include "bench.h"
+#include "dsmr_parser/columnar_data.h"
+#include "telegrams.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+using namespace dsmr_parser;
+using namespace dsmr_parser::fields;
+
+namespace {
+
+constexpr size_t kBatchSize = 64;
+
+std::vector<DsmrUnencryptedTelegram> make_batch() { return std::vector<DsmrUnencryptedTelegram>(kBatchSize, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)); }
+
+void parse_batch_dsmr5_full_telegram_5_columns(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size() * kBatchSize);
+  state.set_items_per_iteration(kBatchSize);
+  const auto batch = make_batch();
+  auto columns = std::make_unique<ColumnarData<kBatchSize, energy_delivered_tariff1, energy_delivered_tariff2, power_delivered, gas_delivered, voltage_l1>>();
+  for (auto _ : state) {
+    columns->clear();
+    bench::do_not_optimize(DsmrParser::parse_batch(*columns, batch));
+  }
+}
+
+void parse_dsmr5_full_telegram_5_fields_per_telegram(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size() * kBatchSize);
+  state.set_items_per_iteration(kBatchSize);
+  const auto batch = make_batch();
+  using Data = ParsedData<energy_delivered_tariff1, energy_delivered_tariff2, power_delivered, gas_delivered, voltage_l1>;
+  auto rows = std::make_unique<std::array<Data, kBatchSize>>();
+  for (auto _ : state) {
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      (*rows)[i] = Data{};
+      bench::do_not_optimize(DsmrParser::parse((*rows)[i], batch[i]));
+    }
+  }
+}
+
+}
+
+BENCHMARK(parse_batch_dsmr5_full_telegram_5_columns);
+BENCHMARK(parse_dsmr5_full_telegram_5_fields_per_telegram);
@@ -0,0 +1,42 @@
+#include "bench.h"
+#include "dsmr_parser/compact_data.h"
+#include "field_sets.h"
+#include "telegrams.h"
+
+using namespace dsmr_parser;
+
+namespace {
+
+template <typename Data>
+struct Compact;
+
+template <typename... Ts>
+struct Compact<ParsedData<Ts...>> {
+  using type = CompactParsedData<Ts...>;
+};
+
+// One ParsedData per telegram, like parse_dsmr5_full_telegram
+void parse_dsmr5_full_telegram_new_parsed_data(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state) {
+    bench::FieldsAll data;
+    bench::do_not_optimize(DsmrParser::parse(data, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+  }
+}
+
+// One CompactParsedData for all telegrams, cleared with reset()
+void parse_dsmr5_full_telegram_reused_compact_data(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  Compact<bench::FieldsAll>::type data;
+  for (auto _ : state) {
+    data.reset();
+    bench::do_not_optimize(data.parse(DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+  }
+}
+
+}
+
+BENCHMARK(parse_dsmr5_full_telegram_new_parsed_data);
+BENCHMARK(parse_dsmr5_full_telegram_reused_compact_data);
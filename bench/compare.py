@@ -0,0 +1,37 @@
+#!/usr/bin/env python3
+# Compares two JSON reports of dsmr_parser_bench:
+#   dsmr_parser_bench --json > old.json
+#   ... change the code ...
+#   dsmr_parser_bench --json > new.json
+#   bench/compare.py old.json new.json
+# Prints the time per iteration of every benchmark in both reports and the change in percent.
+
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        return {b["name"]: b for b in json.load(f)["benchmarks"]}
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: compare.py old.json new.json", file=sys.stderr)
+        return 2
+    old, new = load(sys.argv[1]), load(sys.argv[2])
+    print(f"{'benchmark':<60} {'old ns':>12} {'new ns':>12} {'change':>8} {'cycles/item':>12}")
+    for name, result in new.items():
+        cycles = f"{result['cycles_per_item']:.0f}" if "cycles_per_item" in result else ""
+        if name not in old:
+            print(f"{name:<60} {'':>12} {result['ns_per_iteration']:>12.1f} {'new':>8} {cycles:>12}")
+            continue
+        before, after = old[name]["ns_per_iteration"], result["ns_per_iteration"]
+        print(f"{name:<60} {before:>12.1f} {after:>12.1f} {(after - before) / before * 100:>+7.1f}% {cycles:>12}")
+    for name in old.keys() - new.keys():
+        print(f"{name:<60} {old[name]['ns_per_iteration']:>12.1f} {'':>12} {'removed':>8}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
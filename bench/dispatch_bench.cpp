@@ -0,0 +1,69 @@
+#include "bench.h"
+#include "field_sets.h"
+#include <array>
+#include <string_view>
+#include <utility>
+
+using namespace dsmr_parser;
+
+namespace {
+
+// Lines for the fields that are part of every field set
+const std::array<std::pair<ObisId, std::string_view>, 5> known_lines = {{
+    {ObisId(1, 3, 0, 2, 8), "(50)"},
+    {ObisId(1, 0, 1, 7, 0), "(00.318*kW)"},
+    {ObisId(1, 0, 32, 7, 0), "(230.1*V)"},
+    {ObisId(1, 0, 31, 7, 0), "(001*A)"},
+    {ObisId(0, 0, 96, 7, 21), "(00008)"},
+}};
+
+// Lines with OBIS ids that are not defined in fields.h
+const std::array<std::pair<ObisId, std::string_view>, 5> unknown_lines = {{
+    {ObisId(1, 0, 5, 8, 0), "(000000.000*kvarh)"},
+    {ObisId(0, 0, 96, 50, 68), "(ON)"},
+    {ObisId(1, 0, 33, 24, 0), "(0.998)"},
+    {ObisId(0, 2, 24, 1, 0), "(007)"},
+    {ObisId(1, 0, 1, 29, 0), "(00.123*kWh)"},
+}};
+
+template <typename Data>
+void dispatch_known(bench::State& state) {
+  Data data;
+  ParseFailure failure;
+  for (auto _ : state) {
+    data.p1_version_present = false;
+    data.power_delivered_present = false;
+    data.voltage_l1_present = false;
+    data.current_l1_present = false;
+    data.electricity_failures_present = false;
+    for (const auto& [id, value] : known_lines)
+      bench::do_not_optimize(data.parse_line(id, ValueGroups(value, failure)));
+  }
+}
+
+template <typename Data>
+void dispatch_unknown(bench::State& state) {
+  Data data;
+  ParseFailure failure;
+  for (auto _ : state) {
+    for (const auto& [id, value] : unknown_lines)
+      bench::do_not_optimize(data.parse_line(id, ValueGroups(value, failure)));
+  }
+}
+
+// The time per iteration should stay the same for all field set sizes.
+void dispatch_known_5_fields(bench::State& state) { dispatch_known<bench::Fields5>(state); }
+void dispatch_known_50_fields(bench::State& state) { dispatch_known<bench::Fields50>(state); }
+void dispatch_known_all_fields(bench::State& state) { dispatch_known<bench::FieldsAll>(state); }
+void dispatch_unknown_5_fields(bench::State& state) { dispatch_unknown<bench::Fields5>(state); }
+void dispatch_unknown_50_fields(bench::State& state) { dispatch_unknown<bench::Fields50>(state); }
+void dispatch_unknown_all_fields(bench::State& state) { dispatch_unknown<bench::FieldsAll>(state); }
+
+}
+
+BENCHMARK(dispatch_known_5_fields);
+BENCHMARK(dispatch_known_50_fields);
+BENCHMARK(dispatch_known_all_fields);
+BENCHMARK(dispatch_unknown_5_fields);
+BENCHMARK(dispatch_unknown_50_fields);
+BENCHMARK(dispatch_unknown_all_fields);
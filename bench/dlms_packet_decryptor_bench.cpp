@@ -0,0 +1,63 @@
+#include "bench.h"
+#include "dsmr_parser/decryption/aes128gcm_bearssl.h"
+#include "dsmr_parser/decryption/aes128gcm_mbedtls.h"
+#include "dsmr_parser/decryption/aes128gcm_tfpsa.h"
+#include "dsmr_parser/dlms_packet_decryptor.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <source_location>
+#include <vector>
+
+using namespace dsmr_parser;
+
+namespace {
+
+// The Smarty packet of the decryption tests, encrypted with the key AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA
+const std::vector<uint8_t>& encrypted_packet() {
+  static const auto packet = [] {
+    const auto path = std::filesystem::path(std::source_location::current().file_name()).parent_path().parent_path() / "tests" / "test_data" / "encrypted_packet.bin";
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (bytes.empty()) {
+      std::fprintf(stderr, "Can't read '%s'\n", path.string().c_str());
+      std::exit(1);
+    }
+    return bytes;
+  }();
+  return packet;
+}
+
+// The packet is decrypted in place, so every iteration decrypts a fresh copy. The copy is part of the measurement.
+template <typename GcmDecryptor>
+void decrypt_packet(bench::State& state) {
+  const auto& packet = encrypted_packet();
+  state.set_bytes_per_iteration(packet.size());
+  state.set_items_per_iteration(1);
+  GcmDecryptor gcm_decryptor;
+  gcm_decryptor.set_encryption_key(*Aes128GcmDecryptionKey::from_hex("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA"));
+  DlmsPacketDecryptor decryptor(gcm_decryptor);
+  std::vector<uint8_t> buffer(packet.size());
+  for (auto _ : state) {
+    buffer = packet;
+    const auto telegram = decryptor.decrypt_inplace(buffer);
+    if (!telegram) {
+      std::fprintf(stderr, "Decryption failed\n");
+      std::exit(1);
+    }
+    bench::do_not_optimize(telegram);
+  }
+}
+
+void decrypt_packet_mbedtls(bench::State& state) { decrypt_packet<Aes128GcmMbedTls>(state); }
+void decrypt_packet_bearssl(bench::State& state) { decrypt_packet<Aes128GcmBearSsl>(state); }
+void decrypt_packet_tfpsa(bench::State& state) { decrypt_packet<Aes128GcmTfPsa>(state); }
+
+}
+
+BENCHMARK(decrypt_packet_mbedtls);
+BENCHMARK(decrypt_packet_bearssl);
+BENCHMARK(decrypt_packet_tfpsa);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/parser.h"
+
+// ParsedData instantiations of different sizes. All of them contain the fields of Fields5,
+// so the same telegram lines can be dispatched to each of them.
+namespace bench {
+using namespace dsmr_parser::fields;
+
+using Fields5 = dsmr_parser::ParsedData<
+    p1_version, power_delivered, voltage_l1, current_l1, electricity_failures>;
+
+using Fields10 = dsmr_parser::ParsedData<
+    identification, timestamp, energy_delivered_tariff1, energy_delivered_tariff2, energy_returned_tariff1, energy_returned_tariff2, power_delivered,
+    power_returned, electricity_tariff, gas_delivered>;
+
+using Fields50 = dsmr_parser::ParsedData<
+    identification, p1_version_be, timestamp, equipment_id, energy_delivered_lux, energy_delivered_tariff1, energy_delivered_tariff2,
+    energy_delivered_tariff3, energy_delivered_tariff4, energy_returned_lux, energy_returned_tariff1, energy_returned_tariff2,
+    energy_returned_tariff3, energy_returned_tariff4, total_imported_energy, reactive_energy_delivered_tariff1, reactive_energy_delivered_tariff2,
+    reactive_energy_delivered_tariff3, reactive_energy_delivered_tariff4, total_exported_energy, reactive_energy_returned_tariff1,
+    reactive_energy_returned_tariff2, reactive_energy_returned_tariff3, reactive_energy_returned_tariff4, energy_delivered_tariff1_ch,
+    energy_delivered_tariff2_ch, energy_returned_tariff1_ch, energy_returned_tariff2_ch, energy_delivered_tariff1_il, energy_delivered_tariff2_il,
+    energy_delivered_tariff3_il, energy_returned_tariff1_il, energy_returned_tariff2_il, energy_returned_tariff3_il, electricity_tariff_il,
+    electricity_failure_log_il, electricity_tariff, power_returned, reactive_power_delivered, reactive_power_returned, power_delivered_ch,
+    power_returned_ch, electricity_threshold, electricity_switch_position, electricity_long_failures, p1_version, power_delivered, voltage_l1,
+    current_l1, electricity_failures>;
+
+// Every field defined in fields.h
+using FieldsAll = dsmr_parser::ParsedData<
+    identification, p1_version, p1_version_be, timestamp, equipment_id, energy_delivered_lux, energy_delivered_tariff1, energy_delivered_tariff2,
+    energy_delivered_tariff3, energy_delivered_tariff4, energy_returned_lux, energy_returned_tariff1, energy_returned_tariff2,
+    energy_returned_tariff3, energy_returned_tariff4, total_imported_energy, reactive_energy_delivered_tariff1, reactive_energy_delivered_tariff2,
+    reactive_energy_delivered_tariff3, reactive_energy_delivered_tariff4, total_exported_energy, reactive_energy_returned_tariff1,
+    reactive_energy_returned_tariff2, reactive_energy_returned_tariff3, reactive_energy_returned_tariff4, energy_delivered_tariff1_ch,
+    energy_delivered_tariff2_ch, energy_returned_tariff1_ch, energy_returned_tariff2_ch, energy_delivered_tariff1_il, energy_delivered_tariff2_il,
+    energy_delivered_tariff3_il, energy_returned_tariff1_il, energy_returned_tariff2_il, energy_returned_tariff3_il, electricity_tariff_il,
+    electricity_failure_log_il, electricity_tariff, power_delivered, power_returned, reactive_power_delivered, reactive_power_returned,
+    power_delivered_ch, power_returned_ch, electricity_threshold, electricity_switch_position, electricity_failures, electricity_long_failures,
+    electricity_failure_log, electricity_sags_l1, voltage_sag_time_l1, voltage_sag_l1, electricity_sags_l2, voltage_sag_time_l2, voltage_sag_l2,
+    electricity_sags_l3, voltage_sag_time_l3, voltage_sag_l3, electricity_swells_l1, voltage_swell_time_l1, voltage_swell_l1, electricity_swells_l2,
+    voltage_swell_time_l2, voltage_swell_l2, electricity_swells_l3, voltage_swell_time_l3, voltage_swell_l3, message_short, message_long, voltage_l1,
+    voltage_avg_l1, voltage_l2, voltage_avg_l2, voltage_l3, voltage_avg_l3, voltage, frequency, abs_power, current_l1, current_fuse_l1, current_l2,
+    current_fuse_l2, current_l3, current_fuse_l3, power_delivered_l1, power_delivered_l2, power_delivered_l3, power_returned_l1, power_returned_l2,
+    power_returned_l3, current, current_n, current_sum, reactive_power_delivered_l1, reactive_power_delivered_l2, reactive_power_delivered_l3,
+    reactive_power_returned_l1, reactive_power_returned_l2, reactive_power_returned_l3, apparent_delivery_power, apparent_delivery_power_l1,
+    apparent_delivery_power_l2, apparent_delivery_power_l3, apparent_return_power, apparent_return_power_l1, apparent_return_power_l2,
+    apparent_return_power_l3, active_demand_power, active_demand_net, active_demand_abs, gas_device_type, gas_equipment_id, gas_equipment_id_be,
+    gas_valve_position, gas_delivered, gas_delivered_gj, gas_delivered_be, gas_delivered_text, thermal_device_type, thermal_equipment_id,
+    thermal_valve_position, thermal_delivered, water_device_type, water_equipment_id, water_valve_position, water_delivered, sub_device_type,
+    sub_equipment_id, sub_valve_position, sub_delivered, active_energy_import_current_average_demand, active_energy_export_current_average_demand,
+    reactive_energy_import_current_average_demand, reactive_energy_export_current_average_demand, apparent_energy_import_current_average_demand,
+    apparent_energy_export_current_average_demand, active_energy_import_last_completed_demand, active_energy_export_last_completed_demand,
+    reactive_energy_import_last_completed_demand, reactive_energy_export_last_completed_demand, apparent_energy_import_last_completed_demand,
+    apparent_energy_export_last_completed_demand, active_energy_import_maximum_demand_running_month,
+    active_energy_import_maximum_demand_last_13_months, fw_core_version, fw_core_checksum, fw_module_version, fw_module_checksum, power_factor,
+    power_factor_l1, power_factor_l2, power_factor_l3, min_power_factor, period_3_for_instantaneous_values>;
+
+}
@@ -0,0 +1,53 @@
+#include "bench.h"
+#include "dsmr_parser/line_cache.h"
+#include "field_sets.h"
+#include "telegrams.h"
+#include <array>
+#include <cstddef>
+#include <string>
+
+using namespace dsmr_parser;
+
+namespace {
+
+template <typename Data>
+struct Cache;
+
+template <typename... Ts>
+struct Cache<ParsedData<Ts...>> {
+  using type = LineCache<64, Ts...>;
+};
+
+// The same telegram again, skipped by the fingerprint
+void parse_repeated_dsmr5_full_telegram_line_cache(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  Cache<bench::FieldsAll>::type cache;
+  for (auto _ : state) {
+    bench::FieldsAll data;
+    bench::do_not_optimize(cache.parse(data, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+  }
+}
+
+// Telegrams that differ in the power and the timestamp, like the ones a meter sends every second
+void parse_changing_dsmr5_full_telegram_line_cache(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  std::array<std::string, 2> telegrams;
+  for (size_t i = 0; i < telegrams.size(); ++i) {
+    telegrams[i] = std::string(bench::telegrams::dsmr5_full);
+    telegrams[i][telegrams[i].find("185916W") + 5] = static_cast<char>('0' + i);
+    telegrams[i][telegrams[i].find("1-0:1.7.0(") + 14] = static_cast<char>('0' + i);
+  }
+  Cache<bench::FieldsAll>::type cache;
+  size_t i = 0;
+  for (auto _ : state) {
+    bench::FieldsAll data;
+    bench::do_not_optimize(cache.parse(data, DsmrUnencryptedTelegram(telegrams[i++ % telegrams.size()])));
+  }
+}
+
+}
+
+BENCHMARK(parse_repeated_dsmr5_full_telegram_line_cache);
+BENCHMARK(parse_changing_dsmr5_full_telegram_line_cache);
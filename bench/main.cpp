@@ -0,0 +1,19 @@
+#include "bench.h"
+#include <string_view>
+
+// Usage: dsmr_parser_bench [--json] [filter]
+// Runs all benchmarks whose name contains the filter string.
+// With --json the results are printed as JSON, to be compared with bench/compare.py.
+int main(int argc, char** argv) {
+  bool json = false;
+  std::string_view filter;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view argument = argv[i];
+    if (argument == "--json") {
+      json = true;
+    } else {
+      filter = argument;
+    }
+  }
+  return bench::run_all(filter, json);
+}
@@ -0,0 +1,50 @@
+#include "bench.h"
+#include "dsmr_parser/packet_accumulator.h"
+#include "dsmr_parser/util.h"
+#include "telegrams.h"
+#include <array>
+#include <cstdio>
+#include <string>
+
+using namespace dsmr_parser;
+
+namespace {
+
+// The telegram as it is sent by the meter: followed by its CRC and a line ending
+std::string with_crc(std::string_view telegram) {
+  char crc[8];
+  std::snprintf(crc, sizeof(crc), "%04X\r\n", Crc16::calculate(telegram));
+  return std::string(telegram) + crc;
+}
+
+void accumulate_dsmr5_full_telegram(bench::State& state, bool check_crc) {
+  const auto telegram = with_crc(bench::telegrams::dsmr5_full);
+  state.set_bytes_per_iteration(telegram.size());
+  state.set_items_per_iteration(1);
+  std::array<uint8_t, 2048> buffer;
+  PacketAccumulator accumulator(buffer, check_crc);
+  for (auto _ : state) {
+    for (const char byte : telegram)
+      bench::do_not_optimize(accumulator.process_byte(static_cast<uint8_t>(byte)));
+  }
+}
+
+void accumulate_dsmr5_full_telegram_with_crc(bench::State& state) { accumulate_dsmr5_full_telegram(state, true); }
+void accumulate_dsmr5_full_telegram_without_crc(bench::State& state) { accumulate_dsmr5_full_telegram(state, false); }
+
+void crc16_dsmr5_full_telegram(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state) {
+    // Hide the telegram from the optimizer, otherwise the CRC of the constant is computed at compile time
+    auto telegram = bench::telegrams::dsmr5_full;
+    bench::do_not_optimize(telegram);
+    bench::do_not_optimize(Crc16::calculate(telegram));
+  }
+}
+
+}
+
+BENCHMARK(accumulate_dsmr5_full_telegram_with_crc);
+BENCHMARK(accumulate_dsmr5_full_telegram_without_crc);
+BENCHMARK(crc16_dsmr5_full_telegram);
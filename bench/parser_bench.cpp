@@ -0,0 +1,164 @@
+#include "bench.h"
+#include "dsmr_parser/tokenizer.h"
+#include "field_sets.h"
+#include "telegrams.h"
+#include <array>
+#include <string_view>
+#include <utility>
+
+using namespace dsmr_parser;
+
+namespace {
+
+template <const std::string_view& Telegram>
+void parse_telegram(bench::State& state) {
+  state.set_bytes_per_iteration(Telegram.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state) {
+    bench::FieldsAll data;
+    bench::do_not_optimize(DsmrParser::parse(data, DsmrUnencryptedTelegram(Telegram)));
+  }
+}
+
+void parse_dsmr5_full_telegram(bench::State& state) { parse_telegram<bench::telegrams::dsmr5_full>(state); }
+void parse_dsmr4_telegram(bench::State& state) { parse_telegram<bench::telegrams::dsmr4>(state); }
+void parse_smarty_telegram(bench::State& state) { parse_telegram<bench::telegrams::smarty>(state); }
+void parse_belgian_telegram(bench::State& state) { parse_telegram<bench::telegrams::belgian>(state); }
+void parse_swiss_telegram(bench::State& state) { parse_telegram<bench::telegrams::swiss>(state); }
+void parse_israeli_telegram(bench::State& state) { parse_telegram<bench::telegrams::israeli>(state); }
+void parse_lithuanian_telegram(bench::State& state) { parse_telegram<bench::telegrams::lithuanian>(state); }
+
+void parse_dsmr5_full_telegram_no_fields(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state) {
+    ParsedData<> data;
+    bench::do_not_optimize(DsmrParser::parse(data, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+  }
+}
+
+// Decodes every line without fields, like a gateway that forwards all values
+void visit_dsmr5_full_telegram(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    const auto add = [&](const ObisId&, const ObisValue& value) { sum += value.number; };
+    bench::do_not_optimize(DsmrParser::visit(DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full), add));
+    bench::do_not_optimize(sum);
+  }
+}
+
+// Checks the structure only, like a gateway that forwards the telegram
+void validate_dsmr5_full_telegram(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state)
+    bench::do_not_optimize(DsmrParser::validate(DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+}
+
+// Three subsystems with overlapping fields: each one parses the telegram, or the telegram is parsed once into all of them
+void parse_dsmr5_full_telegram_three_times(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state) {
+    bench::Fields5 diagnostics;
+    bench::Fields10 billing;
+    bench::Fields10 display;
+    bench::do_not_optimize(DsmrParser::parse(diagnostics, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+    bench::do_not_optimize(DsmrParser::parse(billing, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+    bench::do_not_optimize(DsmrParser::parse(display, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+  }
+}
+
+void parse_dsmr5_full_telegram_three_views(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state) {
+    bench::Fields5 diagnostics;
+    bench::Fields10 billing;
+    bench::Fields10 display;
+    bench::do_not_optimize(DsmrParser::parse(DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full), diagnostics, billing, display));
+  }
+}
+
+// Values in the formats that are common in telegrams: with decimals, without decimals and integer fallback units
+const std::array<std::pair<std::string_view, const char*>, 4> numbers = {{
+    {"(000671.578*kWh)", "kWh"},
+    {"(00.318*kW)", "kW"},
+    {"(234.0*V)", "V"},
+    {"(000441879*Wh)", "Wh"},
+}};
+
+void parse_num_values(bench::State& state) {
+  for (auto _ : state) {
+    for (const auto& [number, unit] : numbers) {
+      int32_t value;
+      bench::do_not_optimize(parse_num(value, 3, unit, number));
+      bench::do_not_optimize(value);
+    }
+  }
+}
+
+// The same values with the units packed at compile time, like the fields do
+void parse_num_packed_values(bench::State& state) {
+  static constexpr std::array<PackedUnit, 4> units = {PackedUnit("kWh"), PackedUnit("kW"), PackedUnit("V"), PackedUnit("Wh")};
+  ParseFailure failure;
+  for (auto _ : state) {
+    for (size_t i = 0; i < numbers.size(); ++i) {
+      int32_t value;
+      bench::do_not_optimize(parse_num(value, 3, units[i], numbers[i].first, failure));
+      bench::do_not_optimize(value);
+    }
+  }
+}
+
+// Values that are rejected: wrong unit, missing unit, invalid digit, missing '('. Only the reason and the position are recorded.
+const std::array<std::pair<std::string_view, const char*>, 4> invalid_numbers = {{
+    {"(000671.578*kW)", "kWh"},
+    {"(00.318)", "kW"},
+    {"(2A4.0*V)", "V"},
+    {"000441879*Wh)", "Wh"},
+}};
+
+void parse_num_invalid_values(bench::State& state) {
+  ParseFailure failure;
+  for (auto _ : state) {
+    for (const auto& [number, unit] : invalid_numbers) {
+      int32_t value;
+      bench::do_not_optimize(parse_num(value, 3, unit, number, failure));
+      bench::do_not_optimize(failure);
+    }
+  }
+}
+
+const std::array<std::string_view, 5> obis_ids = {"1-0:1.8.1(", "0-0:96.1.1(", "1-0:32.7.0(", "0-1:24.2.1(", "1-0:99.97.0("};
+
+void parse_obis_ids(bench::State& state) {
+  for (auto _ : state) {
+    for (const auto text : obis_ids) {
+      ObisId id;
+      bench::do_not_optimize(parse_obis(id, text));
+      bench::do_not_optimize(id);
+    }
+  }
+}
+
+}
+
+BENCHMARK(parse_dsmr5_full_telegram);
+BENCHMARK(parse_dsmr5_full_telegram_no_fields);
+BENCHMARK(visit_dsmr5_full_telegram);
+BENCHMARK(validate_dsmr5_full_telegram);
+BENCHMARK(parse_dsmr5_full_telegram_three_times);
+BENCHMARK(parse_dsmr5_full_telegram_three_views);
+BENCHMARK(parse_dsmr4_telegram);
+BENCHMARK(parse_smarty_telegram);
+BENCHMARK(parse_belgian_telegram);
+BENCHMARK(parse_swiss_telegram);
+BENCHMARK(parse_israeli_telegram);
+BENCHMARK(parse_lithuanian_telegram);
+BENCHMARK(parse_num_values);
+BENCHMARK(parse_num_packed_values);
+BENCHMARK(parse_num_invalid_values);
+BENCHMARK(parse_obis_ids);
@@ -0,0 +1,72 @@
+#include "bench.h"
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/schema.h"
+#include "telegrams.h"
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+using namespace dsmr_parser;
+using namespace dsmr_parser::fields;
+
+namespace {
+
+// A typical configuration, once as ParsedData and once as a runtime schema
+using ConfiguredFields = ParsedData<identification, p1_version, timestamp, equipment_id, energy_delivered_tariff1, energy_delivered_tariff2,
+                                    energy_returned_tariff1, energy_returned_tariff2, electricity_tariff, power_delivered, power_returned,
+                                    electricity_failures, voltage_l1, current_l1, gas_delivered>;
+
+struct ConfiguredValues {
+  std::string_view identification, p1_version, timestamp, equipment_id, electricity_tariff, gas_timestamp;
+  FixedValue energy_delivered_tariff1, energy_delivered_tariff2, energy_returned_tariff1, energy_returned_tariff2, power_delivered, power_returned,
+      voltage_l1, current_l1, gas_delivered;
+  uint32_t electricity_failures;
+  std::array<bool, 15> present;
+};
+
+#define VALUE(name, index) offsetof(ConfiguredValues, name), offsetof(ConfiguredValues, present) + (index)
+
+constexpr std::array schema = {
+    SchemaField::raw(ObisId(255, 255, 255, 255, 255, 255), VALUE(identification, 0)),
+    SchemaField::string(ObisId(1, 3, 0, 2, 8), 2, 2, VALUE(p1_version, 1)),
+    SchemaField::timestamp(ObisId(0, 0, 1, 0, 0), VALUE(timestamp, 2)),
+    SchemaField::string(ObisId(0, 0, 96, 1, 1), 0, 96, VALUE(equipment_id, 3)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 1, 8, 1), units::kWh, units::Wh, VALUE(energy_delivered_tariff1, 4)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 1, 8, 2), units::kWh, units::Wh, VALUE(energy_delivered_tariff2, 5)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 2, 8, 1), units::kWh, units::Wh, VALUE(energy_returned_tariff1, 6)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 2, 8, 2), units::kWh, units::Wh, VALUE(energy_returned_tariff2, 7)),
+    SchemaField::string(ObisId(0, 0, 96, 14, 0), 4, 4, VALUE(electricity_tariff, 8)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 1, 7, 0), units::kW, units::W, VALUE(power_delivered, 9)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 2, 7, 0), units::kW, units::W, VALUE(power_returned, 10)),
+    SchemaField::integer(ObisId(0, 0, 96, 7, 21), units::none, VALUE(electricity_failures, 11)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 32, 7, 0), units::V, units::mV, VALUE(voltage_l1, 12)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 31, 7, 0), units::A, units::mA, VALUE(current_l1, 13)),
+    SchemaField::timestamped_fixed(ObisId(0, 1, 24, 2, 1), units::m3, units::dm3, VALUE(gas_delivered, 14), offsetof(ConfiguredValues, gas_timestamp)),
+};
+
+void parse_dsmr5_full_telegram_parsed_data(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state) {
+    ConfiguredFields data;
+    bench::do_not_optimize(DsmrParser::parse(data, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+  }
+}
+
+void parse_dsmr5_full_telegram_schema(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  std::array<uint16_t, SchemaParser::slot_count(schema.size())> slots;
+  std::array<SchemaParser::Units, schema.size()> units;
+  SchemaParser parser(slots, units);
+  parser.compile(schema, sizeof(ConfiguredValues));
+  for (auto _ : state) {
+    ConfiguredValues values{};
+    bench::do_not_optimize(parser.parse(&values, DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+  }
+}
+
+}
+
+BENCHMARK(parse_dsmr5_full_telegram_parsed_data);
+BENCHMARK(parse_dsmr5_full_telegram_schema);
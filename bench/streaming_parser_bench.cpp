@@ -0,0 +1,50 @@
+#include "bench.h"
+#include "dsmr_parser/packet_accumulator.h"
+#include "dsmr_parser/streaming_parser.h"
+#include "field_sets.h"
+#include "telegrams.h"
+#include <array>
+
+using namespace dsmr_parser;
+
+namespace {
+
+template <typename Data>
+struct StreamingParserFor;
+
+template <typename... Ts>
+struct StreamingParserFor<ParsedData<Ts...>> {
+  using type = StreamingParser<Ts...>;
+};
+
+void accumulate_and_parse_dsmr5_full_telegram(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  std::array<uint8_t, 2048> buffer;
+  PacketAccumulator accumulator(buffer, false);
+  bench::FieldsAll data;
+  for (auto _ : state) {
+    for (const char byte : bench::telegrams::dsmr5_full) {
+      if (const auto telegram = accumulator.process_byte(static_cast<uint8_t>(byte))) {
+        data = {};
+        bench::do_not_optimize(DsmrParser::parse(data, *telegram));
+      }
+    }
+  }
+}
+
+void stream_dsmr5_full_telegram(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  std::array<uint8_t, 2048> buffer;
+  StreamingParserFor<bench::FieldsAll>::type parser(buffer, false);
+  for (auto _ : state) {
+    for (const char byte : bench::telegrams::dsmr5_full)
+      bench::do_not_optimize(parser.process_byte(static_cast<uint8_t>(byte)).has_value());
+  }
+}
+
+}
+
+BENCHMARK(accumulate_and_parse_dsmr5_full_telegram);
+BENCHMARK(stream_dsmr5_full_telegram);
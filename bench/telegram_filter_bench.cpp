@@ -0,0 +1,24 @@
+#include "bench.h"
+#include "dsmr_parser/telegram_filter.h"
+#include "telegrams.h"
+#include <array>
+
+using namespace dsmr_parser;
+
+namespace {
+
+// Keeps the energy, power and gas readings, like a gateway that forwards them over a cellular link
+void filter_dsmr5_full_telegram(bench::State& state) {
+  static constexpr std::array<ObisId, 6> keep = {ObisId(1, 0, 1, 8, 1), ObisId(1, 0, 1, 8, 2), ObisId(1, 0, 2, 8, 1),
+                                                 ObisId(1, 0, 2, 8, 2), ObisId(1, 0, 1, 7, 0), ObisId(0, 1, 24, 2, 1)};
+  const TelegramFilter filter(keep);
+  std::array<char, 2048> out;
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  for (auto _ : state)
+    bench::do_not_optimize(filter.filter(DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full), out));
+}
+
+}
+
+BENCHMARK(filter_dsmr5_full_telegram);
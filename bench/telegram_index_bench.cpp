@@ -0,0 +1,62 @@
+#include "bench.h"
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/telegram_index.h"
+#include "telegrams.h"
+#include <array>
+
+using namespace dsmr_parser;
+using namespace dsmr_parser::fields;
+
+namespace {
+
+void index_dsmr5_full_telegram(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  std::array<TelegramLine, 128> buffer;
+  TelegramIndex index(buffer);
+  for (auto _ : state)
+    bench::do_not_optimize(index.build(DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+}
+
+// The typical consumer, that reads a few fields of every telegram
+void index_dsmr5_full_telegram_and_get_4_fields(bench::State& state) {
+  state.set_bytes_per_iteration(bench::telegrams::dsmr5_full.size());
+  state.set_items_per_iteration(1);
+  std::array<TelegramLine, 128> buffer;
+  TelegramIndex index(buffer);
+  for (auto _ : state) {
+    bench::do_not_optimize(index.build(DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full)));
+    LazyParsedData<energy_delivered_tariff1, energy_delivered_tariff2, power_delivered, gas_delivered> data(index);
+    bench::do_not_optimize(data.get<energy_delivered_tariff1>());
+    bench::do_not_optimize(data.get<energy_delivered_tariff2>());
+    bench::do_not_optimize(data.get<power_delivered>());
+    bench::do_not_optimize(data.get<gas_delivered>());
+  }
+}
+
+// The lookups alone, on an index that is built once
+template <typename... Ts>
+void get_fields(bench::State& state) {
+  state.set_items_per_iteration(1);
+  std::array<TelegramLine, 128> buffer;
+  TelegramIndex index(buffer);
+  index.build(DsmrUnencryptedTelegram(bench::telegrams::dsmr5_full));
+  for (auto _ : state) {
+    LazyParsedData<Ts...> data(index);
+    (bench::do_not_optimize(data.template get<Ts>()), ...);
+  }
+}
+
+void index_get_4_fields(bench::State& state) { get_fields<energy_delivered_tariff1, energy_delivered_tariff2, power_delivered, gas_delivered>(state); }
+
+void index_get_12_fields(bench::State& state) {
+  get_fields<identification, timestamp, energy_delivered_tariff1, energy_delivered_tariff2, energy_returned_tariff1, energy_returned_tariff2,
+             electricity_tariff, power_delivered, power_returned, voltage_l1, current_l1, gas_delivered>(state);
+}
+
+}
+
+BENCHMARK(index_dsmr5_full_telegram);
+BENCHMARK(index_dsmr5_full_telegram_and_get_4_fields);
+BENCHMARK(index_get_4_fields);
+BENCHMARK(index_get_12_fields);
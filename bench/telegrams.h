@@ -0,0 +1,224 @@
+#pragma once
+
+#include <string_view>
+
+namespace bench::telegrams {
+
+// DSMR 5 telegram with most of the fields from fields.h. Same as in parser_test.cpp.
+inline constexpr std::string_view dsmr5_full = "/KFM5KAIFA-METER\r\n"
+                                               "\r\n"
+                                               "1-3:0.2.8(40)\r\n"
+                                               "0-0:1.0.0(150117185916W)\r\n"
+                                               "0-0:96.1.1(0000000000000000000000000000000000)\r\n"
+                                               "1-0:1.8.1(000671.578*kWh)\r\n"
+                                               "1-0:1.8.2(000842.472*kWh)\r\n"
+                                               "1-0:2.8.1(000000.000*kWh)\r\n"
+                                               "1-0:2.8.2(000000.000*kWh)\r\n"
+                                               "1-0:1.8.11(007132.419*kWh)\r\n"
+                                               "1-0:1.8.12(000155.482*kWh)\r\n"
+                                               "1-0:1.8.13(025605.254*kWh)\r\n"
+                                               "1-0:2.8.11(000000.000*kWh)\r\n"
+                                               "1-0:2.8.12(000000.000*kWh)\r\n"
+                                               "1-0:2.8.13(000000.000*kWh)\r\n"
+                                               "0-0:96.14.0(0001)\r\n"
+                                               "0-0:96.14.1(03)\r\n"
+                                               "1-0:1.7.0(00.333*kW)\r\n"
+                                               "1-0:2.7.0(00.000*kW)\r\n"
+                                               "0-0:17.0.0(999.9*kW)\r\n"
+                                               "0-0:96.3.10(1)\r\n"
+                                               "0-0:96.7.21(00008)\r\n"
+                                               "0-0:96.7.9(00007)\r\n"
+                                               "1-0:99.97.0(1)(0-0:96.7.19)(000101000001W)(2147483647*s)\r\n"
+                                               "0-0:98.1.0(2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230202000000W)(230214224500W)(04529*W)\r\n"
+                                               "1-0:99.1.0(1)(0-0:96.10.7)(1-0:1.29.0)(1-0:2.29.0)(260411233000S)(00)(000000.205*kWh)(000000.000*kWh)\r\n"
+                                               "1-0:32.32.0(00000)\r\n"
+                                               "1-0:32.36.0(00000)\r\n"
+                                               "0-0:96.13.1()\r\n"
+                                               "0-0:96.13.0()\r\n"
+                                               "1-0:32.7.0(234.0*V)\r\n"
+                                               "1-0:52.7.0(231.0*V)\r\n"
+                                               "1-0:72.7.0(231.0*V)\r\n"
+                                               "1-0:31.7.0(001*A)\r\n"
+                                               "1-0:51.7.0(002.4*A)\r\n"
+                                               "1-0:71.7.0(000.0*A)\r\n"
+                                               "1-0:21.7.0(00.332*kW)\r\n"
+                                               "1-0:22.7.0(00.000*kW)\r\n"
+                                               "1-0:41.7.0(00.430*kW)\r\n"
+                                               "1-0:42.7.0(00.000*kW)\r\n"
+                                               "1-0:61.7.0(00.000*kW)\r\n"
+                                               "1-0:62.7.0(00.000*kW)\r\n"
+                                               "0-1:24.1.0(003)\r\n"
+                                               "0-1:96.1.0(0000000000000000000000000000000000)\r\n"
+                                               "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                                               "1-0:0.2.0((ER11))\r\n"
+                                               "1-0:0.2.8(1.0.smth smth-123)\r\n"
+                                               "1-1:0.2.0((ER12)\r\n"
+                                               "1-1:0.2.8(ER13))\r\n"
+                                               "0-1:24.4.0(1)\r\n"
+                                               "1-0:16.24.0(-03.618*kW)\r\n"
+                                               "1-0:13.7.0(0.998)\r\n"
+                                               "1-0:33.7.0(0.975)\r\n"
+                                               "1-0:53.7.0(0.963)\r\n"
+                                               "1-0:73.7.0(0.987)\r\n"
+                                               "1-0:13.3.0(0.000)\r\n"
+                                               "1-0:0.8.2(00900*s)\r\n"
+                                               "!";
+
+// DSMR 4.2 meter with a gas meter on M-Bus channel 1 (Landis+Gyr E350)
+inline constexpr std::string_view dsmr4 = "/XMX5LGBBFFB231215493\r\n"
+                                          "\r\n"
+                                          "1-3:0.2.8(42)\r\n"
+                                          "0-0:1.0.0(170124213128W)\r\n"
+                                          "0-0:96.1.1(4530303034303031363333353933363133)\r\n"
+                                          "1-0:1.8.1(000046.010*kWh)\r\n"
+                                          "1-0:1.8.2(000027.548*kWh)\r\n"
+                                          "1-0:2.8.1(000000.000*kWh)\r\n"
+                                          "1-0:2.8.2(000000.000*kWh)\r\n"
+                                          "0-0:96.14.0(0002)\r\n"
+                                          "1-0:1.7.0(00.034*kW)\r\n"
+                                          "1-0:2.7.0(00.000*kW)\r\n"
+                                          "0-0:96.7.21(00009)\r\n"
+                                          "0-0:96.7.9(00007)\r\n"
+                                          "1-0:99.97.0(1)(0-0:96.7.19)(000101000006W)(2147483647*s)\r\n"
+                                          "1-0:32.32.0(00000)\r\n"
+                                          "1-0:32.36.0(00000)\r\n"
+                                          "0-0:96.13.1()\r\n"
+                                          "0-0:96.13.0()\r\n"
+                                          "1-0:31.7.0(000*A)\r\n"
+                                          "1-0:21.7.0(00.034*kW)\r\n"
+                                          "1-0:22.7.0(00.000*kW)\r\n"
+                                          "0-1:24.1.0(003)\r\n"
+                                          "0-1:96.1.0(4730303139333430323231313938343135)\r\n"
+                                          "0-1:24.2.1(170124210000W)(00671.790*m3)\r\n"
+                                          "!";
+
+// Luxembourg Smarty meter (Sagemcom T210-D-r). Same as in tests/test_data/generate_encrypted_packet.py.
+inline constexpr std::string_view smarty = "/EST5\\253710000_A\r\n"
+                                           "\r\n"
+                                           "1-3:0.2.8(50)\r\n"
+                                           "0-0:1.0.0(221006155014S)\r\n"
+                                           "1-0:1.8.0(006545766*Wh)\r\n"
+                                           "1-0:1.8.1(005017120*Wh)\r\n"
+                                           "1-0:1.8.2(001528646*Wh)\r\n"
+                                           "1-0:1.7.0(000000286*W)\r\n"
+                                           "1-0:2.8.0(000000058*Wh)\r\n"
+                                           "1-0:2.8.1(000000000*Wh)\r\n"
+                                           "1-0:2.8.2(000000058*Wh)\r\n"
+                                           "1-0:2.7.0(000000000*W)\r\n"
+                                           "1-0:3.8.0(000000747*varh)\r\n"
+                                           "1-0:3.8.1(000000000*varh)\r\n"
+                                           "1-0:3.8.2(000000747*varh)\r\n"
+                                           "1-0:3.7.0(000000000*var)\r\n"
+                                           "1-0:4.8.0(003897726*varh)\r\n"
+                                           "1-0:4.8.1(002692848*varh)\r\n"
+                                           "1-0:4.8.2(001204878*varh)\r\n"
+                                           "1-0:4.7.0(000000166*var)\r\n"
+                                           "!";
+
+// Belgian meter with the capacity tariff fields (Fluvius, e-MUCS 1.7)
+inline constexpr std::string_view belgian = "/FLU5\\253769484_A\r\n"
+                                            "\r\n"
+                                            "0-0:96.1.4(50217)\r\n"
+                                            "0-0:96.1.1(3153414733313031303231363035)\r\n"
+                                            "0-0:1.0.0(230316121548W)\r\n"
+                                            "1-0:1.8.1(000301.548*kWh)\r\n"
+                                            "1-0:1.8.2(000270.014*kWh)\r\n"
+                                            "1-0:2.8.1(000000.005*kWh)\r\n"
+                                            "1-0:2.8.2(000000.000*kWh)\r\n"
+                                            "0-0:96.14.0(0001)\r\n"
+                                            "1-0:1.4.0(02.351*kW)\r\n"
+                                            "1-0:1.6.0(230301000000W)(03.695*kW)\r\n"
+                                            "0-0:98.1.0(3)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230101000000W)(221206183000W)(06.858*kW)"
+                                            "(230301000000W)(230205131500W)(03.955*kW)\r\n"
+                                            "1-0:1.7.0(00.000*kW)\r\n"
+                                            "1-0:2.7.0(00.000*kW)\r\n"
+                                            "1-0:21.7.0(00.000*kW)\r\n"
+                                            "1-0:41.7.0(00.000*kW)\r\n"
+                                            "1-0:61.7.0(00.000*kW)\r\n"
+                                            "1-0:22.7.0(00.000*kW)\r\n"
+                                            "1-0:42.7.0(00.000*kW)\r\n"
+                                            "1-0:62.7.0(00.000*kW)\r\n"
+                                            "1-0:32.7.0(234.7*V)\r\n"
+                                            "1-0:52.7.0(234.7*V)\r\n"
+                                            "1-0:72.7.0(235.5*V)\r\n"
+                                            "1-0:31.7.0(000.00*A)\r\n"
+                                            "1-0:51.7.0(000.00*A)\r\n"
+                                            "1-0:71.7.0(000.00*A)\r\n"
+                                            "0-0:96.3.10(1)\r\n"
+                                            "0-0:17.0.0(999.9*kW)\r\n"
+                                            "1-0:31.4.0(999*A)\r\n"
+                                            "0-0:96.13.0()\r\n"
+                                            "0-1:24.1.0(003)\r\n"
+                                            "0-1:96.1.1(37464C4F32313139303333373333)\r\n"
+                                            "0-1:24.4.0(1)\r\n"
+                                            "0-1:24.2.3(230316121004W)(00101.000*m3)\r\n"
+                                            "!";
+
+// Swiss meter (Landis+Gyr E450) with the 1-1:x.8.y energy registers
+inline constexpr std::string_view swiss = "/LGZ4ZMF100AC.M23\r\n"
+                                          "\r\n"
+                                          "1-3:0.2.8(50)\r\n"
+                                          "0-0:1.0.0(231107171528W)\r\n"
+                                          "0-0:96.1.1(4C475A30393731393234373033393635)\r\n"
+                                          "1-1:1.8.1(001836.532*kWh)\r\n"
+                                          "1-1:1.8.2(002341.069*kWh)\r\n"
+                                          "1-1:2.8.1(000512.318*kWh)\r\n"
+                                          "1-1:2.8.2(000187.102*kWh)\r\n"
+                                          "0-0:96.14.0(0002)\r\n"
+                                          "1-1:1.7.0(00.412*kW)\r\n"
+                                          "1-1:2.7.0(00.000*kW)\r\n"
+                                          "1-0:32.7.0(231.4*V)\r\n"
+                                          "1-0:52.7.0(232.1*V)\r\n"
+                                          "1-0:72.7.0(230.8*V)\r\n"
+                                          "1-0:31.7.0(001*A)\r\n"
+                                          "1-0:51.7.0(000*A)\r\n"
+                                          "1-0:71.7.0(000*A)\r\n"
+                                          "!";
+
+// Israeli meter with 3 tariffs (1-0:x.8.1y) and the long power failure log in 1-0:99.1.0
+inline constexpr std::string_view israeli = "/ISK5\\2M550E-1012\r\n"
+                                            "\r\n"
+                                            "1-3:0.2.8(50)\r\n"
+                                            "0-0:1.0.0(240212104523W)\r\n"
+                                            "0-0:96.1.1(4530303434303037313331363238393232)\r\n"
+                                            "1-0:1.8.11(007132.419*kWh)\r\n"
+                                            "1-0:1.8.12(000155.482*kWh)\r\n"
+                                            "1-0:1.8.13(025605.254*kWh)\r\n"
+                                            "1-0:2.8.11(000000.000*kWh)\r\n"
+                                            "1-0:2.8.12(000000.000*kWh)\r\n"
+                                            "1-0:2.8.13(000000.000*kWh)\r\n"
+                                            "0-0:96.14.1(03)\r\n"
+                                            "1-0:1.7.0(01.193*kW)\r\n"
+                                            "1-0:2.7.0(00.000*kW)\r\n"
+                                            "1-0:99.1.0(1)(0-0:96.10.7)(1-0:1.29.0)(1-0:2.29.0)(240212100000W)(00)(000000.205*kWh)(000000.000*kWh)\r\n"
+                                            "1-0:32.7.0(229.0*V)\r\n"
+                                            "1-0:31.7.0(005*A)\r\n"
+                                            "!";
+
+// Lithuanian meter (ESO) with totals and reactive energy registers
+inline constexpr std::string_view lithuanian = "/LIT5\\2MX382-1003\r\n"
+                                               "\r\n"
+                                               "0-0:1.0.0(240615093000S)\r\n"
+                                               "0-0:96.1.1(3735353130323138)\r\n"
+                                               "1-0:1.8.0(012345.678*kWh)\r\n"
+                                               "1-0:1.8.1(008765.432*kWh)\r\n"
+                                               "1-0:1.8.2(003580.246*kWh)\r\n"
+                                               "1-0:2.8.0(000123.456*kWh)\r\n"
+                                               "1-0:2.8.1(000100.000*kWh)\r\n"
+                                               "1-0:2.8.2(000023.456*kWh)\r\n"
+                                               "1-0:3.8.0(000456.789*kvarh)\r\n"
+                                               "1-0:4.8.0(001234.567*kvarh)\r\n"
+                                               "0-0:96.14.0(0001)\r\n"
+                                               "1-0:1.7.0(00.872*kW)\r\n"
+                                               "1-0:2.7.0(00.000*kW)\r\n"
+                                               "1-0:3.7.0(00.120*kvar)\r\n"
+                                               "1-0:4.7.0(00.000*kvar)\r\n"
+                                               "1-0:32.7.0(232.3*V)\r\n"
+                                               "1-0:52.7.0(231.9*V)\r\n"
+                                               "1-0:72.7.0(233.0*V)\r\n"
+                                               "1-0:31.7.0(001.21*A)\r\n"
+                                               "1-0:51.7.0(001.34*A)\r\n"
+                                               "1-0:71.7.0(001.05*A)\r\n"
+                                               "!";
+
+}
@@ -0,0 +1,57 @@
+#include "bench.h"
+#include "dsmr_parser/timestamp.h"
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+using namespace dsmr_parser;
+
+namespace {
+
+// The timestamps of one day of 15 minute values, like the column of an archive
+struct Day {
+  std::array<std::string, 96> storage;
+  std::array<std::string_view, 96> texts;
+
+  Day() {
+    for (size_t i = 0; i < storage.size(); ++i) {
+      const auto minutes = i * 15;
+      storage[i] = "240117" + std::to_string(minutes / 600) + std::to_string(minutes / 60 % 10) + std::to_string(minutes % 60 / 10) +
+                   std::to_string(minutes % 10) + "00W";
+      texts[i] = storage[i];
+    }
+  }
+};
+
+void decode_timestamps_column(bench::State& state) {
+  const Day day;
+  std::array<std::optional<Timestamp>, 96> out;
+  state.set_items_per_iteration(day.texts.size());
+  TimestampDecoder decoder;
+  for (auto _ : state) {
+    bench::do_not_optimize(decoder.decode(day.texts, out));
+    bench::do_not_optimize(out);
+  }
+}
+
+// The same, with the calendar computed for every timestamp
+void decode_timestamps_column_without_cache(bench::State& state) {
+  const Day day;
+  std::array<std::optional<Timestamp>, 96> out;
+  state.set_items_per_iteration(day.texts.size());
+  TimestampDecoder decoder;
+  for (auto _ : state) {
+    for (size_t i = 0; i < day.texts.size(); ++i) {
+      decoder.reset();
+      out[i] = decoder.decode(day.texts[i]);
+    }
+    bench::do_not_optimize(out);
+  }
+}
+
+}
+
+BENCHMARK(decode_timestamps_column);
+BENCHMARK(decode_timestamps_column_without_cache);
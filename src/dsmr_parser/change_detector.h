@@ -0,0 +1,214 @@
+#pragma once
+
+#include "fields.h"
+#include "parser.h"
+#include "util.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace dsmr_parser {
+
+// The last reported value of a field. changed() compares a new value with it and takes the new value if it changed.
+template <typename Value>
+struct ChangeState {
+  Value last{};
+
+  bool changed(const Value& value) {
+    if (value == last)
+      return false;
+    last = value;
+    return true;
+  }
+};
+
+// Strings point into the telegram, that is usually overwritten by the next one. Only their hash is kept.
+template <>
+struct ChangeState<std::string_view> {
+  uint64_t last = 0;
+
+  bool changed(std::string_view value) {
+    const auto hash = WordHash::calculate(value);
+    if (hash == last)
+      return false;
+    last = hash;
+    return true;
+  }
+};
+
+// Fixed point values can have a deadband, in thousandths like FixedValue::int_val().
+// Changes smaller than the deadband are ignored. They are compared with the last reported value, so slow drifts are still reported.
+template <>
+struct ChangeState<FixedValue> {
+  int32_t last = 0;
+  int32_t deadband = 0;
+
+  bool changed(const FixedValue& value) {
+    const auto difference = static_cast<int64_t>(value.int_val()) - last;
+    const auto magnitude = difference < 0 ? -difference : difference;
+    if (magnitude == 0 || magnitude < deadband)
+      return false;
+    last = value.int_val();
+    return true;
+  }
+
+  // Takes the value as the reference, even if it is within the deadband of the old one
+  void take(const FixedValue& value) { last = value.int_val(); }
+};
+
+// A new timestamp is a change, even if the value stays within the deadband
+template <>
+struct ChangeState<TimestampedFixedValue> : ChangeState<FixedValue> {
+  uint64_t last_timestamp = 0;
+
+  bool changed(const TimestampedFixedValue& value) {
+    const auto hash = WordHash::calculate(value.timestamp);
+    if (hash != last_timestamp) {
+      last_timestamp = hash;
+      last = value.int_val();
+      return true;
+    }
+    return ChangeState<FixedValue>::changed(value);
+  }
+
+  void take(const TimestampedFixedValue& value) {
+    last_timestamp = WordHash::calculate(value.timestamp);
+    ChangeState<FixedValue>::take(value);
+  }
+};
+
+// Profile generic buffers change when an entry is added, dropped or changed. Only a hash of the entries is kept.
+template <typename Value, size_t N>
+struct ChangeState<ProfileArray<Value, N>> {
+  uint64_t last = 0;
+
+  bool changed(const ProfileArray<Value, N>& value) {
+    uint64_t hash = WordHash::calculate({}, value.size() * 2 + value.overflow);
+    for (const auto& entry : value) {
+      int64_t number;
+      if constexpr (std::is_same_v<Value, FixedValue>)
+        number = entry.value.int_val();
+      else
+        number = static_cast<int64_t>(entry.value);
+      hash = WordHash::calculate(entry.timestamp, hash ^ static_cast<uint64_t>(number));
+    }
+    if (hash == last)
+      return false;
+    last = hash;
+    return true;
+  }
+};
+
+// M-Bus devices change when a line of any device changes. Only a hash of the devices is kept.
+template <>
+struct ChangeState<MbusDevices> {
+  uint64_t last = 0;
+
+  bool changed(const MbusDevices& value) {
+    uint64_t hash = 0;
+    for (const auto& device : value.devices) {
+      const uint64_t flags = uint64_t{device.type_present} | uint64_t{device.equipment_id_present} << 1 | uint64_t{device.valve_position_present} << 2 |
+                             uint64_t{device.delivered_present} << 3;
+      const uint64_t numbers =
+          uint64_t{device.type} << 48 | uint64_t{device.valve_position} << 40 | flags << 32 | static_cast<uint32_t>(device.delivered.int_val());
+      hash = WordHash::calculate(device.equipment_id, hash ^ numbers);
+      hash = WordHash::calculate(device.delivered.timestamp, hash);
+    }
+    if (hash == last)
+      return false;
+    last = hash;
+    return true;
+  }
+};
+
+template <typename F>
+struct FieldChangeState : ChangeState<std::remove_cvref_t<decltype(std::declval<F&>().val())>> {
+  bool present = false;
+};
+
+// Finds the fields of consecutive telegrams that changed, so publishing and serialization can skip the others.
+// update() compares every field of a ParsedData with the value that was last reported as changed and returns a bitmap of the changed fields.
+// A field that appears or disappears is a change. The first telegram reports all of its fields.
+// FixedValue fields can have a deadband, e.g. set_deadband<voltage_l1>(500) ignores changes under 0.5 V.
+// Keeps 8 to 16 bytes per field and no pointers into the telegrams.
+template <typename... Ts>
+class ChangeDetector final : FieldChangeState<Ts>... {
+  static constexpr size_t kWords = (sizeof...(Ts) + 63) / 64;
+
+public:
+  using Data = ParsedData<Ts...>;
+  // Bit i % 64 of word i / 64 is set if the i-th field changed
+  using Mask = std::array<uint64_t, kWords>;
+
+private:
+  Mask _changed{};
+
+  template <typename F>
+  static constexpr size_t field_index() {
+    constexpr bool matches[] = {std::is_same_v<F, Ts>...};
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+      if (matches[i])
+        return i;
+    }
+    return sizeof...(Ts);
+  }
+
+  template <typename F>
+  void update_field(Data& data) {
+    auto& state = static_cast<FieldChangeState<F>&>(*this);
+    auto& field = static_cast<F&>(data);
+    bool changed = state.present != field.present();
+    if (field.present()) {
+      // A field that appears has no reference yet. The states without a deadband take any new value in changed().
+      if constexpr (requires { state.take(field.val()); }) {
+        if (!state.present)
+          state.take(field.val());
+        else
+          changed = state.changed(field.val());
+      } else {
+        changed = state.changed(field.val()) || changed;
+      }
+    }
+    state.present = field.present();
+    if (changed) {
+      constexpr auto index = field_index<F>();
+      _changed[index / 64] |= uint64_t{1} << (index % 64);
+    }
+  }
+
+public:
+  // Ignores changes of the FixedValue field F smaller than `deadband`, in thousandths of its unit
+  template <typename F>
+  void set_deadband(int32_t deadband) {
+    static_assert(field_index<F>() < sizeof...(Ts), "The field is not a template argument of this ChangeDetector");
+    static_cast<FieldChangeState<F>&>(*this).deadband = deadband;
+  }
+
+  // Compares the fields of `data`, usually a telegram that was parsed without errors, with the last reported values.
+  // Returns the changed fields. Their values become the new reference.
+  const Mask& update(Data& data) {
+    _changed = {};
+    (update_field<Ts>(data), ...);
+    return _changed;
+  }
+
+  // Whether field F changed in the last update()
+  template <typename F>
+  bool changed() const {
+    constexpr auto index = field_index<F>();
+    static_assert(index < sizeof...(Ts), "The field is not a template argument of this ChangeDetector");
+    return (_changed[index / 64] >> (index % 64)) & 1;
+  }
+
+  const Mask& changes() const { return _changed; }
+
+  // Forgets the last reported values, so the next update() reports all present fields. The deadbands are kept.
+  void reset() {
+    _changed = {};
+    ((static_cast<FieldChangeState<Ts>&>(*this).present = false), ...);
+  }
+};
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "fields.h"
+#include "parser.h"
+#include "util.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace dsmr_parser {
+
+// One bit per row
+template <size_t N>
+class RowBitmap final {
+  std::array<uint64_t, (N + 63) / 64> _words{};
+
+public:
+  bool test(size_t row) const { return (_words[row / 64] >> (row % 64)) & 1; }
+
+  void set(size_t row, bool value) {
+    const auto bit = uint64_t{1} << (row % 64);
+    _words[row / 64] = value ? (_words[row / 64] | bit) : (_words[row / 64] & ~bit);
+  }
+
+  void reset() { _words = {}; }
+
+  // Bit i % 64 of word i / 64 is the bit of row i
+  std::span<const uint64_t> words() const { return _words; }
+};
+
+// The values of one field in consecutive rows. Values of absent fields are undefined.
+template <typename Value, size_t N>
+struct ColumnValues {
+  std::array<Value, N> values;
+
+  void store(size_t row, const Value& value) { values[row] = value; }
+};
+
+// Fixed point values are stored as integers, in thousandths like FixedValue::int_val()
+template <size_t N>
+struct ColumnValues<FixedValue, N> {
+  std::array<int32_t, N> values;
+
+  void store(size_t row, const FixedValue& value) { values[row] = value.int_val(); }
+};
+
+template <size_t N>
+struct ColumnValues<TimestampedFixedValue, N> {
+  std::array<int32_t, N> values;
+  std::array<std::string_view, N> timestamps;
+
+  void store(size_t row, const TimestampedFixedValue& value) {
+    values[row] = value.int_val();
+    timestamps[row] = value.timestamp;
+  }
+};
+
+template <typename F, size_t N>
+struct Column : ColumnValues<std::remove_cvref_t<decltype(std::declval<F&>().val())>, N> {
+  RowBitmap<N> present;
+};
+
+// The result of parsing many telegrams, stored column by column instead of one ParsedData per telegram.
+// Every field passed as a template argument gets its own column. Row i holds the values of the i-th telegram.
+// Filled by DsmrParser::parse_batch. String values point into the telegrams.
+template <size_t N, typename... Ts>
+class ColumnarData final : Column<Ts, N>... {
+  RowBitmap<N> _valid;
+  size_t _size = 0;
+
+public:
+  using Data = ParsedData<Ts...>;
+
+  static constexpr size_t capacity() { return N; }
+  size_t size() const { return _size; }
+
+  // Whether the telegram of the row was parsed without errors. Invalid rows have no fields present.
+  bool valid(size_t row) const { return _valid.test(row); }
+  const RowBitmap<N>& valid_rows() const { return _valid; }
+
+  template <typename F>
+  const Column<F, N>& column() const {
+    return static_cast<const Column<F, N>&>(*this);
+  }
+
+  void clear() {
+    _size = 0;
+    _valid.reset();
+    (Column<Ts, N>::present.reset(), ...);
+  }
+
+  // Appends the fields of `data` as a new row. Returns false if there is no space left.
+  bool append(Data& data, bool valid) {
+    if (_size == N)
+      return false;
+    _valid.set(_size, valid);
+    (append_field<Ts>(data, valid), ...);
+    ++_size;
+    return true;
+  }
+
+private:
+  template <typename F>
+  void append_field(Data& data, bool valid) {
+    auto& column = static_cast<Column<F, N>&>(*this);
+    auto& field = static_cast<F&>(data);
+    const bool is_present = valid && field.present();
+    column.present.set(_size, is_present);
+    if (is_present)
+      column.store(_size, field.val());
+  }
+};
+
+}
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "fields.h"
+#include "parse_error.h"
+#include "parser.h"
+#include "stats.h"
+#include "util.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace dsmr_parser {
+
+// A string value stored as its position in the telegram, in 4 bytes instead of the 16 of a std::string_view. Used by CompactParsedData.
+// The offset is counted from the '/' at the start of the telegram.
+struct CompactString final {
+  uint16_t offset = 0;
+  uint16_t length = 0;
+
+  std::string_view view(std::string_view telegram) const { return telegram.substr(offset, length); }
+  bool operator==(const CompactString&) const = default;
+};
+
+struct CompactTimestampedFixedValue : public FixedValue {
+  CompactString timestamp;
+};
+
+// How a value is stored in CompactParsedData. store() converts the value parsed from `telegram` and returns false if it doesn't fit,
+// load() converts it back.
+template <typename Value>
+struct CompactValue {
+  using type = Value;
+
+  static bool store(type& out, const Value& value, const char*) {
+    out = value;
+    return true;
+  }
+  static const Value& load(const type& value, const char*) { return value; }
+};
+
+template <>
+struct CompactValue<std::string_view> {
+  using type = CompactString;
+
+  static bool store(CompactString& out, std::string_view value, const char* telegram) {
+    const auto offset = value.empty() ? 0 : reinterpret_cast<uintptr_t>(value.data()) - reinterpret_cast<uintptr_t>(telegram);
+    if (offset > UINT16_MAX || value.size() > UINT16_MAX)
+      return false;
+    out = CompactString{static_cast<uint16_t>(offset), static_cast<uint16_t>(value.size())};
+    return true;
+  }
+  static std::string_view load(const CompactString& value, const char* telegram) { return std::string_view(telegram + value.offset, value.length); }
+};
+
+template <>
+struct CompactValue<TimestampedFixedValue> {
+  using type = CompactTimestampedFixedValue;
+
+  static bool store(CompactTimestampedFixedValue& out, const TimestampedFixedValue& value, const char* telegram) {
+    if (!CompactValue<std::string_view>::store(out.timestamp, value.timestamp, telegram))
+      return false;
+    out._value = value._value;
+    return true;
+  }
+  static TimestampedFixedValue load(const CompactTimestampedFixedValue& value, const char* telegram) {
+    TimestampedFixedValue out;
+    out._value = value._value;
+    out.timestamp = CompactValue<std::string_view>::load(value.timestamp, telegram);
+    return out;
+  }
+};
+
+// The compact storage of a field, a base class of CompactParsedData. DEFINE_COMPACT_FIELD gives it a member named after the field.
+template <typename F>
+struct CompactField {
+  using Value = std::remove_cvref_t<decltype(std::declval<F&>().val())>;
+  typename CompactValue<Value>::type value;
+  auto& val() { return value; }
+  const auto& val() const { return value; }
+};
+
+// Makes the value of field_t accessible by name in CompactParsedData, e.g. `data.power_delivered`, like in ParsedData.
+// Every field of fields.h has it, see the end of this file. Use it in the global namespace with the full name of field_t.
+#define DEFINE_COMPACT_FIELD(field_t, fieldname)                                 \
+  template <>                                                                    \
+  struct dsmr_parser::CompactField<field_t> {                                    \
+    using Value = std::remove_cvref_t<decltype(std::declval<field_t&>().val())>; \
+    dsmr_parser::CompactValue<Value>::type fieldname;                            \
+    auto& val() { return fieldname; }                                            \
+    const auto& val() const { return fieldname; }                                \
+  }
+
+// The result of parsing a DSMR telegram like ParsedData, with a smaller layout that can be reused without reconstructing it:
+// - the presence flags of all fields are packed into one bitset. all_present() is a mask compare and reset() clears a few words.
+// - string values are stored as CompactString, a 16 bit offset and length into the telegram. view() turns them into a std::string_view.
+// - the other values are stored like in ParsedData, without a bool next to each of them.
+// The values are accessed by name like in ParsedData, e.g. `data.power_delivered` or `data.view(data.equipment_id)`, or by field type,
+// e.g. `data.get<equipment_id>()`, that returns strings as std::string_view.
+// Values of absent fields are undefined. The telegram must outlive the object, like with ParsedData.
+template <typename... Ts>
+class CompactParsedData final : public CompactField<Ts>... {
+  static_assert(!(is_line_field<Ts> || ...), "Fields with a parse_line() method, e.g. mbus_devices, are only supported by ParsedData");
+
+  static constexpr size_t kWords = (sizeof...(Ts) + 63) / 64;
+  using Presence = std::array<uint64_t, kWords>;
+
+  static constexpr Presence kAllPresent = [] {
+    Presence mask{};
+    for (size_t i = 0; i < sizeof...(Ts); ++i)
+      mask[i / 64] |= uint64_t{1} << (i % 64);
+    return mask;
+  }();
+
+  Presence _present{};
+  const char* _telegram = nullptr;
+
+  template <typename F>
+  static constexpr size_t field_index() {
+    constexpr bool matches[] = {std::is_same_v<F, Ts>...};
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+      if (matches[i])
+        return i;
+    }
+    return sizeof...(Ts);
+  }
+
+  using Table = ObisDispatchTable<CompactParsedData, sizeof...(Ts)>;
+
+  // Parses into a temporary field, so every field type of ParsedData can be used, and stores its value in the compact form
+  template <typename F>
+  static std::optional<std::string_view> parse_field(CompactParsedData& data, const ValueGroups& input) {
+    constexpr auto index = field_index<F>();
+    auto& word = data._present[index / 64];
+    const auto bit = uint64_t{1} << (index % 64);
+    if (word & bit)
+      return input.failure().set(ParseError::DuplicateField, input.rest().data());
+    word |= bit;
+
+    F field;
+    const auto res = parse_field_value(field, input);
+    if (!res)
+      return res;
+    using Storage = CompactValue<typename CompactField<F>::Value>;
+    if (!Storage::store(static_cast<CompactField<F>&>(data).val(), field.val(), data._telegram))
+      return input.failure().set(ParseError::InvalidValue, input.rest().data());
+    return res;
+  }
+
+public:
+  // Parses `telegram`. Same as DsmrParser::parse() for a ParsedData with the same fields. Call reset() before parsing the next telegram.
+  ParseResult parse(DsmrUnencryptedTelegram telegram, bool unknown_error = false, ParserStats* stats = nullptr) {
+    _telegram = telegram.content().data();
+    return DsmrParser::parse_lines(*this, telegram, unknown_error, stats);
+  }
+
+  // Used by DsmrParser::parse_lines(). The strings are stored relative to the telegram passed to parse().
+  std::optional<std::string_view> parse_line(const ObisId& obis_id, const ValueGroups& input) {
+    static constexpr auto table = Table::create({typename Table::Entry{Ts::id.key(), &parse_field<Ts>}...});
+    const auto* entry = table.find(obis_id);
+    if (entry == nullptr)
+      return input.rest();
+    return entry->parse(*this, input);
+  }
+
+  // Marks all fields as absent. The values are left as they are.
+  void reset() { _present = {}; }
+
+  template <typename F>
+  bool present() const {
+    constexpr auto index = field_index<F>();
+    static_assert(index < sizeof...(Ts), "The field is not a template argument of this CompactParsedData");
+    return (_present[index / 64] >> (index % 64)) & 1;
+  }
+
+  bool all_present() const { return _present == kAllPresent; }
+
+  // The value of field F, in the type of ParsedData. Strings point into the telegram that was parsed last.
+  template <typename F>
+  decltype(auto) get() const {
+    static_assert(field_index<F>() < sizeof...(Ts), "The field is not a template argument of this CompactParsedData");
+    return CompactValue<typename CompactField<F>::Value>::load(static_cast<const CompactField<F>&>(*this).val(), _telegram);
+  }
+
+  // Bit i % 64 of word i / 64 is set if the i-th field is present
+  const Presence& presence() const { return _present; }
+
+  // The string in the telegram that was parsed last
+  std::string_view view(const CompactString& value) const { return std::string_view(_telegram + value.offset, value.length); }
+};
+
+}
+
+// The fields of fields.h, except the line fields that CompactParsedData doesn't support
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::identification, identification);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::p1_version, p1_version);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::p1_version_be, p1_version_be);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::timestamp, timestamp);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::equipment_id, equipment_id);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_lux, energy_delivered_lux);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_tariff1, energy_delivered_tariff1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_tariff2, energy_delivered_tariff2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_tariff3, energy_delivered_tariff3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_tariff4, energy_delivered_tariff4);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_lux, energy_returned_lux);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_tariff1, energy_returned_tariff1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_tariff2, energy_returned_tariff2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_tariff3, energy_returned_tariff3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_tariff4, energy_returned_tariff4);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::total_imported_energy, total_imported_energy);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_delivered_tariff1, reactive_energy_delivered_tariff1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_delivered_tariff2, reactive_energy_delivered_tariff2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_delivered_tariff3, reactive_energy_delivered_tariff3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_delivered_tariff4, reactive_energy_delivered_tariff4);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::total_exported_energy, total_exported_energy);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_returned_tariff1, reactive_energy_returned_tariff1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_returned_tariff2, reactive_energy_returned_tariff2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_returned_tariff3, reactive_energy_returned_tariff3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_returned_tariff4, reactive_energy_returned_tariff4);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_tariff1_ch, energy_delivered_tariff1_ch);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_tariff2_ch, energy_delivered_tariff2_ch);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_tariff1_ch, energy_returned_tariff1_ch);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_tariff2_ch, energy_returned_tariff2_ch);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_tariff1_il, energy_delivered_tariff1_il);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_tariff2_il, energy_delivered_tariff2_il);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_delivered_tariff3_il, energy_delivered_tariff3_il);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_tariff1_il, energy_returned_tariff1_il);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_tariff2_il, energy_returned_tariff2_il);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::energy_returned_tariff3_il, energy_returned_tariff3_il);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_tariff_il, electricity_tariff_il);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_failure_log_il, electricity_failure_log_il);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_tariff, electricity_tariff);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_delivered, power_delivered);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_returned, power_returned);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_power_delivered, reactive_power_delivered);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_power_returned, reactive_power_returned);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_delivered_ch, power_delivered_ch);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_returned_ch, power_returned_ch);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_threshold, electricity_threshold);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_switch_position, electricity_switch_position);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_failures, electricity_failures);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_long_failures, electricity_long_failures);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_failure_log, electricity_failure_log);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_failure_log_entries, electricity_failure_log_entries);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_sags_l1, electricity_sags_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_sag_time_l1, voltage_sag_time_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_sag_l1, voltage_sag_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_sags_l2, electricity_sags_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_sag_time_l2, voltage_sag_time_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_sag_l2, voltage_sag_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_sags_l3, electricity_sags_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_sag_time_l3, voltage_sag_time_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_sag_l3, voltage_sag_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_swells_l1, electricity_swells_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_swell_time_l1, voltage_swell_time_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_swell_l1, voltage_swell_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_swells_l2, electricity_swells_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_swell_time_l2, voltage_swell_time_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_swell_l2, voltage_swell_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::electricity_swells_l3, electricity_swells_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_swell_time_l3, voltage_swell_time_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_swell_l3, voltage_swell_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::message_short, message_short);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::message_long, message_long);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_l1, voltage_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_avg_l1, voltage_avg_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_l2, voltage_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_avg_l2, voltage_avg_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_l3, voltage_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage_avg_l3, voltage_avg_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::voltage, voltage);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::frequency, frequency);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::abs_power, abs_power);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::current_l1, current_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::current_fuse_l1, current_fuse_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::current_l2, current_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::current_fuse_l2, current_fuse_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::current_l3, current_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::current_fuse_l3, current_fuse_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_delivered_l1, power_delivered_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_delivered_l2, power_delivered_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_delivered_l3, power_delivered_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_returned_l1, power_returned_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_returned_l2, power_returned_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_returned_l3, power_returned_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::current, current);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::current_n, current_n);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::current_sum, current_sum);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_power_delivered_l1, reactive_power_delivered_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_power_delivered_l2, reactive_power_delivered_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_power_delivered_l3, reactive_power_delivered_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_power_returned_l1, reactive_power_returned_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_power_returned_l2, reactive_power_returned_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_power_returned_l3, reactive_power_returned_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_delivery_power, apparent_delivery_power);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_delivery_power_l1, apparent_delivery_power_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_delivery_power_l2, apparent_delivery_power_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_delivery_power_l3, apparent_delivery_power_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_return_power, apparent_return_power);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_return_power_l1, apparent_return_power_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_return_power_l2, apparent_return_power_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_return_power_l3, apparent_return_power_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_demand_power, active_demand_power);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_demand_net, active_demand_net);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_demand_abs, active_demand_abs);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::gas_device_type, gas_device_type);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::gas_equipment_id, gas_equipment_id);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::gas_equipment_id_be, gas_equipment_id_be);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::gas_valve_position, gas_valve_position);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::gas_delivered, gas_delivered);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::gas_delivered_gj, gas_delivered_gj);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::gas_delivered_be, gas_delivered_be);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::gas_delivered_text, gas_delivered_text);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::thermal_device_type, thermal_device_type);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::thermal_equipment_id, thermal_equipment_id);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::thermal_valve_position, thermal_valve_position);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::thermal_delivered, thermal_delivered);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::water_device_type, water_device_type);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::water_equipment_id, water_equipment_id);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::water_valve_position, water_valve_position);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::water_delivered, water_delivered);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::sub_device_type, sub_device_type);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::sub_equipment_id, sub_equipment_id);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::sub_valve_position, sub_valve_position);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::sub_delivered, sub_delivered);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_energy_import_current_average_demand, active_energy_import_current_average_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_energy_export_current_average_demand, active_energy_export_current_average_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_import_current_average_demand, reactive_energy_import_current_average_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_export_current_average_demand, reactive_energy_export_current_average_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_energy_import_current_average_demand, apparent_energy_import_current_average_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_energy_export_current_average_demand, apparent_energy_export_current_average_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_energy_import_last_completed_demand, active_energy_import_last_completed_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_energy_export_last_completed_demand, active_energy_export_last_completed_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_import_last_completed_demand, reactive_energy_import_last_completed_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::reactive_energy_export_last_completed_demand, reactive_energy_export_last_completed_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_energy_import_last_completed_demand, apparent_energy_import_last_completed_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::apparent_energy_export_last_completed_demand, apparent_energy_export_last_completed_demand);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_energy_import_maximum_demand_running_month, active_energy_import_maximum_demand_running_month);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_energy_import_maximum_demand_last_13_months, active_energy_import_maximum_demand_last_13_months);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::active_energy_import_maximum_demand_history, active_energy_import_maximum_demand_history);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::fw_core_version, fw_core_version);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::fw_core_checksum, fw_core_checksum);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::fw_module_version, fw_module_version);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::fw_module_checksum, fw_module_checksum);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_factor, power_factor);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_factor_l1, power_factor_l1);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_factor_l2, power_factor_l2);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::power_factor_l3, power_factor_l3);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::min_power_factor, min_power_factor);
+DEFINE_COMPACT_FIELD(dsmr_parser::fields::period_3_for_instantaneous_values, period_3_for_instantaneous_values);
@@ -1,6 +1,7 @@
 #pragma once
 #include "decryption/aes128gcm.h"
 #include "packet_accumulator.h"
+#include "stats.h"
 #include "util.h"
 #include <array>
 #include <optional>
@@ -34,26 +35,26 @@ class DlmsPacketDecryptor final : NonCopyableAndNonMovable {
   public:
     static DlmsPacket* from_bytes(const std::span<uint8_t> bytes) {
       if (bytes.size() < sizeof(header) + /* tag length */ 12) {
-        Logger::log(LogLevel::DEBUG, "DLMS packet is too short. Size: %zu", bytes.size());
+        DSMR_PARSER_LOG(LogLevel::DEBUG, "DLMS packet is too short. Size: %zu", bytes.size());
         return nullptr;
       }
 
       auto& packet = *reinterpret_cast<DlmsPacket*>(bytes.data());
       const auto expected_length = sizeof(header) + /* tag length */ 12 + packet.telegram_length();
       if (expected_length != bytes.size()) {
-        Logger::log(LogLevel::DEBUG, "DLMS packet length mismatch. Expected: %zu, actual: %zu", expected_length, bytes.size());
+        DSMR_PARSER_LOG(LogLevel::DEBUG, "DLMS packet length mismatch. Expected: %zu, actual: %zu", expected_length, bytes.size());
         return nullptr;
       }
 
       if (packet.telegram_length() < 10) {
-        Logger::log(LogLevel::DEBUG, "DLMS encrypted telegram is too short. Size: %zu", packet.telegram_length());
+        DSMR_PARSER_LOG(LogLevel::DEBUG, "DLMS encrypted telegram is too short. Size: %zu", packet.telegram_length());
         return nullptr;
       }
 
       const auto header_bytes_consistent = packet.header.tag == 0xDB && packet.header.system_title_length == 0x08 &&
                                            packet.header.long_form_length_indicator == 0x82 && packet.header.security_control_field == 0x30;
       if (!header_bytes_consistent) {
-        Logger::log(LogLevel::DEBUG, "DLMS packet header is corrupted");
+        DSMR_PARSER_LOG(LogLevel::DEBUG, "DLMS packet header is corrupted");
         return nullptr;
       }
 
@@ -84,8 +85,11 @@ class DlmsPacketDecryptor final : NonCopyableAndNonMovable {
   static_assert(sizeof(DlmsPacket) == 19, "EncryptedPacket struct must be 19 bytes");
 
   Aes128GcmDecryptor& decryptor;
+  DSMR_PARSER_NO_UNIQUE_ADDRESS StatsHandle _stats;
 
   static void log_span_as_hex(const LogLevel level, const std::span<const uint8_t> data) {
+    if (!Logger::enabled(level))
+      return;
     constexpr size_t kCharsPerChunk = 200;
     constexpr size_t kBytesPerChunk = kCharsPerChunk / 2;
     for (size_t i = 0; i < data.size(); i += kBytesPerChunk) {
@@ -104,13 +108,32 @@ class DlmsPacketDecryptor final : NonCopyableAndNonMovable {
 public:
   explicit DlmsPacketDecryptor(Aes128GcmDecryptor& dec) : decryptor(dec) {}
 
+  // Counts the packets and errors in `stats` if DSMR_PARSER_STATS is enabled. nullptr to stop counting.
+  void set_stats(ParserStats* stats) { _stats = stats; }
+
+  // Returns the size of the DLMS packet that starts with `bytes`, or std::nullopt if `bytes` don't start with a valid DLMS header.
+  // Allows to split a stream of packets without the inter-frame delay, e.g. a capture file. Only the header is checked, not the content.
+  static std::optional<size_t> packet_size(const std::span<const uint8_t> bytes) {
+    constexpr size_t kHeaderSize = sizeof(DlmsPacket) - 1;
+    if (bytes.size() < kHeaderSize || bytes[0] != 0xDB || bytes[1] != 0x08 || bytes[10] != 0x82 || bytes[13] != 0x30)
+      return std::nullopt;
+
+    // See DlmsPacket for the meaning of the numbers
+    const auto total_length = static_cast<size_t>((bytes[11] << 8) | bytes[12]);
+    if (total_length < 5 + 12 + 10)
+      return std::nullopt;
+    return kHeaderSize + total_length - 5;
+  }
+
   std::optional<DsmrUnencryptedTelegram> decrypt_inplace(std::span<uint8_t> dlms_packet_bytes) {
-    Logger::log(LogLevel::VERY_VERBOSE, "Decrypt DLMS packet:");
+    DSMR_PARSER_LOG(LogLevel::VERY_VERBOSE, "Decrypt DLMS packet:");
     log_span_as_hex(LogLevel::VERY_VERBOSE, dlms_packet_bytes);
-    Logger::log(LogLevel::VERY_VERBOSE, "=========");
+    DSMR_PARSER_LOG(LogLevel::VERY_VERBOSE, "=========");
+    _stats.count(&ParserStats::dlms_packets);
 
     auto dlms_packet = DlmsPacket::from_bytes(dlms_packet_bytes);
     if (dlms_packet == nullptr) {
+      _stats.count(&ParserStats::invalid_dlms_packets);
       return std::nullopt;
     }
 
@@ -120,24 +143,27 @@ public:
     constexpr std::array<uint8_t, 17> aad{0x30, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
     const bool res = decryptor.decrypt_inplace(aad, dlms_packet->nonce(), dlms_packet->encrypted_telegram(), dlms_packet->gcm_tag());
     if (!res) {
-      Logger::log(LogLevel::DEBUG, "Decryption of DLMS packet failed");
+      DSMR_PARSER_LOG(LogLevel::DEBUG, "Decryption of DLMS packet failed");
+      _stats.count(&ParserStats::decryption_errors);
       return std::nullopt;
     }
 
     // The unencrypted DSMR telegram looks like "/data!abcd\r\n". We skip everything after the "!" sign. The encryption already handles integrity check.
     const auto telegram = std::string_view{reinterpret_cast<const char*>(dlms_packet->encrypted_telegram().data()), dlms_packet->encrypted_telegram().size()};
     if (telegram.front() != '/') {
-      Logger::log(LogLevel::DEBUG, "Unencrypted DSMR telegram should start with '/' character");
+      DSMR_PARSER_LOG(LogLevel::DEBUG, "Unencrypted DSMR telegram should start with '/' character");
+      _stats.count(&ParserStats::invalid_dlms_packets);
       return std::nullopt;
     }
     const auto bangPos = std::ranges::find(telegram, '!');
     if (bangPos == telegram.end()) {
-      Logger::log(LogLevel::DEBUG, "Unencrypted DSMR telegram should contain '!' character");
+      DSMR_PARSER_LOG(LogLevel::DEBUG, "Unencrypted DSMR telegram should contain '!' character");
+      _stats.count(&ParserStats::invalid_dlms_packets);
       return std::nullopt;
     }
     const auto dsmrUnencryptedTelegram = std::string_view{telegram.begin(), bangPos + 1};
 
-    Logger::log(LogLevel::VERBOSE, "DLMS packet decryption succeeded");
+    DSMR_PARSER_LOG(LogLevel::VERBOSE, "DLMS packet decryption succeeded");
 
     return DsmrUnencryptedTelegram(dsmrUnencryptedTelegram);
   }
@@ -2,8 +2,12 @@
 
 #include "parser.h"
 #include "util.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string_view>
+#include <type_traits>
 
 #ifndef DSMR_GAS_MBUS_ID
 #define DSMR_GAS_MBUS_ID 1
@@ -20,6 +24,129 @@
 
 namespace dsmr_parser {
 
+// The parse kernels of the field templates below and of SchemaParser. They take the units and the lengths as arguments
+// and are never inlined, so each of them is compiled once, however many fields use it. A field only passes its metadata
+// and the location of its value. On failure the value is not modified and the reason is recorded in the ParseFailure of the line.
+// Values of several groups are taken from ValueGroups, that carries the ParseFailure.
+
+DSMR_PARSER_NOINLINE inline std::optional<std::string_view> parse_string_value(std::string_view& out, size_t min, size_t max, ValueGroups input) {
+  return input.string(out, min, max);
+}
+
+// Some smart meters publish int values instead of a float.
+// E.g. most meters would publish "1-0:1.8.0(000441.879*kWh)", but some use "1-0:1.8.0(000441879*Wh)" instead.
+DSMR_PARSER_NOINLINE inline std::optional<std::string_view> parse_fixed_value(int32_t& out, const PackedUnit& unit, const PackedUnit& int_unit,
+                                                                             std::string_view input, ParseFailure& failure) {
+  return parse_float_or_int(out, 3, unit, int_unit, input, failure);
+}
+
+// A timestamp followed by a fixed value, e.g. (150117180000W)(00473.789*m3)
+DSMR_PARSER_NOINLINE inline std::optional<std::string_view> parse_timestamped_fixed_value(std::string_view& timestamp, int32_t& out, const PackedUnit& unit,
+                                                                                         const PackedUnit& int_unit, ValueGroups input) {
+  std::string_view ts;
+  auto res = input.string(ts, 13, 13);
+  if (!res)
+    return std::nullopt;
+  res = parse_float_or_int(out, 3, unit, int_unit, *res, input.failure());
+  if (res)
+    timestamp = ts;
+  return res;
+}
+
+DSMR_PARSER_NOINLINE inline std::optional<std::string_view> parse_int_value(int32_t& out, const PackedUnit& unit, std::string_view input,
+                                                                           ParseFailure& failure) {
+  return parse_num(out, 0, unit, input, failure);
+}
+
+// Returns the last of multiple parenthesized values, e.g. "(04.329*kW)" for "(1)(1-0:1.6.0)(04.329*kW)"
+DSMR_PARSER_NOINLINE inline std::optional<std::string_view> find_last_value(ValueGroups input) {
+  std::string_view last = input.rest();
+  while (!input.rest().empty()) {
+    last = input.rest();
+    std::string_view sv;
+    if (!input.string(sv, 1, 20))
+      return std::nullopt;
+  }
+  return last;
+}
+
+// Parses the average of multiple timestamped values. Example:
+//   (2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230202000000W)(230214224500W)(04.529*kW)
+// Will produce an average between 4.329 and 4.529
+DSMR_PARSER_NOINLINE inline std::optional<std::string_view> parse_average(int32_t& out, const PackedUnit& unit, const PackedUnit& int_unit,
+                                                                         ValueGroups input) {
+  int32_t count;
+  auto res = parse_num(count, 0, PackedUnit(""), input.rest(), input.failure());
+  if (!res)
+    return std::nullopt;
+  input.skip_to(*res);
+
+  if (count == 0) {
+    out = 0;
+    return std::string_view{};
+  }
+
+  std::string_view sv;
+  if (!input.string(sv, 1, 20) || !input.string(sv, 1, 20))
+    return std::nullopt;
+
+  int32_t total = 0;
+  for (int32_t i = 0; i < count; i++) {
+    if (!input.string(sv, 1, 20) || !input.string(sv, 1, 20))
+      return std::nullopt;
+    int32_t val;
+    res = parse_float_or_int(val, 3, unit, int_unit, input.rest(), input.failure());
+    if (!res)
+      return std::nullopt;
+    input.skip_to(*res);
+    total += val;
+  }
+
+  out = total / count;
+  return res;
+}
+
+// The header of a profile generic buffer: the number of entries and `ids` OBIS ids, e.g. (2)(1-0:1.6.0)(1-0:1.6.0)
+// Returns the entries. For 0 entries the rest of the value is skipped, like in parse_average().
+DSMR_PARSER_NOINLINE inline std::optional<std::string_view> parse_profile_header(size_t& count, size_t ids, ValueGroups& input) {
+  int32_t value;
+  const auto res = parse_num(value, 0, PackedUnit(""), input.rest(), input.failure());
+  if (!res)
+    return std::nullopt;
+  if (value < 0)
+    return input.failure().set(ParseError::InvalidNumber, input.rest().data() + 1);
+  count = static_cast<size_t>(value);
+  if (count == 0) {
+    input = ValueGroups(std::string_view{}, input.failure());
+    return input.rest();
+  }
+  input.skip_to(*res);
+
+  std::string_view sv;
+  for (size_t i = 0; i < ids; ++i) {
+    if (!input.string(sv, 1, 20))
+      return std::nullopt;
+  }
+  return input.rest();
+}
+
+// One entry of a profile generic buffer: `timestamps` timestamps and a value, e.g. (230201000000W)(230117224500W)(04.329*kW)
+// `timestamp` is the last timestamp. The value has `decimals` decimals, or is in `int_unit` without decimals.
+DSMR_PARSER_NOINLINE inline std::optional<std::string_view> parse_profile_entry(std::string_view& timestamp, int32_t& out, size_t timestamps, size_t decimals,
+                                                                               const PackedUnit& unit, const PackedUnit& int_unit, ValueGroups& input) {
+  std::string_view ts;
+  for (size_t i = 0; i < timestamps; ++i) {
+    if (!input.string(ts, 13, 13))
+      return std::nullopt;
+  }
+  const auto res = parse_float_or_int(out, decimals, unit, int_unit, input.rest(), input.failure());
+  if (!res)
+    return std::nullopt;
+  input.skip_to(*res);
+  timestamp = ts;
+  return res;
+}
+
 template <typename T>
 struct ParsedField {
   template <typename F>
@@ -31,21 +158,14 @@ struct ParsedField {
 
 template <typename T, size_t minlen, size_t maxlen>
 struct StringField : ParsedField<T> {
-  std::optional<std::string_view> parse(std::string_view input) {
-    std::string_view sv;
-    auto res = parse_string(sv, minlen, maxlen, input);
-    if (res)
-      static_cast<T*>(this)->val() = sv;
-    return res;
-  }
+  std::optional<std::string_view> parse(const ValueGroups& input) { return parse_string_value(static_cast<T*>(this)->val(), minlen, maxlen, input); }
 };
 
 // A timestamp is essentially a string using YYMMDDhhmmssX format (where
-// X is W or S for wintertime or summertime). Parsing this into a proper
-// (UNIX) timestamp is hard to do generically. Parsing it into a
-// single integer needs > 4 bytes top fit and isn't very useful (you
-// cannot really do any calculation with those values). So we just parse
-// into a string for now.
+// X is W or S for wintertime or summertime). TimestampField keeps that
+// string. A TimestampDecoder of the caller decodes it into a Timestamp
+// with the seconds since 1970 and the DST flag, e.g.
+// decoder.decode(data.timestamp), and keeps the date for the next telegrams.
 template <typename T>
 struct TimestampField : StringField<T, 13, 13> {};
 
@@ -71,36 +191,86 @@ struct FixedValue {
 // integer unit is passed as a template argument.
 template <typename T, const char* _unit, const char* _int_unit>
 struct FixedField : ParsedField<T> {
-  std::optional<std::string_view> parse(std::string_view input) {
-    // Some smart meters publish int values instead of a float.
-    // E.g. most meters would publish "1-0:1.8.0(000441.879*kWh)",
-    // but some use "1-0:1.8.0(000441879*Wh)" instead.
-    int32_t val;
-    auto res = parse_float_or_int(val, 3, _unit, _int_unit, input);
-    if (res)
-      static_cast<T*>(this)->val()._value = val;
-    return res;
+  std::optional<std::string_view> parse(const ValueGroups& input) {
+    return parse_fixed_value(static_cast<T*>(this)->val()._value, kUnit, kIntUnit, input.rest(), input.failure());
   }
 
   static const char* unit() noexcept { return _unit; }
   static const char* int_unit() noexcept { return _int_unit; }
+
+protected:
+  static constexpr PackedUnit kUnit = PackedUnit(_unit);
+  static constexpr PackedUnit kIntUnit = PackedUnit(_int_unit);
 };
 
 struct TimestampedFixedValue : public FixedValue {
   std::string_view timestamp;
 };
 
+// An entry of a profile generic buffer: a value and the time of the event, e.g. of a peak or of the end of a power failure
+template <typename Value>
+struct ProfileEntry {
+  std::string_view timestamp;
+  Value value;
+};
+
+// The entries of a profile generic buffer, e.g. the peaks of the last 13 months or the power failure log, in the order of the telegram.
+// Holds up to N entries without allocating. If the meter sends more, the others are parsed but not stored and `overflow` is set.
+template <typename Value, size_t N>
+struct ProfileArray {
+  std::array<ProfileEntry<Value>, N> entries{};
+  size_t count = 0;
+  bool overflow = false;
+
+  static constexpr size_t capacity() { return N; }
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  const ProfileEntry<Value>& operator[](size_t i) const { return entries[i]; }
+  const ProfileEntry<Value>* begin() const { return entries.data(); }
+  const ProfileEntry<Value>* end() const { return entries.data() + count; }
+  ProfileEntry<Value>* begin() { return entries.data(); }
+  ProfileEntry<Value>* end() { return entries.data() + count; }
+};
+
+// Parses a profile generic buffer with `ids` OBIS ids in the header and `timestamps` timestamps in each entry into `out`
+template <typename Value, size_t N>
+std::optional<std::string_view> parse_profile(ProfileArray<Value, N>& out, size_t ids, size_t timestamps, size_t decimals, const PackedUnit& unit,
+                                              const PackedUnit& int_unit, ValueGroups input) {
+  size_t count;
+  auto res = parse_profile_header(count, ids, input);
+  if (!res)
+    return std::nullopt;
+
+  for (size_t i = 0; i < count; ++i) {
+    std::string_view timestamp;
+    int32_t value;
+    res = parse_profile_entry(timestamp, value, timestamps, decimals, unit, int_unit, input);
+    if (!res)
+      return std::nullopt;
+    if (i < N) {
+      auto& entry = out.entries[i];
+      entry.timestamp = timestamp;
+      if constexpr (std::is_same_v<Value, FixedValue>)
+        entry.value._value = value;
+      else
+        entry.value = static_cast<Value>(value);
+    }
+  }
+  out.count = count < N ? count : N;
+  out.overflow = count > N;
+  return res;
+}
+
 // Some numerical values are prefixed with a timestamp. This is simply
 // both of them concatenated, e.g. 0-1:24.2.1(150117180000W)(00473.789*m3)
 template <typename T, const char* _unit, const char* _int_unit>
 struct TimestampedFixedField : public FixedField<T, _unit, _int_unit> {
-  std::optional<std::string_view> parse(std::string_view input) {
-    std::string_view ts;
-    auto res = parse_string(ts, 13, 13, input);
-    if (!res)
-      return std::nullopt;
-    static_cast<T*>(this)->val().timestamp = ts;
-    return FixedField<T, _unit, _int_unit>::parse(*res);
+  using Base = FixedField<T, _unit, _int_unit>;
+
+  std::optional<std::string_view> parse(const ValueGroups& input) {
+    auto& value = static_cast<T*>(this)->val();
+    return parse_timestamped_fixed_value(value.timestamp, value._value, Base::kUnit, Base::kIntUnit, input);
   }
 };
 
@@ -108,27 +278,20 @@ struct TimestampedFixedField : public FixedField<T, _unit, _int_unit> {
 // e.g. 0-0:98.1.0(1)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)
 template <typename T, const char* _unit, const char* _int_unit>
 struct LastFixedField : public FixedField<T, _unit, _int_unit> {
-  std::optional<std::string_view> parse(std::string_view input) {
-    std::string_view last = input;
-    std::string_view remaining = input;
-    while (!remaining.empty()) {
-      last = remaining;
-      std::string_view sv;
-      auto res = parse_string(sv, 1, 20, remaining);
-      if (!res)
-        return std::nullopt;
-      remaining = *res;
-    }
-    return FixedField<T, _unit, _int_unit>::parse(last);
+  std::optional<std::string_view> parse(const ValueGroups& input) {
+    const auto last = find_last_value(input);
+    if (!last)
+      return std::nullopt;
+    return FixedField<T, _unit, _int_unit>::parse(ValueGroups(*last, input.failure()));
   }
 };
 
 // A integer number is just represented as an integer.
 template <typename T, const char* _unit>
 struct IntField : ParsedField<T> {
-  std::optional<std::string_view> parse(std::string_view input) {
+  std::optional<std::string_view> parse(const ValueGroups& input) {
     int32_t val;
-    auto res = parse_num(val, 0, _unit, input);
+    auto res = parse_int_value(val, kUnit, input.rest(), input.failure());
     if (res) {
       auto& dst = static_cast<T*>(this)->val();
       dst = static_cast<std::remove_reference_t<decltype(dst)>>(val);
@@ -137,61 +300,200 @@ struct IntField : ParsedField<T> {
   }
 
   static const char* unit() noexcept { return _unit; }
+
+private:
+  static constexpr PackedUnit kUnit = PackedUnit(_unit);
 };
 
-// Take the average of multiple timestamped values. Example:
-//   0-0:98.1.0(2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230202000000W)(230214224500W)(04.529*kW)
-// Will produce an average between 4.329 and 4.529
+// Take the average of multiple timestamped values, e.g. 0-0:98.1.0(2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)...
 template <typename T, const char* _unit, const char* _int_unit>
 struct AveragedFixedField : public FixedField<T, _unit, _int_unit> {
-  std::optional<std::string_view> parse(std::string_view input) {
-    int32_t count;
-    auto res = parse_num(count, 0, "", input);
-    if (!res)
-      return std::nullopt;
+  using Base = FixedField<T, _unit, _int_unit>;
 
-    if (count == 0) {
-      static_cast<T*>(this)->val()._value = 0;
-      return std::string_view{};
-    }
-
-    std::string_view sv;
-    res = parse_string(sv, 1, 20, *res);
-    if (!res)
-      return std::nullopt;
-    res = parse_string(sv, 1, 20, *res);
-    if (!res)
-      return std::nullopt;
+  std::optional<std::string_view> parse(const ValueGroups& input) {
+    return parse_average(static_cast<T*>(this)->val()._value, Base::kUnit, Base::kIntUnit, input);
+  }
+};
 
-    int32_t total = 0;
-    for (int32_t i = 0; i < count; i++) {
-      res = parse_string(sv, 1, 20, *res);
-      if (!res)
-        return std::nullopt;
-      res = parse_string(sv, 1, 20, *res);
-      if (!res)
-        return std::nullopt;
-      int32_t val;
-      res = parse_float_or_int(val, 3, _unit, _int_unit, *res);
-      if (!res)
-        return std::nullopt;
-      total += val;
-    }
+// The entries of a profile generic buffer of fixed point values, stored in a ProfileArray<FixedValue, N>. Each entry has the start
+// of the period and the time of the peak, the entries keep the time of the peak. For example the peaks of the last 13 months:
+// 0-0:98.1.0(2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230202000000W)(230214224500W)(04.529*kW)
+template <typename T, const char* _unit, const char* _int_unit>
+struct FixedProfileField : public FixedField<T, _unit, _int_unit> {
+  using Base = FixedField<T, _unit, _int_unit>;
 
-    static_cast<T*>(this)->val()._value = total / count;
-    return res;
+  std::optional<std::string_view> parse(const ValueGroups& input) {
+    return parse_profile(static_cast<T*>(this)->val(), 2, 2, 3, Base::kUnit, Base::kIntUnit, input);
   }
 };
 
+// The entries of a profile generic buffer of integers, stored in a ProfileArray of an integer type. Each entry has one timestamp.
+// For example the power failure log, with the end and the duration of each failure:
+// 1-0:99.97.0(2)(0-0:96.7.19)(101208152415W)(0000000240*s)(101208151004W)(0000000301*s)
+template <typename T, const char* _unit>
+struct IntProfileField : ParsedField<T> {
+  std::optional<std::string_view> parse(const ValueGroups& input) { return parse_profile(static_cast<T*>(this)->val(), 1, 1, 0, kUnit, kUnit, input); }
+
+  static const char* unit() noexcept { return _unit; }
+
+private:
+  static constexpr PackedUnit kUnit = PackedUnit(_unit);
+};
+
 // Raw field — no parsing, just store the entire value, including any parenthesis around it, as a string_view
 template <typename T>
 struct RawField : ParsedField<T> {
-  std::optional<std::string_view> parse(std::string_view input) {
-    static_cast<T*>(this)->val() = input;
+  std::optional<std::string_view> parse(const ValueGroups& input) {
+    static_cast<T*>(this)->val() = input.rest();
     return std::string_view{};
   }
 };
 
+// The kind of an M-Bus device, from its device type in 0-n:24.1.0 (EN 13757-3)
+enum class MbusMedium : uint8_t { Unknown, Gas, Water, Thermal, Electricity };
+
+// An M-Bus device connected to the meter, e.g. a gas meter
+struct MbusDevice {
+  uint16_t type = 0;                 // 0-n:24.1.0, e.g. 3 for gas
+  std::string_view equipment_id;     // 0-n:96.1.0, or 0-n:96.1.1 on Belgian meters
+  uint8_t valve_position = 0;        // 0-n:24.4.0
+  TimestampedFixedValue delivered{}; // 0-n:24.2.1, or 0-n:24.2.3 on Belgian meters
+  const char* unit = "";             // the unit of `delivered`, e.g. "m3"
+  bool type_present = false;
+  bool equipment_id_present = false;
+  bool valve_position_present = false;
+  bool delivered_present = false;
+
+  bool present() const { return type_present || equipment_id_present || valve_position_present || delivered_present; }
+
+  MbusMedium medium() const {
+    switch (type) {
+    case 0x02:
+      return MbusMedium::Electricity;
+    case 0x03:
+      return MbusMedium::Gas;
+    case 0x06:
+    case 0x07:
+    case 0x15:
+    case 0x16:
+      return MbusMedium::Water;
+    case 0x04:
+    case 0x0A:
+    case 0x0B:
+    case 0x0C:
+    case 0x0D:
+      return MbusMedium::Thermal;
+    default:
+      return MbusMedium::Unknown;
+    }
+  }
+};
+
+// The M-Bus devices on channels 1 to 4, found at runtime from the OBIS ids 0-n:x.x.x of their lines
+struct MbusDevices {
+  static constexpr size_t kChannels = 4;
+  std::array<MbusDevice, kChannels> devices{};
+
+  // The device on `channel` (1 to 4), or nullptr if the telegram had no lines of it
+  const MbusDevice* channel(size_t channel) const {
+    if (channel < 1 || channel > kChannels || !devices[channel - 1].present())
+      return nullptr;
+    return &devices[channel - 1];
+  }
+
+  // The device on the lowest channel with the device type of `medium`, or nullptr
+  const MbusDevice* find(MbusMedium medium) const {
+    for (const auto& device : devices) {
+      if (device.type_present && device.medium() == medium)
+        return &device;
+    }
+    return nullptr;
+  }
+};
+
+// Parses a line of an M-Bus device into `devices`. Returns `input` for the lines of other OBIS ids.
+// The reading is parsed with the units of the device type, e.g. m3 for gas. The meter sends the type first. A reading of a device
+// without a type, or with a type that isn't in MbusMedium, is rejected with ParseError::UnknownDeviceType.
+DSMR_PARSER_NOINLINE inline std::optional<std::string_view> parse_mbus_line(MbusDevices& devices, const ObisId& id, const ValueGroups& groups) {
+  const auto input = groups.rest();
+  const auto& v = id.v;
+  const size_t channel = v[1];
+  if (v[0] != 0 || channel < 1 || channel > MbusDevices::kChannels || v[5] != 255)
+    return input;
+  auto& device = devices.devices[channel - 1];
+  const auto take = [&](bool& present) {
+    if (present)
+      return false;
+    present = true;
+    return true;
+  };
+
+  if (v[2] == 24 && v[3] == 1 && v[4] == 0) {
+    if (!take(device.type_present))
+      return groups.failure().set(ParseError::DuplicateField, input.data());
+    int32_t type;
+    const auto res = parse_int_value(type, PackedUnit(""), input, groups.failure());
+    if (res)
+      device.type = static_cast<uint16_t>(type);
+    return res;
+  }
+  if (v[2] == 96 && v[3] == 1 && (v[4] == 0 || v[4] == 1)) {
+    if (!take(device.equipment_id_present))
+      return groups.failure().set(ParseError::DuplicateField, input.data());
+    return parse_string_value(device.equipment_id, 0, 96, groups);
+  }
+  if (v[2] == 24 && v[3] == 4 && v[4] == 0) {
+    if (!take(device.valve_position_present))
+      return groups.failure().set(ParseError::DuplicateField, input.data());
+    int32_t position;
+    const auto res = parse_int_value(position, PackedUnit(""), input, groups.failure());
+    if (res)
+      device.valve_position = static_cast<uint8_t>(position);
+    return res;
+  }
+  if (v[2] == 24 && v[3] == 2 && (v[4] == 1 || v[4] == 3)) {
+    if (!take(device.delivered_present))
+      return groups.failure().set(ParseError::DuplicateField, input.data());
+    struct Units final {
+      MbusMedium medium;
+      const char* unit;
+      PackedUnit packed;
+      PackedUnit int_unit;
+    };
+    static constexpr Units kUnits[] = {
+        {MbusMedium::Gas, "m3", PackedUnit("m3"), PackedUnit("dm3")},
+        {MbusMedium::Water, "m3", PackedUnit("m3"), PackedUnit("dm3")},
+        {MbusMedium::Thermal, "GJ", PackedUnit("GJ"), PackedUnit("MJ")},
+        {MbusMedium::Electricity, "kWh", PackedUnit("kWh"), PackedUnit("Wh")},
+    };
+    const auto medium = device.type_present ? device.medium() : MbusMedium::Unknown;
+    for (const auto& units : kUnits) {
+      if (units.medium != medium)
+        continue;
+      const auto res = parse_timestamped_fixed_value(device.delivered.timestamp, device.delivered._value, units.packed, units.int_unit, groups);
+      if (res)
+        device.unit = units.unit;
+      return res;
+    }
+    return groups.failure().set(ParseError::UnknownDeviceType, input.data());
+  }
+  return input;
+}
+
+// Takes the lines of the M-Bus devices on all channels, e.g. 0-2:24.2.1, and stores them in MbusDevices by channel.
+// One ParsedData covers the installations with a gas or water meter on any channel. The fields of a fixed channel,
+// e.g. gas_delivered, take their lines first if they are in the same ParsedData.
+template <typename T>
+struct MbusDevicesField : ParsedField<T> {
+  std::optional<std::string_view> parse_line(const ObisId& id, const ValueGroups& input) {
+    auto& field = *static_cast<T*>(this);
+    const auto res = parse_mbus_line(field.val(), id, input);
+    if (!res || res->data() != input.rest().data())
+      field.present() = true;
+    return res;
+  }
+};
+
 namespace fields {
 struct units final {
   static inline constexpr char none[] = "";
@@ -220,6 +522,11 @@ struct units final {
   static inline constexpr char kHz[] = "kHz";
 };
 
+// The peaks of the last 13 months
+using MaximumDemandHistory = ProfileArray<FixedValue, 13>;
+// The durations of the last power failures in seconds. DSMR meters keep the last 10.
+using PowerFailureLog = ProfileArray<uint32_t, 10>;
+
 #define DEFINE_FIELD(fieldname, value_t, obis, field_t, ...)        \
   struct fieldname : field_t<fieldname __VA_OPT__(, __VA_ARGS__)> { \
     value_t fieldname;                                              \
@@ -230,6 +537,16 @@ struct units final {
     bool& present() { return fieldname##_present; }                 \
   }
 
+// A field without an OBIS id of its own. field_t takes the lines with a parse_line() method, see is_line_field.
+#define DEFINE_LINE_FIELD(fieldname, value_t, field_t) \
+  struct fieldname : field_t<fieldname> {               \
+    value_t fieldname;                                  \
+    bool fieldname##_present = false;                   \
+    static inline constexpr char name[] = #fieldname;   \
+    value_t& val() { return fieldname; }                \
+    bool& present() { return fieldname##_present; }     \
+  }
+
 // Meter identification. This is not a normal field, but a specially-formatted first line of the message
 DEFINE_FIELD(identification, std::string_view, ObisId(255, 255, 255, 255, 255, 255), RawField);
 
@@ -348,6 +665,8 @@ DEFINE_FIELD(electricity_long_failures, uint32_t, ObisId(0, 0, 96, 7, 9), IntFie
 
 // Power Failure Event Log (long power failures)
 DEFINE_FIELD(electricity_failure_log, std::string_view, ObisId(1, 0, 99, 97, 0), RawField);
+// The same log, decoded. Use one of them, the first one in the ParsedData gets the value
+DEFINE_FIELD(electricity_failure_log_entries, PowerFailureLog, ObisId(1, 0, 99, 97, 0), IntProfileField, units::s);
 
 // Number of voltage sags in phase L1
 DEFINE_FIELD(electricity_sags_l1, uint32_t, ObisId(1, 0, 32, 32, 0), IntField, units::none);
@@ -477,6 +796,9 @@ DEFINE_FIELD(active_demand_net, FixedValue, ObisId(1, 0, 16, 24, 0), FixedField,
 // Active Demand Avg3 Absolute  in W resolution
 DEFINE_FIELD(active_demand_abs, FixedValue, ObisId(1, 0, 15, 24, 0), FixedField, units::kW, units::W);
 
+// The M-Bus devices on channels 1 to 4, whatever their channel
+DEFINE_LINE_FIELD(mbus_devices, MbusDevices, MbusDevicesField);
+
 // Device-Type
 DEFINE_FIELD(gas_device_type, uint16_t, ObisId(0, DSMR_GAS_MBUS_ID, 24, 1, 0), IntField, units::none);
 
@@ -554,6 +876,8 @@ DEFINE_FIELD(apparent_energy_export_last_completed_demand, FixedValue, ObisId(1,
 DEFINE_FIELD(active_energy_import_maximum_demand_running_month, TimestampedFixedValue, ObisId(1, 0, 1, 6, 0), TimestampedFixedField, units::kW, units::W);
 // Maximum energy consumption from the last 13 months
 DEFINE_FIELD(active_energy_import_maximum_demand_last_13_months, FixedValue, ObisId(0, 0, 98, 1, 0), AveragedFixedField, units::kW, units::W);
+// The same peaks, one by one. Use one of them, the first one in the ParsedData gets the value
+DEFINE_FIELD(active_energy_import_maximum_demand_history, MaximumDemandHistory, ObisId(0, 0, 98, 1, 0), FixedProfileField, units::kW, units::W);
 
 // Image Core Version and checksum
 DEFINE_FIELD(fw_core_version, std::string_view, ObisId(1, 0, 0, 2, 0), StringField, 0, 96);
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "fields.h"
+#include "parse_error.h"
+#include "parser.h"
+#include "stats.h"
+#include "util.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace dsmr_parser {
+
+// Moves a value decoded from the previous telegram to the same bytes in the current one.
+// `previous` is the address of the bytes in the previous telegram, `current` the address of the same bytes now.
+// The previous telegram is not accessed, it may already be overwritten.
+template <typename Value>
+struct CachedValue {
+  static Value rebase(const Value& value, uintptr_t, const char*) { return value; }
+};
+
+template <>
+struct CachedValue<std::string_view> {
+  static std::string_view rebase(std::string_view value, uintptr_t previous, const char* current) {
+    if (value.data() == nullptr)
+      return value;
+    return std::string_view(current + (reinterpret_cast<uintptr_t>(value.data()) - previous), value.size());
+  }
+};
+
+template <>
+struct CachedValue<TimestampedFixedValue> {
+  static TimestampedFixedValue rebase(const TimestampedFixedValue& value, uintptr_t previous, const char* current) {
+    auto result = value;
+    result.timestamp = CachedValue<std::string_view>::rebase(value.timestamp, previous, current);
+    return result;
+  }
+};
+
+template <typename Value, size_t N>
+struct CachedValue<ProfileArray<Value, N>> {
+  static ProfileArray<Value, N> rebase(const ProfileArray<Value, N>& value, uintptr_t previous, const char* current) {
+    auto result = value;
+    for (auto& entry : result)
+      entry.timestamp = CachedValue<std::string_view>::rebase(entry.timestamp, previous, current);
+    return result;
+  }
+};
+
+template <>
+struct CachedValue<MbusDevices> {
+  static MbusDevices rebase(const MbusDevices& value, uintptr_t previous, const char* current) {
+    auto result = value;
+    for (auto& device : result.devices) {
+      device.equipment_id = CachedValue<std::string_view>::rebase(device.equipment_id, previous, current);
+      device.delivered = CachedValue<TimestampedFixedValue>::rebase(device.delivered, previous, current);
+    }
+    return result;
+  }
+};
+
+// Parses consecutive telegrams of one meter and reuses what was decoded from the previous telegram.
+// - A telegram that is identical to the previous one is not parsed at all. Its values are copied from the previous result.
+// - Otherwise a line with the same position, OBIS id and bytes as in the previous telegram copies the value instead of decoding it again.
+// Identical is decided by a 64 bit WordHash of the bytes. Only the first N lines are cached.
+// The results are the same as from DsmrParser::parse(). For a telegram that is skipped completely, only parsed_telegrams is counted in the stats.
+template <size_t N, typename... Ts>
+class LineCache final {
+public:
+  using Data = ParsedData<Ts...>;
+
+private:
+  struct Line final {
+    uint64_t hash;
+    uintptr_t value; // the address of the value in the previous telegram
+  };
+
+  // The destination of one telegram with the parse_line() method of ParsedData, for DsmrParser::parse_lines()
+  struct Target final {
+    LineCache& cache;
+    Data& data;
+    size_t line = 0;
+    uintptr_t previous_value = 0;
+
+    std::optional<std::string_view> parse_line(const ObisId& obis_id, const ValueGroups& input) {
+      const size_t index = line++;
+      if (index >= N)
+        return data.parse_line(obis_id, input);
+
+      auto& cached = cache._lines[index];
+      const auto hash = WordHash::calculate(input.rest(), obis_id.key());
+      const bool hit = cache._valid && index < cache._line_count && cached.hash == hash;
+      previous_value = cached.value;
+      cached = Line{hash, reinterpret_cast<uintptr_t>(input.rest().data())};
+      if (!hit)
+        return data.parse_line(obis_id, input);
+
+      static constexpr auto table = Table::create({entry<Ts>()...});
+      const auto* entry = table.find(obis_id);
+      if (entry == nullptr) {
+        // The values of line fields are not copied, they are parsed again
+        if constexpr ((is_line_field<Ts> || ...))
+          return data.parse_line(obis_id, input);
+        return input.rest();
+      }
+      return entry->parse(*this, input);
+    }
+  };
+
+  using Table = ObisDispatchTable<Target, sizeof...(Ts)>;
+
+  Data _previous{};
+  std::array<Line, N> _lines{};
+  size_t _line_count = 0;
+  uint64_t _fingerprint = 0;
+  uintptr_t _telegram = 0;
+  bool _unknown_error = false;
+  bool _valid = false;
+
+  // Line fields are not in the table, like in ParsedData
+  template <typename F>
+  static constexpr typename Table::Entry entry() {
+    if constexpr (is_line_field<F>)
+      return {dispatch_key<F>(), nullptr};
+    else
+      return {dispatch_key<F>(), &copy_field<F>};
+  }
+
+  template <typename F>
+  static std::optional<std::string_view> copy_field(Target& target, const ValueGroups& input) {
+    const auto value = input.rest();
+    auto& field = static_cast<F&>(target.data);
+    if (field.present())
+      return input.failure().set(ParseError::DuplicateField, value.data());
+    auto& previous = static_cast<F&>(target.cache._previous);
+    using Value = std::remove_cvref_t<decltype(field.val())>;
+    field.present() = true;
+    field.val() = CachedValue<Value>::rebase(previous.val(), target.previous_value, value.data());
+    return value.substr(value.size());
+  }
+
+  template <typename F>
+  void copy_telegram_field(Data& data, const char* telegram) {
+    auto& field = static_cast<F&>(data);
+    auto& previous = static_cast<F&>(_previous);
+    using Value = std::remove_cvref_t<decltype(field.val())>;
+    field.present() = previous.present();
+    if (previous.present())
+      field.val() = CachedValue<Value>::rebase(previous.val(), _telegram, telegram);
+  }
+
+public:
+  // Parses `telegram` into `data`, that must not have any fields present, like with DsmrParser::parse().
+  ParseResult parse(Data& data, DsmrUnencryptedTelegram telegram, bool unknown_error = false, ParserStats* stats = nullptr) {
+    const auto content = telegram.content();
+    const auto fingerprint = WordHash::calculate(content);
+    if (_valid && fingerprint == _fingerprint && unknown_error == _unknown_error) {
+      // _previous keeps pointing into the telegram it was parsed from, so _telegram stays the same
+      (copy_telegram_field<Ts>(data, content.data()), ...);
+      StatsHandle(stats).count(&ParserStats::parsed_telegrams);
+      return {};
+    }
+
+    Target target{*this, data};
+    const auto result = DsmrParser::parse_lines(target, telegram, unknown_error, stats);
+    _valid = static_cast<bool>(result);
+    if (_valid) {
+      _previous = data;
+      _line_count = std::min(target.line, N);
+      _fingerprint = fingerprint;
+      _telegram = reinterpret_cast<uintptr_t>(content.data());
+      _unknown_error = unknown_error;
+    }
+    return result;
+  }
+
+  // Forgets the previous telegram
+  void clear() { _valid = false; }
+};
+
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "stats.h"
 #include "util.h"
 #include <cstdint>
 #include <optional>
@@ -12,6 +13,7 @@ class PacketAccumulator final {
   class DsmrPacketBuffer final {
     std::span<uint8_t> _buffer;
     std::size_t _packetSize = 0;
+    uint16_t _crc = 0; // CRC16 of the bytes added so far. Updated on every byte to not compute it all at once at the end of the telegram.
 
   public:
     explicit DsmrPacketBuffer(std::span<uint8_t> buffer) : _buffer{buffer} {}
@@ -21,23 +23,13 @@ class PacketAccumulator final {
     void add(uint8_t byte) {
       _buffer[_packetSize] = byte;
       _packetSize++;
+
+      _crc = Crc16::update(_crc, byte);
     }
 
     bool has_space() const { return _packetSize < _buffer.size(); }
 
-    uint16_t calculate_crc16() const {
-      uint16_t crc = 0;
-      for (std::size_t i = 0; i < _packetSize; ++i) {
-        crc ^= static_cast<uint8_t>(_buffer[i]);
-        for (std::size_t bit = 0; bit < 8; bit++) {
-          if (crc & 1)
-            crc = (crc >> 1) ^ 0xa001;
-          else
-            crc = (crc >> 1);
-        }
-      }
-      return crc;
-    }
+    uint16_t crc16() const { return _crc; }
   };
 
   class CrcAccumulator final {
@@ -72,19 +64,29 @@ class PacketAccumulator final {
   DsmrPacketBuffer _buf;
   CrcAccumulator _crc_accumulator;
   bool _check_crc;
+  DSMR_PARSER_NO_UNIQUE_ADDRESS StatsHandle _stats;
 
 public:
   PacketAccumulator(std::span<uint8_t> buffer, bool check_crc) : _raw_buffer(buffer), _buf(buffer), _check_crc(check_crc) {}
 
+  // Counts the bytes, telegrams and errors in `stats` if DSMR_PARSER_STATS is enabled. nullptr to stop counting.
+  void set_stats(ParserStats* stats) { _stats = stats; }
+
+  // The bytes of the current telegram received so far, starting with '/'.
+  // After the end symbol '!' it stays unchanged until the next telegram starts.
+  std::string_view packet() const { return _buf.packet(); }
+
   std::optional<DsmrUnencryptedTelegram> process_byte(const uint8_t byte) {
+    _stats.count(&ParserStats::bytes);
     if (!_buf.has_space()) {
-      Logger::log(LogLevel::DEBUG, "Buffer overflow. Discarding the accumulated data");
+      DSMR_PARSER_LOG(LogLevel::DEBUG, "Buffer overflow. Discarding the accumulated data");
+      _stats.count(&ParserStats::buffer_overflows);
       _buf = DsmrPacketBuffer(_raw_buffer);
       _state = State::WaitingForPacketStartSymbol;
     }
 
     if (byte == '/') {
-      Logger::log(LogLevel::VERBOSE, "Found telegram start symbol '/'");
+      DSMR_PARSER_LOG(LogLevel::VERBOSE, "Found telegram start symbol '/'");
       _buf = DsmrPacketBuffer(_raw_buffer);
       _buf.add(byte);
       _state = State::WaitingForPacketEndSymbol;
@@ -102,10 +104,11 @@ public:
         return std::nullopt;
       }
 
-      Logger::log(LogLevel::VERBOSE, "Found telegram end symbol '!'");
+      DSMR_PARSER_LOG(LogLevel::VERBOSE, "Found telegram end symbol '!'");
       if (!_check_crc) {
         _state = State::WaitingForPacketStartSymbol;
-        Logger::log(LogLevel::VERBOSE, "Successfully received the telegram without CRC check");
+        DSMR_PARSER_LOG(LogLevel::VERBOSE, "Successfully received the telegram without CRC check");
+        _stats.count(&ParserStats::telegrams);
         return DsmrUnencryptedTelegram(_buf.packet());
       }
 
@@ -115,7 +118,8 @@ public:
 
     case State::WaitingForCrc:
       if (!_crc_accumulator.add_to_crc(byte)) {
-        Logger::log(LogLevel::DEBUG, "Incorrect CRC character '%c'", byte);
+        DSMR_PARSER_LOG(LogLevel::DEBUG, "Incorrect CRC character '%c'", byte);
+        _stats.count(&ParserStats::crc_errors);
         _state = State::WaitingForPacketStartSymbol;
         return std::nullopt;
       }
@@ -126,12 +130,14 @@ public:
 
       _state = State::WaitingForPacketStartSymbol;
 
-      if (_crc_accumulator.crc_value() == _buf.calculate_crc16()) {
-        Logger::log(LogLevel::VERBOSE, "Successfully received the telegram with correct CRC");
+      if (_crc_accumulator.crc_value() == _buf.crc16()) {
+        DSMR_PARSER_LOG(LogLevel::VERBOSE, "Successfully received the telegram with correct CRC");
+        _stats.count(&ParserStats::telegrams);
         return DsmrUnencryptedTelegram(_buf.packet());
       }
 
-      Logger::log(LogLevel::DEBUG, "CRC mismatch: expected %04X, got %04X", _crc_accumulator.crc_value(), _buf.calculate_crc16());
+      DSMR_PARSER_LOG(LogLevel::DEBUG, "CRC mismatch: expected %04X, got %04X", _crc_accumulator.crc_value(), _buf.crc16());
+      _stats.count(&ParserStats::crc_errors);
       return std::nullopt;
     }
 
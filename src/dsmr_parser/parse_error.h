@@ -0,0 +1,147 @@
+#pragma once
+
+#include "util.h"
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace dsmr_parser {
+
+// Why a telegram was rejected by the parser
+enum class ParseError : uint8_t {
+  None,
+
+  // The structure of a line
+  ObisNumberOver255,
+  EmptyObisId,
+  UnexpectedOpenParenthesis,
+  UnexpectedCloseParenthesis,
+  LastLineNotTerminated,
+
+  // The value of a field
+  MissingOpenParenthesis,
+  MissingCloseParenthesis,
+  InvalidStringLength,
+  InvalidNumber,
+  MissingUnit,
+  InvalidUnit,
+  ExtraData,
+  UnknownDeviceType, // the reading of an M-Bus device without a known device type
+  InvalidValue, // a field failed without telling why
+
+  // The fields of the telegram
+  DuplicateField,
+  TrailingCharacters,
+  UnknownField,
+
+  // The frame of the telegram, checked by DsmrParser::validate()
+  InvalidFrame,
+  InvalidCrc,
+  InvalidLineEnding,
+};
+
+inline const char* to_string(const ParseError error) {
+  switch (error) {
+  case ParseError::None:
+    return "No error";
+  case ParseError::ObisNumberOver255:
+    return "Obis ID has number over 255";
+  case ParseError::EmptyObisId:
+    return "OBIS id Empty";
+  case ParseError::UnexpectedOpenParenthesis:
+    return "Unexpected '(' symbol";
+  case ParseError::UnexpectedCloseParenthesis:
+    return "Unexpected ')' symbol";
+  case ParseError::LastLineNotTerminated:
+    return "Last dataline not CRLF terminated";
+  case ParseError::MissingOpenParenthesis:
+    return "Missing (";
+  case ParseError::MissingCloseParenthesis:
+    return "Missing )";
+  case ParseError::InvalidStringLength:
+    return "Invalid string length";
+  case ParseError::InvalidNumber:
+    return "Invalid number";
+  case ParseError::MissingUnit:
+    return "Missing unit";
+  case ParseError::InvalidUnit:
+    return "Invalid unit";
+  case ParseError::ExtraData:
+    return "Extra data";
+  case ParseError::UnknownDeviceType:
+    return "Unknown M-Bus device type";
+  case ParseError::InvalidValue:
+    return "Invalid value";
+  case ParseError::DuplicateField:
+    return "Duplicate field";
+  case ParseError::TrailingCharacters:
+    return "Trailing characters on data line";
+  case ParseError::UnknownField:
+    return "Unknown field";
+  case ParseError::InvalidFrame:
+    return "Missing '/' or '!'";
+  case ParseError::InvalidCrc:
+    return "Invalid CRC";
+  case ParseError::InvalidLineEnding:
+    return "Line not terminated with CRLF";
+  }
+  return "Unknown error";
+}
+
+// The result of parsing a telegram. Converts to true on success.
+// Only the reason and the position are stored. The text of the message is built by format(), when the caller asks for it.
+struct ParseResult final {
+  ParseError error = ParseError::None;
+  uint32_t offset = 0; // where the error was found, in bytes from the '/' at the start of the telegram
+  ObisId id;           // the OBIS id of the line with the error. ObisId() for errors in the OBIS id or in the parentheses.
+
+  // Not explicit, DsmrParser::parse returned a bool before and `bool ok = DsmrParser::parse(...)` keeps working
+  operator bool() const { return error == ParseError::None; }
+  bool operator==(const ParseResult&) const = default;
+
+  const char* message() const { return to_string(error); }
+
+  // The physical line of `telegram` that contains the error, without the line ending. `telegram` is the one that was parsed.
+  std::string_view line(std::string_view telegram) const {
+    const size_t pos = offset < telegram.size() ? offset : telegram.size();
+    const auto start = telegram.substr(0, pos).find_last_of("\r\n");
+    const size_t begin = start == std::string_view::npos ? 0 : start + 1;
+    const auto end = telegram.find_first_of("\r\n", pos);
+    return telegram.substr(begin, (end == std::string_view::npos ? telegram.size() : end) - begin);
+  }
+
+  // Writes a message like "Missing unit at offset 35: '1-0:1.7.0(00.100*XX)'" to `buffer`. Returns the result of snprintf().
+  int format(std::span<char> buffer, std::string_view telegram) const {
+    const auto text = line(telegram);
+    return std::snprintf(buffer.data(), buffer.size(), "%s at offset %u: '%.*s'", message(), static_cast<unsigned>(offset), static_cast<int>(text.size()),
+                         text.data());
+  }
+};
+
+// The reason and the position of a failure of the parse functions.
+// parse_obis(), parse_string(), parse_num(), the fields and the tokenizer take it from their caller, record their failure in it
+// and return std::nullopt, so nothing is formatted on the error path. DsmrParser and StreamingParser turn it into a ParseResult.
+struct ParseFailure final {
+  ParseError error = ParseError::None;
+  const char* position = nullptr; // points into the telegram
+
+  bool operator==(const ParseFailure&) const = default;
+
+  // Returns std::nullopt to allow `return failure.set(...);`
+  std::nullopt_t set(const ParseError reason, const char* at) {
+    error = reason;
+    position = at;
+    return std::nullopt;
+  }
+
+  // The result for a failure in `telegram`. `id` is the OBIS id of the line, if it is known.
+  // A position outside of `telegram` is reported at offset 0.
+  ParseResult result(std::string_view telegram, const ObisId& id = ObisId()) const {
+    const auto offset = reinterpret_cast<uintptr_t>(position) - reinterpret_cast<uintptr_t>(telegram.data());
+    return ParseResult{error, static_cast<uint32_t>(position != nullptr && offset <= telegram.size() ? offset : 0), id};
+  }
+};
+
+}
@@ -1,78 +1,526 @@
 #pragma once
 
+#include "parse_error.h"
+#include "stats.h"
+#include "tokenizer.h"
 #include "util.h"
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <optional>
+#include <span>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
 
 namespace dsmr_parser {
 
+// Parse a parenthesized string: (content)
+// Handles double-closing brackets like ((ER11))
+// On failure returns std::nullopt and records the reason in `failure`, like the other parse functions.
+inline std::optional<std::string_view> parse_string(std::string_view& out, size_t min, size_t max, std::string_view input, ParseFailure& failure) {
+  if (input.empty() || input.front() != '(')
+    return failure.set(ParseError::MissingOpenParenthesis, input.data());
+
+  size_t pos = 1;
+  while (pos < input.size() && input[pos] != ')')
+    ++pos;
+
+  // Handle )) at the end — include the first ) in the string
+  if (pos + 1 < input.size() && input[pos + 1] == ')')
+    ++pos;
+
+  if (pos == input.size())
+    return failure.set(ParseError::MissingCloseParenthesis, input.data() + pos);
+
+  auto len = pos - 1;
+  if (len < min || len > max)
+    return failure.set(ParseError::InvalidStringLength, input.data());
+
+  out = input.substr(1, len);
+  return input.substr(pos + 1);
+}
+
+inline std::optional<std::string_view> parse_string(std::string_view& out, size_t min, size_t max, std::string_view input) {
+  ParseFailure failure;
+  return parse_string(out, min, max, input, failure);
+}
+
+// The value of a line as a sequence of parenthesized groups, e.g. (1)(1-0:1.6.0)(04.329*kW), taken one at a time by the parse kernels.
+// The kernels record their failures in the ParseFailure of the line, that the caller passes with the value.
+// The groups are split here by the kernels, not by TelegramTokenizer: recording the bounds in the tokenizer pass made a full parse slower
+// than scanning the few bytes of each value again, so the tokenizer only gives the value of the line.
+class ValueGroups final {
+  std::string_view _rest;
+  ParseFailure* _failure;
+
+public:
+  ValueGroups(std::string_view value, ParseFailure& failure) : _rest(value), _failure(&failure) {}
+
+  // The part of the value that is not taken yet
+  std::string_view rest() const { return _rest; }
+
+  // Where the kernels record why the value is rejected
+  ParseFailure& failure() const { return *_failure; }
+
+  // Takes the next group as a string of `min` to `max` characters. Same as parse_string() on rest().
+  std::optional<std::string_view> string(std::string_view& out, size_t min, size_t max) {
+    const auto res = parse_string(out, min, max, _rest, *_failure);
+    if (res)
+      _rest = *res;
+    return res;
+  }
+
+  // Continues at `rest`, after a group that was parsed from rest(), e.g. by parse_num()
+  void skip_to(std::string_view rest) { _rest = rest; }
+};
+
+// The open addressing hash tables over OBIS ids of ObisDispatchTable and SchemaParser. A key goes to the slot given by the top bits
+// of key * multiplier, and to the next free slot after it on a collision. `slots` has a power of two size and holds the index of
+// the key + 1, 0 = empty slot. A key that is already in the table is skipped, so the first one wins.
+// Returns the longest probe sequence.
+template <typename SlotIndex, typename KeyOf>
+constexpr size_t build_obis_slots(std::span<SlotIndex> slots, size_t count, KeyOf key_of, uint64_t multiplier) {
+  const auto mask = slots.size() - 1;
+  const auto shift = 64 - std::countr_zero(slots.size());
+  std::fill(slots.begin(), slots.end(), SlotIndex{0});
+  size_t max_probe = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const uint64_t key = key_of(i);
+    size_t slot = static_cast<size_t>((key * multiplier) >> shift);
+    size_t probe = 0;
+    bool duplicate = false;
+    while (slots[slot] != 0) {
+      if (key_of(slots[slot] - 1u) == key) {
+        duplicate = true;
+        break;
+      }
+      slot = (slot + 1) & mask;
+      ++probe;
+    }
+    if (duplicate)
+      continue;
+    slots[slot] = static_cast<SlotIndex>(i + 1);
+    max_probe = std::max(max_probe, probe);
+  }
+  return max_probe;
+}
+
+// Chooses the multiplier that keeps the longest probe sequence as short as possible among the golden ratio and up to 64 splitmix64
+// steps after it. `build(multiplier)` builds the table and returns its longest probe sequence. The table is left built with the result.
+template <typename Build>
+constexpr uint64_t choose_obis_multiplier(Build build) {
+  uint64_t best = 0x9E3779B97F4A7C15ull;
+  size_t best_probe = build(best);
+  uint64_t candidate = best;
+  for (int attempt = 0; attempt < 64 && best_probe > 0; ++attempt) {
+    // splitmix64 step, forced odd
+    candidate += 0x9E3779B97F4A7C15ull;
+    uint64_t z = candidate;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z = (z ^ (z >> 31)) | 1u;
+    const auto probe = build(z);
+    if (probe < best_probe) {
+      best = z;
+      best_probe = probe;
+    }
+  }
+  build(best);
+  return best;
+}
+
+// Open addressing hash table over the OBIS ids of the fields of `Data`, built at compile time.
+// The multiplier of the hash function is chosen to keep the longest probe sequence as short as possible,
+// so a lookup costs the same for 5 or 150 fields and an unknown id usually hits an empty slot on the first probe.
+// Fields with the same id are resolved in favor of the first one in `fields`.
+template <typename Data, size_t N>
+struct ObisDispatchTable final {
+  using ParseFunction = std::optional<std::string_view> (*)(Data&, const ValueGroups&);
+
+  struct Entry final {
+    uint64_t key;
+    ParseFunction parse;
+  };
+
+  static constexpr size_t kSlotCount = std::bit_ceil(N * 2 + 2);
+  static constexpr int kShift = 64 - std::countr_zero(kSlotCount);
+  using SlotIndex = std::conditional_t<(N < 255), uint8_t, uint16_t>;
+
+  std::array<Entry, N> entries{};
+  std::array<SlotIndex, kSlotCount> slots{}; // index into entries + 1. 0 = empty slot
+  uint64_t multiplier = 0;
+  size_t max_probe = 0;
+
+  static constexpr size_t slot_of(uint64_t key, uint64_t multiplier) { return (key * multiplier) >> kShift; }
+
+  // Returns the longest probe sequence
+  constexpr size_t build(uint64_t mult) {
+    multiplier = mult;
+    max_probe = build_obis_slots(std::span<SlotIndex>(slots), N, [this](size_t i) { return entries[i].key; }, mult);
+    return max_probe;
+  }
+
+  static constexpr ObisDispatchTable create(const std::array<Entry, N>& fields) {
+    ObisDispatchTable table;
+    table.entries = fields;
+    choose_obis_multiplier([&table](uint64_t mult) { return table.build(mult); });
+    return table;
+  }
+
+  // The entry of the field with `obis_id`, or nullptr
+  constexpr const Entry* find(const ObisId& obis_id) const {
+    if constexpr (N == 0) {
+      (void)obis_id;
+      return nullptr;
+    } else {
+      const auto key = obis_id.key();
+      size_t slot = slot_of(key, multiplier);
+      for (size_t probe = 0; probe <= max_probe; ++probe) {
+        const auto index = slots[slot];
+        if (index == 0)
+          return nullptr;
+        const auto& entry = entries[index - 1u];
+        if (entry.key == key)
+          return &entry;
+        slot = (slot + 1) % kSlotCount;
+      }
+      return nullptr;
+    }
+  }
+};
+
+// Fields with a parse_line() method take the lines of several OBIS ids, e.g. the M-Bus devices of all channels.
+// ParsedData offers them the lines that no other field takes. They return `input` for the lines that aren't theirs.
+template <typename F>
+inline constexpr bool is_line_field = requires(F& field, const ObisId& id, const ValueGroups& input) { field.parse_line(id, input); };
+
+// The key of a field in ObisDispatchTable. Line fields have no OBIS id and are not in the table, their key is out of the range of
+// ObisId::key(), so it never matches.
+template <typename F>
+constexpr uint64_t dispatch_key() {
+  if constexpr (is_line_field<F>)
+    return ~uint64_t{0};
+  else
+    return F::id.key();
+}
+
+// Passes the groups to the fields that take them. The fields of the users of the library may take the value as a std::string_view.
+template <typename F>
+std::optional<std::string_view> parse_field_value(F& field, const ValueGroups& input) {
+  if constexpr (requires { field.parse(input); })
+    return field.parse(input);
+  else
+    return field.parse(input.rest());
+}
+
 // ParsedData is a template for the result of parsing a DSMR telegram.
 // You pass the fields you want to add to it as template arguments.
 // Each field becomes a base class, exposing its member variable directly.
 template <typename... Ts>
 struct ParsedData final : Ts... {
-  std::optional<std::string_view> parse_line(const ObisId& obis_id, std::string_view input) {
-    std::optional<std::string_view> res = input;
-    auto try_field = [&](auto& field) -> bool {
-      using F = std::remove_reference_t<decltype(field)>;
-      if (!(F::id == obis_id))
+  // Returns the rest of `input`, or std::nullopt with the reason in input.failure()
+  std::optional<std::string_view> parse_line(const ObisId& obis_id, const ValueGroups& input) {
+    static constexpr auto table = Table::create({entry<Ts>()...});
+    const auto* entry = table.find(obis_id);
+    if (entry == nullptr)
+      return parse_other_line(obis_id, input);
+    return entry->parse(*this, input);
+  }
+
+  bool all_present() { return (Ts::present() && ...); }
+
+private:
+  using Table = ObisDispatchTable<ParsedData, sizeof...(Ts)>;
+
+  template <typename F>
+  static constexpr typename Table::Entry entry() {
+    if constexpr (is_line_field<F>)
+      return {dispatch_key<F>(), nullptr};
+    else
+      return {dispatch_key<F>(), &parse_field<F>};
+  }
+
+  template <typename F>
+  static std::optional<std::string_view> parse_field(ParsedData& data, const ValueGroups& input) {
+    auto& field = static_cast<F&>(data);
+    if (field.present())
+      return input.failure().set(ParseError::DuplicateField, input.rest().data());
+    field.present() = true;
+    return parse_field_value(field, input);
+  }
+
+  // Offers a line to the line fields, until one of them takes it
+  std::optional<std::string_view> parse_other_line(const ObisId& obis_id, const ValueGroups& input) {
+    std::optional<std::string_view> res = input.rest();
+    if constexpr ((is_line_field<Ts> || ...)) {
+      const auto taken = [&]<typename F>(F& field) {
+        if constexpr (is_line_field<F>) {
+          res = field.parse_line(obis_id, input);
+          return !res || res->data() != input.rest().data();
+        }
         return false;
-      if (field.present()) {
-        Logger::log(LogLevel::ERROR, "Duplicate field [%.*s]", static_cast<int>(input.size()), input.data());
-        res = std::nullopt;
-      } else {
-        field.present() = true;
-        res = field.parse(input);
-      }
-      return true;
-    };
-    (void)try_field;
-    (void)(try_field(static_cast<Ts&>(*this)) || ...);
+      };
+      (taken(static_cast<Ts&>(*this)) || ...);
+    }
     return res;
   }
+};
 
-  bool all_present() { return (Ts::present() && ...); }
+template <typename View>
+struct ParsedDataFields;
+
+template <typename... Ts>
+struct ParsedDataFields<ParsedData<Ts...>> {
+  static constexpr size_t count = sizeof...(Ts);
+  static constexpr bool line_fields = (is_line_field<Ts> || ...);
 };
 
-// Parse a parenthesized string: (content)
-// Handles double-closing brackets like ((ER11))
-inline std::optional<std::string_view> parse_string(std::string_view& out, size_t min, size_t max, std::string_view input) {
-  if (input.empty() || input.front() != '(') {
-    Logger::log(LogLevel::ERROR, "Missing ( '%.*s'", static_cast<int>(input.size()), input.data());
-    return std::nullopt;
+// The destination of one telegram for several ParsedData at once, for DsmrParser::parse_lines().
+// The lines are dispatched with one table of the fields of all views. A field is decoded into the first view that has it,
+// and copied into the other views that have it. Views with another field of the same OBIS id parse the line themselves.
+template <typename... Views>
+class ParsedDataViews final {
+  std::tuple<Views&...> _views;
+  ObisId _id; // the id of the line that is dispatched
+
+  static constexpr size_t kFields = (ParsedDataFields<Views>::count + ... + 0);
+  using Table = ObisDispatchTable<ParsedDataViews, kFields>;
+
+  template <typename F>
+  static constexpr typename Table::Entry entry() {
+    if constexpr (is_line_field<F>)
+      return {dispatch_key<F>(), nullptr};
+    else
+      return {dispatch_key<F>(), &parse_shared<F>};
   }
 
-  size_t pos = 1;
-  while (pos < input.size() && input[pos] != ')')
-    ++pos;
+  template <typename... Ts>
+  static constexpr void append([[maybe_unused]] std::array<typename Table::Entry, kFields>& entries, [[maybe_unused]] size_t& count, ParsedData<Ts...>*) {
+    ((entries[count++] = entry<Ts>()), ...);
+  }
 
-  // Handle )) at the end — include the first ) in the string
-  if (pos + 1 < input.size() && input[pos + 1] == ')')
-    ++pos;
+  // Calls `parse(view)` for the views in order, until one returns false
+  template <typename Parse>
+  void for_each_view(Parse&& parse) {
+    std::apply([&](auto&... view) { (parse(view) && ...); }, _views);
+  }
 
-  if (pos == input.size()) {
-    Logger::log(LogLevel::ERROR, "Missing ) '%.*s'", static_cast<int>(input.size()), input.data());
-    return std::nullopt;
+  // The result of a view that parsed the line itself. Only the result of the whole line is checked by DsmrParser::parse_line(),
+  // so characters after the value that a view took are reported here.
+  static std::optional<std::string_view> check_view_result(std::optional<std::string_view> rest, const ValueGroups& input) {
+    if (rest && rest->data() != input.rest().data() && !rest->empty())
+      return input.failure().set(ParseError::TrailingCharacters, rest->data());
+    return rest;
   }
 
-  auto len = pos - 1;
-  if (len < min || len > max) {
-    Logger::log(LogLevel::ERROR, "Invalid string length '%.*s'", static_cast<int>(input.size()), input.data());
-    return std::nullopt;
+  template <typename F>
+  static std::optional<std::string_view> parse_shared(ParsedDataViews& views, const ValueGroups& input) {
+    std::optional<std::string_view> res = input.rest();
+    const F* decoded = nullptr;
+    views.for_each_view([&]<typename View>(View& view) {
+      if constexpr (std::is_base_of_v<F, View>) {
+        auto& field = static_cast<F&>(view);
+        if (decoded != nullptr) {
+          field = *decoded;
+          return true;
+        }
+        if (field.present()) {
+          res = input.failure().set(ParseError::DuplicateField, input.rest().data());
+          return false;
+        }
+        field.present() = true;
+        res = parse_field_value(field, input);
+        decoded = &field;
+      } else if (!check_view_result(view.parse_line(views._id, input), input)) {
+        res = std::nullopt;
+      }
+      return res.has_value();
+    });
+    return res;
   }
 
-  out = input.substr(1, len);
-  return input.substr(pos + 1);
+public:
+  explicit ParsedDataViews(Views&... views) : _views(views...) {}
+
+  std::optional<std::string_view> parse_line(const ObisId& obis_id, const ValueGroups& input) {
+    static constexpr auto table = [] {
+      std::array<typename Table::Entry, kFields> entries{};
+      size_t count = 0;
+      (append(entries, count, static_cast<Views*>(nullptr)), ...);
+      return Table::create(entries);
+    }();
+    _id = obis_id;
+    const auto* entry = table.find(obis_id);
+    if (entry != nullptr)
+      return entry->parse(*this, input);
+
+    // Lines of no field in the table are offered to the line fields, e.g. mbus_devices, of each view
+    std::optional<std::string_view> res = input.rest();
+    if constexpr ((ParsedDataFields<Views>::line_fields || ...)) {
+      for_each_view([&]<typename View>(View& view) {
+        if constexpr (ParsedDataFields<View>::line_fields) {
+          const auto rest = check_view_result(view.parse_line(obis_id, input), input);
+          if (!rest || rest->data() != input.rest().data())
+            res = rest;
+        }
+        return res.has_value();
+      });
+    }
+    return res;
+  }
+};
+
+// A unit packed into one integer, so the unit of a value is checked with one compare. constexpr, so the fields pack their units at compile time.
+struct PackedUnit final {
+  const char* text = "";
+  uint64_t word = 0;    // the lowercase characters, the first one in the lowest byte
+  uint64_t letters = 0; // 0x20 in the bytes of letters, where the case of the input may differ
+  uint64_t mask = 0;    // 0xFF in the bytes of the unit
+  size_t length = 0;
+  bool packed = true; // false for units longer than 7 characters, they are only checked by the slow path
+
+  constexpr explicit PackedUnit(const char* unit) : text(unit) {
+    // The units of the fields are never null. GCC doesn't allow comparing their address with nullptr at compile time.
+    if (!std::is_constant_evaluated() && text == nullptr)
+      text = "";
+    for (; text[length] != 0; ++length) {
+      if (length == 7) {
+        packed = false;
+        return;
+      }
+      auto c = static_cast<uint8_t>(text[length]);
+      const bool letter = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+      if (letter)
+        c |= 0x20;
+      word |= uint64_t{c} << (8 * length);
+      letters |= uint64_t{letter ? 0x20u : 0u} << (8 * length);
+      mask |= uint64_t{0xFF} << (8 * length);
+    }
+  }
+};
+
+namespace swar {
+
+// Up to 8 bytes of `input` from `pos`, the first one in the lowest byte. Never reads outside of `input`, missing bytes are 0.
+inline uint64_t load(std::string_view input, size_t pos) {
+  uint64_t word = 0;
+  if (pos >= input.size())
+    return word;
+  if (pos + 8 <= input.size()) {
+    std::memcpy(&word, input.data() + pos, 8);
+  } else if (input.size() >= 8) {
+    std::memcpy(&word, input.data() + input.size() - 8, 8);
+    word >>= 8 * (pos + 8 - input.size());
+  } else {
+    std::memcpy(&word, input.data() + pos, input.size() - pos);
+  }
+  return word;
 }
 
-// Parse a numeric value in parentheses: ([-]digits[.decimals][*unit])
-inline std::optional<std::string_view> parse_num(int32_t& out, size_t max_decimals, const char* unit, std::string_view input, bool log_errors = true) {
-  if (input.empty() || input.front() != '(') {
-    if (log_errors)
-      Logger::log(LogLevel::ERROR, "Missing ( '%.*s'", static_cast<int>(input.size()), input.data());
+// The number of ASCII digits at the start of `word`
+inline size_t count_digits(uint64_t word) {
+  const uint64_t x = word ^ 0x3030303030303030ull;
+  // A byte is not a digit if its high nibble is set or its low nibble is over 9. No carry crosses a byte.
+  const uint64_t high = (x | ((x & 0x0F0F0F0F0F0F0F0Full) + 0x0606060606060606ull)) & 0xF0F0F0F0F0F0F0F0ull;
+  const uint64_t not_digits = ((high >> 4) + 0x7F7F7F7F7F7F7F7Full) & 0x8080808080808080ull;
+  return not_digits == 0 ? 8 : static_cast<size_t>(std::countr_zero(not_digits)) / 8;
+}
+
+// The value of the first `count` (1 to 8) digits of `word`
+inline uint32_t digits_value(uint64_t word, size_t count) {
+  // Move the digits to the top, the bytes below them become leading zeros
+  word = (word - 0x3030303030303030ull) << (8 * (8 - count));
+  word = (word * 10) + (word >> 8);
+  word = (((word & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) + (((word >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+  return static_cast<uint32_t>(word);
+}
+
+// Whether `unit` followed by ')' is at `pos`. Letters are compared case-insensitively.
+inline bool unit_matches(const PackedUnit& unit, std::string_view input, size_t pos) {
+  if (!unit.packed || pos + unit.length >= input.size() || input[pos + unit.length] != ')')
+    return false;
+  return (((load(input, pos) & unit.mask) ^ unit.word) & ~unit.letters) == 0;
+}
+
+}
+
+// Fast path of parse_num() and parse_float_or_int() for the common layouts of values, e.g. (000441.879*kWh), (00.100*kW) or (00004):
+// up to 9 digits, up to `max_decimals` decimals and the unit, or `int_unit` without decimals. The digits are converted 8 at a time.
+// Returns std::nullopt for anything else, without recording an error. The caller then uses the slow path, that reports the errors.
+inline std::optional<std::string_view> parse_fixed_width_num(int32_t& out, size_t max_decimals, const PackedUnit& unit, const PackedUnit* int_unit,
+                                                             std::string_view input) {
+  if constexpr (std::endian::native != std::endian::little) {
     return std::nullopt;
+  } else {
+    constexpr std::array<uint64_t, 10> kPowersOf10 = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    if (input.size() < 3 || input.front() != '(' || max_decimals >= kPowersOf10.size())
+      return std::nullopt;
+
+    const auto integer_word = swar::load(input, 1);
+    const auto integer_digits = swar::count_digits(integer_word);
+    if (integer_digits == 0)
+      return std::nullopt;
+    uint64_t value = swar::digits_value(integer_word, integer_digits);
+    size_t p = 1 + integer_digits;
+    // A 9th digit, for integer values like (000441879*Wh)
+    const auto is_digit = [&](size_t pos) { return pos < input.size() && input[pos] >= '0' && input[pos] <= '9'; };
+    if (integer_digits == 8 && is_digit(p)) {
+      value = value * 10 + static_cast<uint64_t>(input[p] - '0');
+      if (is_digit(++p))
+        return std::nullopt;
+    }
+
+    size_t decimals = 0;
+    if (p < input.size() && input[p] == '.') {
+      const auto fraction_word = swar::load(input, p + 1);
+      decimals = swar::count_digits(fraction_word);
+      if (decimals == 0 || decimals > max_decimals)
+        return std::nullopt;
+      value = value * kPowersOf10[decimals] + swar::digits_value(fraction_word, decimals);
+      p += 1 + decimals;
+    }
+    if (p >= input.size())
+      return std::nullopt;
+
+    // A value without unit is accepted if no unit is expected, or if it is 0 (workaround for some meters)
+    const bool has_unit = input[p] == '*';
+    if (!has_unit && input[p] != ')')
+      return std::nullopt;
+    const auto accepts = [&](const PackedUnit& expected) {
+      if (!has_unit)
+        return expected.length == 0 || value == 0;
+      return expected.length != 0 && swar::unit_matches(expected, input, p + 1);
+    };
+
+    size_t close = p;
+    if (accepts(unit)) {
+      value *= kPowersOf10[max_decimals - decimals];
+      if (has_unit)
+        close += 1 + unit.length;
+    } else if (int_unit != nullptr && decimals == 0 && accepts(*int_unit)) {
+      if (has_unit)
+        close += 1 + int_unit->length;
+    } else {
+      return std::nullopt;
+    }
+    if (value > static_cast<uint64_t>(INT32_MAX))
+      return std::nullopt;
+    out = static_cast<int32_t>(value);
+    return input.substr(close + 1);
   }
+}
+
+// Parse a numeric value in parentheses: ([-]digits[.decimals][*unit])
+inline std::optional<std::string_view> parse_num(int32_t& out, size_t max_decimals, const PackedUnit& unit, std::string_view input, ParseFailure& failure) {
+  if (const auto res = parse_fixed_width_num(out, max_decimals, unit, nullptr, input))
+    return res;
+
+  if (input.empty() || input.front() != '(')
+    return failure.set(ParseError::MissingOpenParenthesis, input.data());
 
   size_t p = 1;
   bool negative = (p < input.size() && input[p] == '-');
@@ -82,11 +530,8 @@ inline std::optional<std::string_view> parse_num(int32_t& out, size_t max_decima
   int32_t value = 0;
 
   while (p < input.size() && input[p] != '.' && input[p] != '*' && input[p] != ')') {
-    if (input[p] < '0' || input[p] > '9') {
-      if (log_errors)
-        Logger::log(LogLevel::ERROR, "Invalid number '%.*s'", static_cast<int>(input.size()), input.data());
-      return std::nullopt;
-    }
+    if (input[p] < '0' || input[p] > '9')
+      return failure.set(ParseError::InvalidNumber, input.data() + p);
     value = value * 10 + (input[p] - '0');
     ++p;
   }
@@ -95,11 +540,8 @@ inline std::optional<std::string_view> parse_num(int32_t& out, size_t max_decima
   if (remaining && p < input.size() && input[p] == '.') {
     ++p;
     while (p < input.size() && input[p] != '*' && input[p] != ')' && remaining) {
-      if (input[p] < '0' || input[p] > '9') {
-        if (log_errors)
-          Logger::log(LogLevel::ERROR, "Invalid number '%.*s'", static_cast<int>(input.size()), input.data());
-        return std::nullopt;
-      }
+      if (input[p] < '0' || input[p] > '9')
+        return failure.set(ParseError::InvalidNumber, input.data() + p);
       value = value * 10 + (input[p] - '0');
       --remaining;
       ++p;
@@ -109,182 +551,397 @@ inline std::optional<std::string_view> parse_num(int32_t& out, size_t max_decima
   while (remaining--)
     value *= 10;
 
-  if (unit && *unit) {
+  if (*unit.text) {
     // Value 0 allows missing unit (workaround for some meters)
     if (value == 0 && (p >= input.size() || (input[p] != '*' && input[p] != '.'))) {
       auto close = input.find(')', p);
       p = (close != std::string_view::npos) ? close : input.size();
     } else {
-      if (p >= input.size() || input[p] != '*') {
-        if (log_errors)
-          Logger::log(LogLevel::ERROR, "Missing unit '%.*s'", static_cast<int>(input.size()), input.data());
-        return std::nullopt;
-      }
+      if (p >= input.size() || input[p] != '*')
+        return failure.set(ParseError::MissingUnit, input.data() + p);
       ++p;
-      const char* u = unit;
+      const char* u = unit.text;
       while (p < input.size() && input[p] != ')' && *u) {
-        if (std::tolower(static_cast<unsigned char>(input[p])) != std::tolower(static_cast<unsigned char>(*u))) {
-          if (log_errors)
-            Logger::log(LogLevel::ERROR, "Invalid unit '%.*s'", static_cast<int>(input.size()), input.data());
-          return std::nullopt;
-        }
+        if (std::tolower(static_cast<unsigned char>(input[p])) != std::tolower(static_cast<unsigned char>(*u)))
+          return failure.set(ParseError::InvalidUnit, input.data() + p);
         ++p;
         ++u;
       }
-      if (*u) {
-        if (log_errors)
-          Logger::log(LogLevel::ERROR, "Invalid unit '%.*s'", static_cast<int>(input.size()), input.data());
-        return std::nullopt;
-      }
+      if (*u)
+        return failure.set(ParseError::InvalidUnit, input.data() + p);
     }
   }
 
-  if (p >= input.size() || input[p] != ')') {
-    if (log_errors)
-      Logger::log(LogLevel::ERROR, "Extra data '%.*s'", static_cast<int>(input.size()), input.data());
-    return std::nullopt;
-  }
+  if (p >= input.size() || input[p] != ')')
+    return failure.set(ParseError::ExtraData, input.data() + p);
 
   out = negative ? -value : value;
   return input.substr(p + 1);
 }
 
+inline std::optional<std::string_view> parse_num(int32_t& out, size_t max_decimals, const char* unit, std::string_view input, ParseFailure& failure) {
+  return parse_num(out, max_decimals, PackedUnit(unit), input, failure);
+}
+
+inline std::optional<std::string_view> parse_num(int32_t& out, size_t max_decimals, const char* unit, std::string_view input) {
+  ParseFailure failure;
+  return parse_num(out, max_decimals, unit, input, failure);
+}
+
+// The errors are not logged anymore. Pass a ParseFailure to get the reason, and format it with ParseResult if a message is needed.
+[[deprecated("Pass a ParseFailure instead of log_errors")]]
+inline std::optional<std::string_view> parse_num(int32_t& out, size_t max_decimals, const char* unit, std::string_view input, bool log_errors) {
+  ParseFailure failure;
+  const auto res = parse_num(out, max_decimals, unit, input, failure);
+  if (!res && log_errors)
+    DSMR_PARSER_LOG(LogLevel::ERROR, "%s '%.*s'", to_string(failure.error), static_cast<int>(input.size()), input.data());
+  return res;
+}
+
 // Try float unit first, fall back to integer unit
-inline std::optional<std::string_view> parse_float_or_int(int32_t& out, size_t max_decimals, const char* float_unit, const char* int_unit,
-                                                          std::string_view input) {
-  auto res = parse_num(out, max_decimals, float_unit, input, /*log_errors=*/false);
+// If both fail, the error of the one that got further is recorded
+inline std::optional<std::string_view> parse_float_or_int(int32_t& out, size_t max_decimals, const PackedUnit& float_unit, const PackedUnit& int_unit,
+                                                          std::string_view input, ParseFailure& failure) {
+  // Both units in one pass for the common layouts
+  if (const auto res = parse_fixed_width_num(out, max_decimals, float_unit, &int_unit, input))
+    return res;
+  ParseFailure float_failure;
+  auto res = parse_num(out, max_decimals, float_unit, input, float_failure);
   if (res)
     return res;
-  return parse_num(out, 0, int_unit, input);
+  res = parse_num(out, 0, int_unit, input, failure);
+  if (!res && float_failure.position > failure.position)
+    failure = float_failure;
+  return res;
 }
 
-// Parse OBIS identifier (a-b:c.d.e.f)
-inline std::optional<std::string_view> parse_obis(ObisId& id, std::string_view input) {
-  size_t pos = 0;
-  uint8_t part = 0;
-  while (pos < input.size()) {
-    char c = input[pos];
-    if (c >= '0' && c <= '9') {
-      auto digit = static_cast<uint8_t>(c - '0');
-      if (id.v[part] > 25 || (id.v[part] == 25 && digit > 5)) {
-        Logger::log(LogLevel::ERROR, "Obis ID has number over 255 '%.*s'", static_cast<int>(input.size()), input.data());
-        return std::nullopt;
-      }
-      id.v[part] = static_cast<uint8_t>(id.v[part] * 10 + digit);
-    } else if (part == 0 && c == '-') {
-      part++;
-    } else if (part == 1 && c == ':') {
-      part++;
-    } else if (part > 1 && part < 5 && c == '.') {
-      part++;
-    } else {
-      break;
-    }
-    ++pos;
-  }
+inline std::optional<std::string_view> parse_float_or_int(int32_t& out, size_t max_decimals, const char* float_unit, const char* int_unit,
+                                                          std::string_view input, ParseFailure& failure) {
+  return parse_float_or_int(out, max_decimals, PackedUnit(float_unit), PackedUnit(int_unit), input, failure);
+}
+
+inline std::optional<std::string_view> parse_float_or_int(int32_t& out, size_t max_decimals, const char* float_unit, const char* int_unit,
+                                                          std::string_view input) {
+  ParseFailure failure;
+  return parse_float_or_int(out, max_decimals, float_unit, int_unit, input, failure);
+}
+
+// The value of a line, recognised from its text without knowing the field. The views point into the telegram.
+struct ObisValue final {
+  enum class Kind : uint8_t {
+    Number,            // (digits[.decimals][*unit]), e.g. (000441.879*kWh)
+    String,            // any other single value, e.g. (4B384547303034303436333935353037)
+    TimestampedNumber, // a timestamp followed by a number, e.g. (150117180000W)(00473.789*m3)
+    Raw,               // anything else, e.g. profile buffers and the identification line
+  };
+
+  Kind kind = Kind::Raw;
+  int32_t number = 0;    // the digits without the decimal point, e.g. 441879 for 000441.879
+  uint8_t decimals = 0;  // the value is number / 10^decimals
+  std::string_view unit; // the unit in the telegram, e.g. "kWh". Empty if the number has none.
+  std::string_view text; // the string, the timestamp, or the whole value if it is raw
+};
 
-  if (pos == 0) {
-    Logger::log(LogLevel::ERROR, "OBIS id Empty '%.*s'", static_cast<int>(input.size()), input.data());
+// Parses a number with parse_num(), with the decimals and the unit that the value has.
+// Returns std::nullopt for values that aren't a number with up to 12 digits, 9 of them significant, and a unit of up to 7 characters.
+// Longer digit strings, e.g. equipment ids, are not numbers.
+inline std::optional<std::string_view> parse_detected_num(ObisValue& out, std::string_view input) {
+  if (input.empty() || input.front() != '(')
     return std::nullopt;
+  size_t p = 1;
+  if (p < input.size() && input[p] == '-')
+    ++p;
+
+  size_t significant = 0;
+  size_t total = 0;
+  const auto digits = [&] {
+    const size_t start = p;
+    for (; p < input.size() && input[p] >= '0' && input[p] <= '9'; ++p)
+      significant += significant > 0 || input[p] != '0';
+    total += p - start;
+    return p - start;
+  };
+  if (digits() == 0)
+    return std::nullopt;
+  size_t decimals = 0;
+  if (p < input.size() && input[p] == '.') {
+    ++p;
+    decimals = digits();
+    if (decimals == 0)
+      return std::nullopt;
   }
+  // Up to 9 significant digits always fit into the int32_t of parse_num()
+  if (significant > 9 || total > 12)
+    return std::nullopt;
 
-  for (++part; part < 6; ++part)
-    id.v[part] = 255;
+  std::string_view unit;
+  if (p < input.size() && input[p] == '*') {
+    const auto close = input.find(')', p);
+    if (close == std::string_view::npos || close == p + 1)
+      return std::nullopt;
+    unit = input.substr(p + 1, close - p - 1);
+  }
+  // PackedUnit needs a terminated string
+  std::array<char, 8> unit_text{};
+  if (unit.size() >= unit_text.size() || unit.find('(') != std::string_view::npos)
+    return std::nullopt;
+  std::copy(unit.begin(), unit.end(), unit_text.begin());
 
-  return input.substr(pos);
+  int32_t number;
+  ParseFailure failure;
+  const auto res = parse_num(number, decimals, PackedUnit(unit_text.data()), input, failure);
+  if (!res)
+    return std::nullopt;
+  out.number = number;
+  out.decimals = static_cast<uint8_t>(decimals);
+  out.unit = unit;
+  return res;
 }
 
-struct DsmrParser final {
-private:
-  template <typename Data>
-  static bool parse_line(Data& data, std::string_view input, bool unknown_error) {
-    if (input.empty())
-      return true;
+// Recognises the value of a line, e.g. "(000441.879*kWh)". Never fails, values that aren't recognised are raw.
+DSMR_PARSER_NOINLINE inline ObisValue decode_obis_value(std::string_view input) {
+  ObisValue value;
+  if (const auto rest = parse_detected_num(value, input); rest && rest->empty()) {
+    value.kind = ObisValue::Kind::Number;
+    return value;
+  }
 
-    ObisId id;
-    auto idres = parse_obis(id, input);
-    if (!idres)
-      return false;
+  ObisValue raw;
+  raw.text = input;
+  std::string_view text;
+  const auto rest = parse_string(text, 0, input.size(), input);
+  if (!rest)
+    return raw;
+  if (rest->empty()) {
+    ObisValue string;
+    string.kind = ObisValue::Kind::String;
+    string.text = text;
+    return string;
+  }
+  if (text.size() == 13 && (text[12] == 'S' || text[12] == 'W')) {
+    ObisValue timestamped;
+    if (const auto number_rest = parse_detected_num(timestamped, *rest); number_rest && number_rest->empty()) {
+      timestamped.kind = ObisValue::Kind::TimestampedNumber;
+      timestamped.text = text;
+      return timestamped;
+    }
+  }
+  return raw;
+}
 
-    auto datares = data.parse_line(id, *idres);
-    if (!datares)
-      return false;
+// The result of DsmrParser::validate(). Converts to true if the telegram is well formed.
+struct ValidationResult final {
+  ParseError error = ParseError::None;
+  uint32_t offset = 0;      // where the error was found, in bytes from the '/' at the start of the telegram
+  size_t lines = 0;         // the number of data lines, without the identification line
+  uint64_t fingerprint = 0; // WordHash of the telegram from '/' to '!', like LineCache uses to detect repeated telegrams
+
+  explicit operator bool() const { return error == ParseError::None; }
 
-    if ((*datares).data() != (*idres).data() && !(*datares).empty()) {
-      Logger::log(LogLevel::ERROR, "Trailing characters on data line '%.*s'", static_cast<int>(input.size()), input.data());
+  const char* message() const { return to_string(error); }
+};
+
+struct DsmrParser final {
+  // Parses one line produced by TelegramTokenizer into `data`.
+  // On failure the reason is recorded in `failure`. It is counted in `stats`, but not as a failed telegram.
+  template <typename Data>
+  static bool parse_line(Data& data, const TelegramLine& line, bool unknown_error, ParseFailure& failure, StatsHandle stats = {}) {
+    const auto datares = [&] {
+      if constexpr (requires(const ValueGroups& groups) { data.parse_line(line.id, groups); })
+        return data.parse_line(line.id, ValueGroups(line.value, failure));
+      else
+        return data.parse_line(line.id, line.value);
+    }();
+    if (!datares) {
+      // A custom field that fails without recording the reason leaves no error or an older one behind. It points outside of this line.
+      const auto position = reinterpret_cast<uintptr_t>(failure.position) - reinterpret_cast<uintptr_t>(line.value.data());
+      if (failure.position == nullptr || position > line.value.size())
+        failure.set(ParseError::InvalidValue, line.value.data());
+      switch (failure.error) {
+      case ParseError::DuplicateField:
+        stats.count(&ParserStats::duplicate_fields);
+        break;
+      case ParseError::TrailingCharacters: // found by ParsedDataViews in the value of one of the views
+        stats.count(&ParserStats::trailing_characters);
+        break;
+      default:
+        stats.count(&ParserStats::invalid_values);
+      }
       return false;
     }
-    if ((*datares).data() == (*idres).data() && unknown_error) {
-      Logger::log(LogLevel::ERROR, "Unknown field '%.*s'", static_cast<int>(input.size()), input.data());
+    if (line.identification)
+      return true;
+
+    if ((*datares).data() != line.value.data() && !(*datares).empty()) {
+      failure.set(ParseError::TrailingCharacters, (*datares).data());
+      stats.count(&ParserStats::trailing_characters);
       return false;
     }
+    if ((*datares).data() == line.value.data()) {
+      stats.count(&ParserStats::unknown_obis_ids);
+      if (unknown_error) {
+        failure.set(ParseError::UnknownField, line.text.data());
+        stats.count(&ParserStats::unknown_fields);
+        return false;
+      }
+    }
 
     return true;
   }
 
-public:
+  // Returns a ParseResult that converts to false if the telegram is rejected. Nothing is logged, use ParseResult::format() for a message.
+  // Counts the result in `stats` if DSMR_PARSER_STATS is enabled
   template <typename... Ts>
-  static bool parse(ParsedData<Ts...>& data, DsmrUnencryptedTelegram telegram, bool unknown_error = false) {
-    // Strip leading '/' and trailing '!'
-    auto input = telegram.content().substr(1, telegram.content().size() - 2);
-
-    size_t pos = 0;
-    size_t line_start = 0;
-
-    // Parse ID line
-    while (pos < input.size()) {
-      if (input[pos] == '\r' || input[pos] == '\n') {
-        auto res = data.parse_line(ObisId(255, 255, 255, 255, 255, 255), input.substr(line_start, pos - line_start));
-        if (!res)
-          return false;
-        line_start = ++pos;
-        break;
-      }
-      ++pos;
-    }
+  static ParseResult parse(ParsedData<Ts...>& data, DsmrUnencryptedTelegram telegram, bool unknown_error = false, ParserStats* stats = nullptr) {
+    return parse_lines(data, telegram, unknown_error, stats);
+  }
+
+  // Parses `telegram` into several ParsedData at once, e.g. one for each subsystem, like parse() does for each of them.
+  // The telegram is tokenized once. A field that is in several of them is decoded once and copied.
+  // With `unknown_error` a line that is in none of the views is an error.
+  template <typename... Views>
+  static ParseResult parse(DsmrUnencryptedTelegram telegram, bool unknown_error, ParserStats* stats, Views&... views) {
+    ParsedDataViews<Views...> target(views...);
+    return parse_lines(target, telegram, unknown_error, stats);
+  }
 
-    // Parse data lines — track brackets to handle multi-line values
-    // and double brackets like ((ER11))
-    bool open_bracket = false;
-    while (pos < input.size()) {
-      char c = input[pos];
-      char nc = (pos + 1 < input.size()) ? input[pos + 1] : '\0';
+  // Same as above with the defaults of parse()
+  template <typename... Views>
+    requires(sizeof...(Views) > 0 && (requires { ParsedDataFields<Views>::count; } && ...))
+  static ParseResult parse(DsmrUnencryptedTelegram telegram, Views&... views) {
+    return parse(telegram, false, nullptr, views...);
+  }
 
-      if ((c == '(' && nc == '(') || (c == ')' && nc == ')')) {
-        ++pos;
-        c = nc;
+  // Same as parse() for any `data` with the parse_line() method of ParsedData, e.g. the target of a SchemaParser
+  template <typename Data>
+  static ParseResult parse_lines(Data& data, DsmrUnencryptedTelegram telegram, bool unknown_error = false, ParserStats* stats = nullptr) {
+    const StatsHandle handle(stats);
+    TelegramTokenizer tokenizer(telegram);
+    ParseFailure failure;
+    while (const auto line = tokenizer.next()) {
+      if (!parse_line(data, *line, unknown_error, failure, handle)) {
+        handle.count(&ParserStats::parse_errors);
+        return failure.result(telegram.content(), line->id);
       }
+    }
+    if (tokenizer.failed()) {
+      handle.count(&ParserStats::invalid_lines);
+      handle.count(&ParserStats::parse_errors);
+      return tokenizer.failure().result(telegram.content());
+    }
+    handle.count(&ParserStats::parsed_telegrams);
+    return {};
+  }
 
-      if (c == '(') {
-        if (open_bracket) {
-          Logger::log(LogLevel::ERROR, "Unexpected '(' symbol");
-          return false;
-        }
-        open_bracket = true;
-      } else if (c == ')') {
-        if (!open_bracket) {
-          Logger::log(LogLevel::ERROR, "Unexpected ')' symbol");
-          return false;
-        }
-        open_bracket = false;
-      } else if (c == '\r' || c == '\n') {
-        bool continuation = open_bracket || ((input.size() - pos > 2) && (input[pos + 1] == '(' || input[pos + 2] == '('));
-        if (!continuation) {
-          if (!parse_line(data, input.substr(line_start, pos - line_start), unknown_error))
-            return false;
-          line_start = pos + 1;
-        }
+  // Calls `visitor(id, value)` for every line of the telegram in order, with the ObisValue decoded from the line, without a ParsedData.
+  // The identification line comes first, as a raw value with the id of the identification field. Nothing is stored.
+  // Returns a ParseResult that converts to false if the telegram can't be split into lines. The lines before the error were visited.
+  template <typename Visitor>
+  static ParseResult visit(DsmrUnencryptedTelegram telegram, Visitor&& visitor, ParserStats* stats = nullptr) {
+    const StatsHandle handle(stats);
+    TelegramTokenizer tokenizer(telegram);
+    while (const auto line = tokenizer.next()) {
+      if (line->identification) {
+        ObisValue value;
+        value.text = line->value;
+        visitor(line->id, value);
+      } else {
+        visitor(line->id, decode_obis_value(line->value));
       }
+    }
+    if (tokenizer.failed()) {
+      handle.count(&ParserStats::invalid_lines);
+      handle.count(&ParserStats::parse_errors);
+      return tokenizer.failure().result(telegram.content());
+    }
+    handle.count(&ParserStats::parsed_telegrams);
+    return {};
+  }
 
-      ++pos;
+  // Checks that `telegram` is well formed without decoding any value: the brackets, the OBIS ids and the line endings.
+  // Every line ends with CRLF and every data line is an OBIS id followed by one or more groups in brackets.
+  // For gateways that forward telegrams without using their values.
+  static ValidationResult validate(DsmrUnencryptedTelegram telegram, ParserStats* stats = nullptr) {
+    const StatsHandle handle(stats);
+    const auto content = telegram.content();
+    if (content.size() < 2 || content.front() != '/' || content.back() != '!') {
+      handle.count(&ParserStats::invalid_lines);
+      handle.count(&ParserStats::parse_errors);
+      return {ParseError::InvalidFrame};
     }
 
-    if (pos != line_start) {
-      Logger::log(LogLevel::ERROR, "Last dataline not CRLF terminated");
-      return false;
+    const auto invalid = [&](const ParseFailure& failure) {
+      handle.count(&ParserStats::invalid_lines);
+      handle.count(&ParserStats::parse_errors);
+      const auto error = failure.result(content);
+      return ValidationResult{error.error, error.offset};
+    };
+    ParseFailure failure;
+
+    // One pass over the telegram: the tokenizer checks the line endings with the brackets and the hash takes the lines it returned
+    ValidationResult result;
+    WordHash::Stream fingerprint(content);
+    TelegramTokenizer tokenizer(telegram, true);
+    while (const auto line = tokenizer.next()) {
+      fingerprint.update(static_cast<size_t>(line->text.data() + line->text.size() - content.data()));
+      if (line->identification)
+        continue;
+      // The OBIS id ends at the first '(', a value that doesn't start with it has characters that are not part of the id
+      const auto value = line->value;
+      if (value.empty() || value.front() != '(') {
+        failure.set(ParseError::MissingOpenParenthesis, value.data());
+        return invalid(failure);
+      }
+      if (value.back() != ')') {
+        failure.set(ParseError::TrailingCharacters, value.data() + value.find_last_of(')') + 1);
+        return invalid(failure);
+      }
+      ++result.lines;
     }
+    if (tokenizer.failed())
+      return invalid(tokenizer.failure());
+    result.fingerprint = fingerprint.finish();
+    handle.count(&ParserStats::parsed_telegrams);
+    return result;
+  }
 
-    return true;
+  // Same as validate() for a telegram as it was received, with the CRC after the '!', e.g. "/...!1E1D\r\n".
+  // The CRC is 4 hex digits, optionally followed by a line ending, like PacketAccumulator accepts it.
+  static ValidationResult validate(std::string_view packet, ParserStats* stats = nullptr) {
+    const auto end = packet.find('!');
+    if (end == std::string_view::npos || packet.front() != '/')
+      return validate(DsmrUnencryptedTelegram(packet.substr(0, end)), stats);
+
+    auto crc_text = packet.substr(end + 1);
+    if (crc_text.ends_with("\r\n"))
+      crc_text.remove_suffix(2);
+    uint16_t crc = 0;
+    bool valid = crc_text.size() == 4;
+    for (size_t i = 0; valid && i < crc_text.size(); ++i) {
+      const char c = crc_text[i];
+      const int nibble = c >= '0' && c <= '9' ? c - '0' : c >= 'A' && c <= 'F' ? c - 'A' + 10 : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+      valid = nibble >= 0;
+      crc = static_cast<uint16_t>(crc << 4 | nibble);
+    }
+    const auto telegram = packet.substr(0, end + 1);
+    if (!valid || crc != Crc16::calculate(telegram)) {
+      StatsHandle(stats).count(&ParserStats::crc_errors);
+      return {ParseError::InvalidCrc, static_cast<uint32_t>(end + 1)};
+    }
+    return validate(DsmrUnencryptedTelegram(telegram), stats);
+  }
+
+  // Parses many telegrams into consecutive rows of `columns`, usually a ColumnarData.
+  // Stops when `columns` is full. Returns the number of telegrams that were consumed, including the ones that failed to parse.
+  template <typename Columns>
+  static size_t parse_batch(Columns& columns, std::span<const DsmrUnencryptedTelegram> telegrams, bool unknown_error = false, ParserStats* stats = nullptr) {
+    size_t count = 0;
+    for (; count < telegrams.size() && columns.size() < columns.capacity(); ++count) {
+      typename Columns::Data data;
+      const bool valid = static_cast<bool>(parse(data, telegrams[count], unknown_error, stats));
+      columns.append(data, valid);
+    }
+    return count;
   }
 };
 }
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "fields.h"
+#include "parse_error.h"
+#include "parser.h"
+#include "stats.h"
+#include "util.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace dsmr_parser {
+
+// How the value of a SchemaField is parsed and what is written to the destination struct.
+// The kinds match the field templates in fields.h.
+enum class FieldKind : uint8_t {
+  Raw,              // std::string_view with the whole value, like RawField
+  String,           // std::string_view between min_length and max_length characters, like StringField and TimestampField
+  Fixed,            // FixedValue, like FixedField
+  TimestampedFixed, // FixedValue and the timestamp as std::string_view at timestamp_offset, like TimestampedFixedField
+  LastFixed,        // FixedValue, like LastFixedField
+  AveragedFixed,    // FixedValue, like AveragedFixedField
+  Int,              // an unsigned integer of int_size bytes, like IntField. Larger values are truncated like in IntField.
+};
+
+// One field of a runtime schema. The value is written at `offset` in the destination struct and the bool at `present_offset` is set.
+// Use offsetof() for the offsets, so the destination struct must be standard-layout. That is why TimestampedFixed writes
+// the timestamp separately instead of a TimestampedFixedValue. A schema is usually a constexpr array of the values returned by the functions below.
+struct SchemaField final {
+  ObisId id;
+  FieldKind kind = FieldKind::Raw;
+  uint16_t min_length = 0; // String
+  uint16_t max_length = 0; // String
+  const char* unit = "";     // Fixed kinds: the unit of the value with decimals. Int: the unit of the value.
+  const char* int_unit = ""; // Fixed kinds: the unit of the integer form, e.g. "Wh" for "kWh"
+  size_t offset = 0;
+  size_t present_offset = 0;
+  size_t timestamp_offset = 0;          // TimestampedFixed
+  uint8_t int_size = sizeof(uint32_t); // Int: the size of the integer, 1, 2 or 4 bytes
+
+  static constexpr SchemaField raw(const ObisId& id, size_t offset, size_t present_offset) {
+    return {id, FieldKind::Raw, 0, 0, "", "", offset, present_offset, 0};
+  }
+  static constexpr SchemaField string(const ObisId& id, uint16_t min_length, uint16_t max_length, size_t offset, size_t present_offset) {
+    return {id, FieldKind::String, min_length, max_length, "", "", offset, present_offset, 0};
+  }
+  static constexpr SchemaField timestamp(const ObisId& id, size_t offset, size_t present_offset) { return string(id, 13, 13, offset, present_offset); }
+  // `kind` is Fixed, LastFixed or AveragedFixed
+  static constexpr SchemaField fixed(FieldKind kind, const ObisId& id, const char* unit, const char* int_unit, size_t offset, size_t present_offset) {
+    return {id, kind, 0, 0, unit, int_unit, offset, present_offset, 0};
+  }
+  static constexpr SchemaField timestamped_fixed(const ObisId& id, const char* unit, const char* int_unit, size_t offset, size_t present_offset,
+                                                 size_t timestamp_offset) {
+    return {id, FieldKind::TimestampedFixed, 0, 0, unit, int_unit, offset, present_offset, timestamp_offset};
+  }
+  static constexpr SchemaField integer(const ObisId& id, const char* unit, size_t offset, size_t present_offset, uint8_t int_size = sizeof(uint32_t)) {
+    return {id, FieldKind::Int, 0, 0, unit, "", offset, present_offset, 0, int_size};
+  }
+
+  // The size of the value in the destination struct
+  constexpr size_t value_size() const {
+    switch (kind) {
+    case FieldKind::Raw:
+    case FieldKind::String:
+      return sizeof(std::string_view);
+    case FieldKind::Fixed:
+    case FieldKind::TimestampedFixed:
+    case FieldKind::LastFixed:
+    case FieldKind::AveragedFixed:
+      return sizeof(FixedValue);
+    case FieldKind::Int:
+      return int_size;
+    }
+    return 0;
+  }
+};
+
+// Parses telegrams into a struct described by a schema that is chosen at runtime, e.g. from the configuration of the device.
+// compile() builds an open addressing hash table over the OBIS ids of the schema, like the one ParsedData builds at compile time.
+// The same non-template code parses every schema, so one firmware can support many meter configurations without an instantiation of
+// ParsedData for each of them. The table is stored in a buffer provided by the caller, use slot_count() for its size.
+// The units of the fields are packed by compile() into a second buffer of the caller, with one Units for each field,
+// so they are not packed again for every line.
+// The schema must outlive the parser. Fields with the same OBIS id are resolved in favor of the first one, like in ParsedData.
+class SchemaParser final {
+public:
+  // The packed units of one field
+  struct Units final {
+    PackedUnit unit{""};
+    PackedUnit int_unit{""};
+  };
+
+private:
+  std::span<uint16_t> _slots; // index into _fields + 1. 0 = empty slot
+  std::span<Units> _units;    // the units of _fields[i] in _units[i]
+  std::span<const SchemaField> _fields;
+  size_t _slot_mask = 0;
+  int _shift = 64;
+  uint64_t _multiplier = 0;
+  size_t _max_probe = 0;
+
+  size_t slot_of(uint64_t key, uint64_t multiplier) const { return (key * multiplier) >> _shift; }
+
+  static std::optional<std::string_view> parse_value(const SchemaField& field, const Units& units, std::byte* values, const ValueGroups& input) {
+    auto* value = values + field.offset;
+    switch (field.kind) {
+    case FieldKind::Raw:
+      *reinterpret_cast<std::string_view*>(value) = input.rest();
+      return std::string_view{};
+    case FieldKind::String:
+      return parse_string_value(*reinterpret_cast<std::string_view*>(value), field.min_length, field.max_length, input);
+    case FieldKind::Fixed:
+      return parse_fixed_value(reinterpret_cast<FixedValue*>(value)->_value, units.unit, units.int_unit, input.rest(), input.failure());
+    case FieldKind::TimestampedFixed:
+      return parse_timestamped_fixed_value(*reinterpret_cast<std::string_view*>(values + field.timestamp_offset), reinterpret_cast<FixedValue*>(value)->_value,
+                                           units.unit, units.int_unit, input);
+    case FieldKind::LastFixed: {
+      const auto last = find_last_value(input);
+      if (!last)
+        return std::nullopt;
+      return parse_fixed_value(reinterpret_cast<FixedValue*>(value)->_value, units.unit, units.int_unit, *last, input.failure());
+    }
+    case FieldKind::AveragedFixed:
+      return parse_average(reinterpret_cast<FixedValue*>(value)->_value, units.unit, units.int_unit, input);
+    case FieldKind::Int: {
+      int32_t val;
+      auto res = parse_int_value(val, units.unit, input.rest(), input.failure());
+      if (!res)
+        return res;
+      if (field.int_size == sizeof(uint8_t))
+        *reinterpret_cast<uint8_t*>(value) = static_cast<uint8_t>(val);
+      else if (field.int_size == sizeof(uint16_t))
+        *reinterpret_cast<uint16_t*>(value) = static_cast<uint16_t>(val);
+      else
+        *reinterpret_cast<uint32_t*>(value) = static_cast<uint32_t>(val);
+      return res;
+    }
+    }
+    return input.failure().set(ParseError::InvalidValue, input.rest().data());
+  }
+
+  // The destination of one telegram with the parse_line() method of ParsedData, for DsmrParser::parse_lines()
+  struct Target final {
+    const SchemaParser& parser;
+    std::byte* values;
+
+    std::optional<std::string_view> parse_line(const ObisId& obis_id, const ValueGroups& input) {
+      const auto* field = parser.find_field(obis_id);
+      if (field == nullptr)
+        return input.rest();
+      auto& present = *reinterpret_cast<bool*>(values + field->present_offset);
+      if (present)
+        return input.failure().set(ParseError::DuplicateField, input.rest().data());
+      present = true;
+      return parse_value(*field, parser._units[static_cast<size_t>(field - parser._fields.data())], values, input);
+    }
+  };
+
+public:
+  static constexpr size_t kMaxFields = 65535;
+
+  // The size of the buffer for a schema with `field_count` fields
+  static constexpr size_t slot_count(size_t field_count) { return std::bit_ceil(field_count * 2 + 2); }
+
+  // `units` holds one Units for each field of the schemas that are compiled
+  SchemaParser(std::span<uint16_t> slots, std::span<Units> units) : _slots(slots), _units(units) {}
+
+  // Builds the lookup table for `fields`, that describe a struct of `values_size` bytes, and packs their units.
+  // Returns false if the table or the units don't fit into the buffers or a field is invalid. The error is logged.
+  bool compile(std::span<const SchemaField> fields, size_t values_size) {
+    _fields = {};
+    const auto slot_count = SchemaParser::slot_count(fields.size());
+    if (fields.size() > kMaxFields || _slots.size() < slot_count) {
+      DSMR_PARSER_LOG(LogLevel::ERROR, "The schema has too many fields. The buffer can hold %zu slots, %zu are needed", _slots.size(), slot_count);
+      return false;
+    }
+    if (_units.size() < fields.size()) {
+      DSMR_PARSER_LOG(LogLevel::ERROR, "The schema has too many fields. The buffer can hold the units of %zu fields, %zu are needed", _units.size(),
+                      fields.size());
+      return false;
+    }
+    for (const auto& field : fields) {
+      if (field.kind == FieldKind::Int && field.int_size != 1 && field.int_size != 2 && field.int_size != 4) {
+        DSMR_PARSER_LOG(LogLevel::ERROR, "An integer field of the schema has %u bytes, only 1, 2 and 4 are supported", unsigned{field.int_size});
+        return false;
+      }
+      const bool timestamp_outside = field.kind == FieldKind::TimestampedFixed && field.timestamp_offset + sizeof(std::string_view) > values_size;
+      if (field.offset + field.value_size() > values_size || field.present_offset + sizeof(bool) > values_size || timestamp_outside) {
+        DSMR_PARSER_LOG(LogLevel::ERROR, "A field of the schema is outside of the struct of %zu bytes", values_size);
+        return false;
+      }
+    }
+
+    for (size_t i = 0; i < fields.size(); ++i)
+      _units[i] = Units{PackedUnit(fields[i].unit), PackedUnit(fields[i].int_unit)};
+    _fields = fields;
+    _slot_mask = slot_count - 1;
+    _shift = 64 - std::countr_zero(slot_count);
+
+    // The same table as in ParsedData, the multiplier is chosen once per schema
+    const auto key_of = [this](size_t i) { return _fields[i].id.key(); };
+    _multiplier = choose_obis_multiplier([this, slot_count, key_of](uint64_t multiplier) {
+      _max_probe = build_obis_slots(_slots.first(slot_count), _fields.size(), key_of, multiplier);
+      return _max_probe;
+    });
+    return true;
+  }
+
+  // The field of the compiled schema with `obis_id`, or nullptr
+  const SchemaField* find_field(const ObisId& obis_id) const {
+    if (_fields.empty())
+      return nullptr;
+    const auto key = obis_id.key();
+    size_t slot = slot_of(key, _multiplier);
+    for (size_t probe = 0; probe <= _max_probe; ++probe) {
+      const auto index = _slots[slot];
+      if (index == 0)
+        return nullptr;
+      const auto& field = _fields[index - 1u];
+      if (field.id.key() == key)
+        return &field;
+      slot = (slot + 1) & _slot_mask;
+    }
+    return nullptr;
+  }
+
+  // Parses `telegram` into `values`, that points to a struct of the size passed to compile(). All its present flags must be false.
+  // The result and the stats are the same as with DsmrParser::parse().
+  ParseResult parse(void* values, DsmrUnencryptedTelegram telegram, bool unknown_error = false, ParserStats* stats = nullptr) const {
+    Target target{*this, static_cast<std::byte*>(values)};
+    return DsmrParser::parse_lines(target, telegram, unknown_error, stats);
+  }
+};
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Set DSMR_PARSER_STATS to 1 to count what happens to every byte and telegram in ParserStats.
+// With the default 0 the counting code and the stats pointers are compiled out.
+// The value must be the same in all translation units of a program.
+#ifndef DSMR_PARSER_STATS
+#define DSMR_PARSER_STATS 0
+#endif
+
+// MSVC ignores [[no_unique_address]] and only honours its own spelling of the attribute
+#if defined(_MSC_VER)
+#define DSMR_PARSER_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define DSMR_PARSER_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+namespace dsmr_parser {
+
+inline constexpr bool kStatsEnabled = DSMR_PARSER_STATS != 0;
+
+// A counter that is incremented by one thread and can be read by any thread.
+// The increment is a plain load, add and store, without a locked instruction. 32 bits to stay lock-free on 32 bit MCUs.
+class StatsCounter final {
+  std::atomic<uint32_t> _value{0};
+
+public:
+  void increment() { add(1); }
+  void add(const uint32_t n) { _value.store(_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+  uint32_t value() const { return _value.load(std::memory_order_relaxed); }
+  void reset() { _value.store(0, std::memory_order_relaxed); }
+};
+
+// Counters for every accept and reject path of PacketAccumulator, DlmsPacketDecryptor and DsmrParser.
+// Pass the same object to all of them to see where telegrams are lost.
+// Only one thread may update an object, e.g. the one that reads the P1 port. Any thread can read it at any time.
+// The counters are read one by one, so they can be slightly out of sync with each other.
+struct ParserStats final {
+  // PacketAccumulator
+  StatsCounter bytes;            // bytes passed to process_byte()
+  StatsCounter telegrams;        // complete telegrams with a correct CRC, or without CRC check
+  StatsCounter crc_errors;       // CRC mismatch or a non-hex character in the CRC
+  StatsCounter buffer_overflows; // telegrams that didn't fit into the buffer
+
+  // DlmsPacketDecryptor
+  StatsCounter dlms_packets;         // packets passed to decrypt_inplace()
+  StatsCounter invalid_dlms_packets; // wrong length or header, or the decrypted content is not a telegram
+  StatsCounter decryption_errors;    // the decryption or the authentication failed
+
+  // DsmrParser
+  StatsCounter parsed_telegrams;    // telegrams parsed without errors
+  StatsCounter parse_errors;        // telegrams that failed to parse. The sum of the reasons below
+  StatsCounter invalid_lines;       // malformed OBIS id, unbalanced parentheses or missing line ending
+  StatsCounter invalid_values;      // the value doesn't match the format of the field: number, unit, string length
+  StatsCounter duplicate_fields;    // a field occurs twice in the telegram
+  StatsCounter trailing_characters; // characters after the value of a field
+  StatsCounter unknown_fields;      // unknown OBIS id with unknown_error set
+  StatsCounter unknown_obis_ids;    // lines with an OBIS id that is not in the ParsedData, rejected or not
+
+  void reset() {
+    for (auto* counter : {&bytes, &telegrams, &crc_errors, &buffer_overflows, &dlms_packets, &invalid_dlms_packets, &decryption_errors, &parsed_telegrams,
+                          &parse_errors, &invalid_lines, &invalid_values, &duplicate_fields, &trailing_characters, &unknown_fields, &unknown_obis_ids})
+      counter->reset();
+  }
+
+  // Adds the reasons and unknown_obis_ids counted in `staged` to this object
+  void add_line_counters(const ParserStats& staged) {
+    for (auto counter : {&ParserStats::invalid_lines, &ParserStats::invalid_values, &ParserStats::duplicate_fields, &ParserStats::trailing_characters,
+                         &ParserStats::unknown_fields, &ParserStats::unknown_obis_ids})
+      (this->*counter).add((staged.*counter).value());
+  }
+};
+
+// The optional ParserStats of a component. Empty if the stats are disabled, so it costs no memory as a DSMR_PARSER_NO_UNIQUE_ADDRESS member.
+class StatsHandle final {
+#if DSMR_PARSER_STATS
+  ParserStats* _stats = nullptr;
+#endif
+
+public:
+  StatsHandle() = default;
+  StatsHandle(ParserStats* stats) {
+#if DSMR_PARSER_STATS
+    _stats = stats;
+#else
+    (void)stats;
+#endif
+  }
+
+  void count([[maybe_unused]] StatsCounter ParserStats::*counter) const {
+#if DSMR_PARSER_STATS
+    if (_stats != nullptr)
+      (_stats->*counter).increment();
+#endif
+  }
+
+  void add_line_counters([[maybe_unused]] const ParserStats& staged) const {
+#if DSMR_PARSER_STATS
+    if (_stats != nullptr)
+      _stats->add_line_counters(staged);
+#endif
+  }
+};
+
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "packet_accumulator.h"
+#include "parse_error.h"
+#include "parser.h"
+#include "stats.h"
+#include "tokenizer.h"
+#include "util.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace dsmr_parser {
+
+// Receives a telegram byte by byte like PacketAccumulator and parses every line as soon as it is complete,
+// instead of parsing the whole telegram after the last byte arrived.
+// The values are staged in a separate ParsedData and become visible in data() only when the telegram is complete, its CRC is correct
+// and all its lines were parsed without errors. Otherwise the staged values are discarded when the next telegram starts.
+// The result is the same as PacketAccumulator followed by DsmrParser::parse. Keeps two instances of ParsedData<Ts...>.
+// Like with DsmrParser::parse, string values point into the buffer, so they are valid only until the next telegram starts.
+//
+// Whether a line continues on the next physical line is known only 2 bytes after its line ending,
+// so a line is parsed 2 bytes after it was received.
+template <typename... Ts>
+class StreamingParser final {
+  PacketAccumulator _accumulator;
+  std::array<ParsedData<Ts...>, 2> _data{};
+  size_t _committed = 0; // index of the committed data in _data. The other one is staged.
+  bool _unknown_error;
+  DSMR_PARSER_NO_UNIQUE_ADDRESS StatsHandle _stats;
+#if DSMR_PARSER_STATS
+  ParserStats _line_stats; // the lines of the current telegram are counted here and added to _stats when the telegram is delivered
+#endif
+  ParseResult _error;
+
+  // Line splitting state. All positions are in the packet, that starts with '/'.
+  bool _receiving = false;
+  bool _failed = false;
+  bool _identification_done = false;
+  bool _open_bracket = false;
+  bool _skip_next = false; // the next character is the second bracket of '((' or '))'
+  size_t _pos = 0;         // the next character to look at
+  size_t _line_start = 0;
+  size_t _value_start = std::string_view::npos;
+
+  ParsedData<Ts...>& staged() { return _data[1 - _committed]; }
+
+  StatsHandle line_stats() {
+#if DSMR_PARSER_STATS
+    return &_line_stats;
+#else
+    return {};
+#endif
+  }
+
+  void start_telegram() {
+    staged() = ParsedData<Ts...>{};
+#if DSMR_PARSER_STATS
+    _line_stats.reset();
+#endif
+    _receiving = true;
+    _failed = false;
+    _error = {};
+    _identification_done = false;
+    _open_bracket = false;
+    _skip_next = false;
+    _pos = 1;
+    _line_start = 1;
+    _value_start = std::string_view::npos;
+  }
+
+  // Takes the reason from `failure`
+  void fail(std::string_view packet, const ParseFailure& failure, const ObisId& id = ObisId()) {
+    _failed = true;
+    _receiving = false;
+    _error = failure.result(packet, id);
+  }
+
+  void parse_line(std::string_view packet, const TelegramLine& line) {
+    ParseFailure failure;
+    if (!DsmrParser::parse_line(staged(), line, _unknown_error, failure, line_stats()))
+      fail(packet, failure, line.id);
+  }
+
+  void fail_invalid_line(std::string_view packet, const ParseFailure& failure) {
+    line_stats().count(&ParserStats::invalid_lines);
+    fail(packet, failure);
+  }
+
+  void fail_invalid_line(std::string_view packet, const ParseError error, const size_t pos) {
+    ParseFailure failure;
+    failure.set(error, packet.data() + pos);
+    fail_invalid_line(packet, failure);
+  }
+
+  // Looks at the characters of `packet` up to `end`. The same rules as in TelegramTokenizer::next() apply.
+  // `telegram_end` is the position of '!', or npos if the telegram is not complete yet. Then at least 2 characters after `end` are available.
+  void split_lines(std::string_view packet, size_t end, size_t telegram_end) {
+    for (; _pos < end && !_failed; ++_pos) {
+      const char c = packet[_pos];
+
+      if (!_identification_done) {
+        if (c == '\r' || c == '\n') {
+          _identification_done = true;
+          parse_line(packet, TelegramTokenizer::identification_line(packet.substr(1, _pos - 1)));
+          _line_start = _pos + 1;
+        }
+        continue;
+      }
+
+      if (_skip_next) {
+        _skip_next = false;
+        continue;
+      }
+
+      if (c == '(' || c == ')') {
+        _skip_next = _pos + 1 < telegram_end && packet[_pos + 1] == c;
+        if (c == '(') {
+          if (_open_bracket)
+            return fail_invalid_line(packet, ParseError::UnexpectedOpenParenthesis, _pos);
+          _open_bracket = true;
+          if (_value_start == std::string_view::npos)
+            _value_start = _pos;
+        } else {
+          if (!_open_bracket)
+            return fail_invalid_line(packet, ParseError::UnexpectedCloseParenthesis, _pos);
+          _open_bracket = false;
+        }
+      } else if (c == '\r' || c == '\n') {
+        bool continuation = _open_bracket || (_pos + 2 < telegram_end && (packet[_pos + 1] == '(' || packet[_pos + 2] == '('));
+        if (continuation)
+          continue;
+
+        const auto text = packet.substr(_line_start, _pos - _line_start);
+        const auto id_length = _value_start == std::string_view::npos ? text.size() : _value_start - _line_start;
+        _line_start = _pos + 1;
+        _value_start = std::string_view::npos;
+        if (text.empty())
+          continue;
+
+        ParseFailure failure;
+        const auto line = TelegramTokenizer::data_line(text, id_length, failure);
+        if (!line)
+          return fail_invalid_line(packet, failure);
+        parse_line(packet, *line);
+      }
+    }
+  }
+
+  void process_new_byte(std::string_view packet) {
+    if (packet.back() != '!') {
+      if (packet.size() > 2)
+        split_lines(packet, packet.size() - 2, std::string_view::npos);
+      return;
+    }
+
+    const auto telegram_end = packet.size() - 1;
+    split_lines(packet, telegram_end, telegram_end);
+    if (_failed)
+      return;
+    _receiving = false;
+    if (_line_start != telegram_end)
+      fail_invalid_line(packet, ParseError::LastLineNotTerminated, _line_start);
+  }
+
+public:
+  StreamingParser(std::span<uint8_t> buffer, bool check_crc, bool unknown_error = false) : _accumulator(buffer, check_crc), _unknown_error(unknown_error) {}
+
+  // Counts the bytes, telegrams and errors in `stats` if DSMR_PARSER_STATS is enabled. nullptr to stop counting.
+  // The lines are parsed before the CRC is known, so their counters are kept aside and added with parse_errors or parsed_telegrams
+  // when the telegram is complete. Like with DsmrParser::parse, nothing is counted for the lines of a telegram with a wrong CRC.
+  void set_stats(ParserStats* stats) {
+    _accumulator.set_stats(stats);
+    _stats = stats;
+  }
+
+  // Returns the telegram when it is received and parsed successfully. The parsed values are available in data() then.
+  std::optional<DsmrUnencryptedTelegram> process_byte(const uint8_t byte) {
+    const auto telegram = _accumulator.process_byte(byte);
+    const auto packet = _accumulator.packet();
+
+    if (byte == '/') {
+      start_telegram();
+      return std::nullopt;
+    }
+
+    if (_receiving) {
+      if (packet.size() < _pos) {
+        // The accumulator discarded the telegram because of a buffer overflow
+        _receiving = false;
+        return std::nullopt;
+      }
+      process_new_byte(packet);
+    }
+
+    if (!telegram)
+      return std::nullopt;
+#if DSMR_PARSER_STATS
+    _stats.add_line_counters(_line_stats);
+#endif
+    if (_failed) {
+      _stats.count(&ParserStats::parse_errors);
+      return std::nullopt;
+    }
+    _stats.count(&ParserStats::parsed_telegrams);
+
+    _committed = 1 - _committed;
+    return telegram;
+  }
+
+  // Why the current or the last telegram was rejected by the parser. Converts to true if it had no parse error so far.
+  // CRC errors and buffer overflows are not parse errors. The offset is from the '/' at the start of the telegram.
+  const ParseResult& error() const { return _error; }
+
+  // The values of the last telegram that was received and parsed successfully.
+  const ParsedData<Ts...>& data() const { return _data[_committed]; }
+};
+
+}
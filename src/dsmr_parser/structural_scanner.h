@@ -0,0 +1,144 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DSMR_PARSER_STRUCTURAL_SCANNER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DSMR_PARSER_STRUCTURAL_SCANNER_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define DSMR_PARSER_STRUCTURAL_SCANNER_NEON
+#endif
+
+namespace dsmr_parser {
+
+// Finds the structural characters of a telegram: '(', ')', '\r' and '\n'.
+// The input is processed in blocks of 64 bytes, like stage 1 of simdjson. For every block a 64-bit mask of the
+// structural characters is computed with AVX2, SSE2 or NEON instructions, or with a portable SWAR loop on other platforms.
+// The positions are then taken from the mask one by one, so the parser never looks at the bytes in between.
+class StructuralScanner final {
+public:
+  static constexpr size_t kBlockSize = 64;
+  static constexpr size_t npos = std::string_view::npos;
+
+  explicit StructuralScanner(std::string_view input) : _input(input) { _mask = _input.empty() ? 0 : block_mask(0); }
+
+  // Returns the position of the next structural character or npos if there are no more.
+  size_t next() {
+    while (_mask == 0) {
+      _block_start += kBlockSize;
+      if (_block_start >= _input.size())
+        return npos;
+      _mask = block_mask(_block_start);
+    }
+    const auto bit = static_cast<size_t>(std::countr_zero(_mask));
+    _mask &= _mask - 1;
+    return _block_start + bit;
+  }
+
+  // Bit i of the result is set if block[i] is a structural character. The block must be kBlockSize bytes long.
+  static uint64_t structural_mask(const char* block) {
+#if defined(DSMR_PARSER_STRUCTURAL_SCANNER_AVX2)
+    const auto parenthesis = _mm256_set1_epi8(')');
+    const auto cr = _mm256_set1_epi8('\r');
+    const auto lf = _mm256_set1_epi8('\n');
+    const auto one = _mm256_set1_epi8(1);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < kBlockSize; i += 32) {
+      const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+      // '(' | 1 == ')'
+      const auto m = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_or_si256(chunk, one), parenthesis),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(chunk, cr), _mm256_cmpeq_epi8(chunk, lf)));
+      mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(m))) << i;
+    }
+    return mask;
+#elif defined(DSMR_PARSER_STRUCTURAL_SCANNER_SSE2)
+    const auto parenthesis = _mm_set1_epi8(')');
+    const auto cr = _mm_set1_epi8('\r');
+    const auto lf = _mm_set1_epi8('\n');
+    const auto one = _mm_set1_epi8(1);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < kBlockSize; i += 16) {
+      const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+      // '(' | 1 == ')'
+      const auto m = _mm_or_si128(_mm_cmpeq_epi8(_mm_or_si128(chunk, one), parenthesis), _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+      mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(m))) << i;
+    }
+    return mask;
+#elif defined(DSMR_PARSER_STRUCTURAL_SCANNER_NEON)
+    const auto parenthesis = vdupq_n_u8(')');
+    const auto cr = vdupq_n_u8('\r');
+    const auto lf = vdupq_n_u8('\n');
+    const auto one = vdupq_n_u8(1);
+    uint8x16_t m[4];
+    for (size_t i = 0; i < 4; ++i) {
+      const auto chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(block + i * 16));
+      // '(' | 1 == ')'
+      m[i] = vorrq_u8(vceqq_u8(vorrq_u8(chunk, one), parenthesis), vorrq_u8(vceqq_u8(chunk, cr), vceqq_u8(chunk, lf)));
+    }
+    // NEON has no movemask instruction. Keep one bit per byte and add the neighbours together until 64 bits are left.
+    static constexpr uint8_t kBits[16] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+    const auto bits = vld1q_u8(kBits);
+    auto sum0 = vpaddq_u8(vandq_u8(m[0], bits), vandq_u8(m[1], bits));
+    const auto sum1 = vpaddq_u8(vandq_u8(m[2], bits), vandq_u8(m[3], bits));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+#else
+    return structural_mask_scalar(block);
+#endif
+  }
+
+  // Portable implementation of structural_mask(). Processes 8 bytes at a time on little-endian platforms.
+  static uint64_t structural_mask_scalar(const char* block) {
+    uint64_t mask = 0;
+    if constexpr (std::endian::native == std::endian::little) {
+      for (size_t i = 0; i < kBlockSize; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, block + i, sizeof(word));
+        // '(' | 1 == ')'
+        const auto matches = bytes_equal_to(word | 0x0101010101010101ull, ')') | bytes_equal_to(word, '\r') | bytes_equal_to(word, '\n');
+        // Gather the high bit of every byte into the lowest 8 bits
+        mask |= (((matches >> 7) * 0x0102040810204080ull) >> 56) << i;
+      }
+    } else {
+      for (size_t i = 0; i < kBlockSize; ++i) {
+        const char c = block[i];
+        if (c == '(' || c == ')' || c == '\r' || c == '\n')
+          mask |= uint64_t{1} << i;
+      }
+    }
+    return mask;
+  }
+
+private:
+  std::string_view _input;
+  size_t _block_start = 0;
+  uint64_t _mask = 0;
+
+  // Sets the high bit of every byte of `word` that is equal to `c`. Exact, no false positives.
+  static uint64_t bytes_equal_to(uint64_t word, char c) {
+    constexpr uint64_t kLow7Bits = 0x7F7F7F7F7F7F7F7Full;
+    const uint64_t x = word ^ (0x0101010101010101ull * static_cast<uint8_t>(c));
+    return ~(((x & kLow7Bits) + kLow7Bits) | x | kLow7Bits);
+  }
+
+  uint64_t block_mask(size_t start) const {
+    if (_input.size() - start >= kBlockSize)
+      return structural_mask(_input.data() + start);
+
+    // The last block is copied to a zero-padded buffer to not read past the end of the input
+    char block[kBlockSize] = {};
+    std::memcpy(block, _input.data() + start, _input.size() - start);
+    return structural_mask(block);
+  }
+};
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "parse_error.h"
+#include "tokenizer.h"
+#include "util.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace dsmr_parser {
+
+// Copies telegrams without the lines that nobody downstream uses, e.g. to forward them over a slow link.
+// The identification line and the lines with an OBIS id in the allow-list are kept. The copy ends with '!' and a new CRC
+// in the format that PacketAccumulator checks: 4 hex digits and "\r\n". The telegram is read once and nothing is allocated.
+class TelegramFilter final {
+  std::span<const ObisId> _keep;
+
+  // Appends to the output and updates the CRC of what was appended
+  struct Writer final {
+    std::span<char> out;
+    size_t size = 0;
+    uint16_t crc = 0;
+    bool overflow = false;
+
+    void write(std::string_view text, bool checked = true) {
+      if (text.empty() || overflow)
+        return;
+      if (out.size() - size < text.size()) {
+        overflow = true;
+        return;
+      }
+      std::memcpy(out.data() + size, text.data(), text.size());
+      size += text.size();
+      if (checked)
+        crc = Crc16::calculate(text, crc);
+    }
+  };
+
+  // `text` with the line endings and empty lines that follow it in `content`, as they were received
+  static std::string_view with_line_endings(std::string_view content, std::string_view text) {
+    const auto start = static_cast<size_t>(text.data() - content.data());
+    size_t end = start + text.size();
+    while (end < content.size() && (content[end] == '\r' || content[end] == '\n'))
+      ++end;
+    return content.substr(start, end - start);
+  }
+
+public:
+  // `keep` must outlive the filter. It is searched linearly for every line, which is meant for the few ids that are forwarded.
+  explicit TelegramFilter(std::span<const ObisId> keep) : _keep(keep) {}
+
+  // Writes the filtered copy of `telegram` to `out` and returns it.
+  // Returns std::nullopt if the telegram can't be split into lines, with the reason in `error` if given, or if `out` is too small.
+  // The kept lines are copied with their original line endings, so the copy is at most 6 bytes longer than the telegram,
+  // for the CRC and its line ending.
+  std::optional<std::string_view> filter(DsmrUnencryptedTelegram telegram, std::span<char> out, ParseResult* error = nullptr) const {
+    Writer writer{out};
+    const auto content = telegram.content();
+    TelegramTokenizer tokenizer(telegram);
+    while (const auto line = tokenizer.next()) {
+      if (line->identification) {
+        writer.write("/");
+        writer.write(with_line_endings(content, line->text));
+      } else if (std::find(_keep.begin(), _keep.end(), line->id) != _keep.end()) {
+        writer.write(with_line_endings(content, line->text));
+      }
+    }
+    if (tokenizer.failed()) {
+      if (error != nullptr)
+        *error = tokenizer.failure().result(telegram.content());
+      return std::nullopt;
+    }
+
+    writer.write("!");
+    constexpr char kHex[] = "0123456789ABCDEF";
+    const char crc[] = {kHex[writer.crc >> 12], kHex[(writer.crc >> 8) & 0xF], kHex[(writer.crc >> 4) & 0xF], kHex[writer.crc & 0xF], '\r', '\n'};
+    writer.write(std::string_view(crc, sizeof(crc)), false);
+    if (writer.overflow)
+      return std::nullopt;
+    return std::string_view(out.data(), writer.size);
+  }
+};
+
+}
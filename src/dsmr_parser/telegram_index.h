@@ -0,0 +1,166 @@
+#pragma once
+
+#include "parser.h"
+#include "tokenizer.h"
+#include "util.h"
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace dsmr_parser {
+
+// The lines of a telegram with their OBIS ids. Built with one pass over the telegram, no values are decoded.
+// The lines are stored in a buffer provided by the caller. The first line is the identification line.
+class TelegramIndex final {
+  std::span<TelegramLine> _buffer;
+  size_t _size = 0;
+  ParseResult _error;
+
+public:
+  explicit TelegramIndex(std::span<TelegramLine> buffer) : _buffer(buffer) {}
+
+  // Returns false if the telegram is malformed or has more lines than fit into the buffer.
+  // The reason of a malformed telegram is in error(). Too many lines are logged.
+  bool build(DsmrUnencryptedTelegram telegram) {
+    _size = 0;
+    _error = {};
+    TelegramTokenizer tokenizer(telegram);
+    while (const auto line = tokenizer.next()) {
+      if (_size == _buffer.size()) {
+        DSMR_PARSER_LOG(LogLevel::ERROR, "Too many lines in the telegram. The index can hold %zu lines", _buffer.size());
+        _size = 0;
+        return false;
+      }
+      _buffer[_size++] = *line;
+    }
+    if (tokenizer.failed()) {
+      _size = 0;
+      _error = tokenizer.failure().result(telegram.content());
+      return false;
+    }
+    return true;
+  }
+
+  // Why the last build() found the telegram malformed. The offset is from the '/' at the start of the telegram.
+  const ParseResult& error() const { return _error; }
+
+  // Returns the first line with the given OBIS id or nullptr if there is none.
+  const TelegramLine* find(const ObisId& id) const {
+    for (const auto& line : lines()) {
+      if (line.id == id)
+        return &line;
+    }
+    return nullptr;
+  }
+
+  std::span<const TelegramLine> lines() const { return _buffer.first(_size); }
+};
+
+// Gives access to the fields of a telegram like ParsedData, but decodes a field only when it is accessed for the first time.
+// The decoded value is cached. The first access finds the lines of all fields with the same ObisDispatchTable as ParsedData,
+// in one pass over the index that stops when every field has its line. Fields that are never accessed cost only that lookup.
+// The index must outlive this object and must not be rebuilt while it is in use.
+template <typename... Ts>
+class LazyParsedData final : Ts... {
+  static_assert(!(is_line_field<Ts> || ...), "Fields with a parse_line() method, e.g. mbus_devices, are only supported by ParsedData");
+
+  const TelegramIndex& _index;
+  std::array<const TelegramLine*, sizeof...(Ts)> _lines{};
+  std::array<bool, sizeof...(Ts)> _decoded{};
+  bool _found = false;
+  ParseFailure _failure;
+
+  // Only the keys are used, the entries are in the order of Ts
+  using Table = ObisDispatchTable<LazyParsedData, sizeof...(Ts)>;
+
+  template <typename F>
+  static constexpr size_t field_index() {
+    constexpr bool matches[] = {std::is_same_v<F, Ts>...};
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+      if (matches[i])
+        return i;
+    }
+    return sizeof...(Ts);
+  }
+
+  static constexpr std::array<uint64_t, sizeof...(Ts)> kKeys = {Ts::id.key()...};
+
+  // Fields with the same OBIS id share the line of the first one, the table only has its entry
+  static constexpr size_t line_index_of(uint64_t key) {
+    for (size_t i = 0; i < kKeys.size(); ++i) {
+      if (kKeys[i] == key)
+        return i;
+    }
+    return kKeys.size();
+  }
+
+  static constexpr size_t kLineCount = [] {
+    size_t count = 0;
+    for (size_t i = 0; i < kKeys.size(); ++i) {
+      if (line_index_of(kKeys[i]) == i)
+        ++count;
+    }
+    return count;
+  }();
+
+  // Takes the first line of every field, like TelegramIndex::find()
+  void find_lines() {
+    static constexpr auto table = Table::create({typename Table::Entry{Ts::id.key(), nullptr}...});
+    _found = true;
+    size_t missing = kLineCount;
+    for (const auto& line : _index.lines()) {
+      const auto* entry = table.find(line.id);
+      if (entry == nullptr)
+        continue;
+      auto& slot = _lines[static_cast<size_t>(entry - table.entries.data())];
+      if (slot != nullptr)
+        continue;
+      slot = &line;
+      if (--missing == 0)
+        return;
+    }
+  }
+
+  template <typename F>
+  void decode() {
+    auto& field = static_cast<F&>(*this);
+    if (!_found)
+      find_lines();
+    const auto* line = _lines[line_index_of(F::id.key())];
+    if (line == nullptr)
+      return;
+
+    const auto rest = parse_field_value(field, ValueGroups(line->value, _failure));
+    if (!rest)
+      return;
+    if (!line->identification && !rest->empty()) {
+      _failure.set(ParseError::TrailingCharacters, rest->data());
+      return;
+    }
+    field.present() = true;
+  }
+
+public:
+  explicit LazyParsedData(const TelegramIndex& index) : _index(index) {}
+
+  // Returns the value of field F, or nullptr if the telegram doesn't have it or it can't be parsed.
+  template <typename F>
+  auto get() -> const std::remove_reference_t<decltype(std::declval<F&>().val())>* {
+    constexpr auto index = field_index<F>();
+    static_assert(index < sizeof...(Ts), "The field is not a template argument of this LazyParsedData");
+    auto& field = static_cast<F&>(*this);
+    if (!_decoded[index]) {
+      _decoded[index] = true;
+      decode<F>();
+    }
+    return field.present() ? &field.val() : nullptr;
+  }
+
+  // Why the last field that failed to decode was rejected. Its position points into the telegram of the index.
+  const ParseFailure& failure() const { return _failure; }
+};
+
+}
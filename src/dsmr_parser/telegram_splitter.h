@@ -0,0 +1,90 @@
+#pragma once
+
+#include "util.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace dsmr_parser {
+
+// Finds the telegrams in a buffer that holds many of them, like a capture of the P1 port.
+// Follows the same rules as PacketAccumulator: a telegram starts with '/' and ends with '!', followed by 4 hex digits of CRC if check_crc is set.
+// Every '/' starts a new telegram. The result points into the buffer, nothing is copied.
+class TelegramSplitter final {
+  std::string_view _data;
+  size_t _pos = 0;
+  bool _check_crc;
+
+  static std::optional<uint8_t> hex_digit(char c) {
+    if (c >= '0' && c <= '9')
+      return static_cast<uint8_t>(c - '0');
+    if (c >= 'A' && c <= 'F')
+      return static_cast<uint8_t>(c - 'A' + 10);
+    if (c >= 'a' && c <= 'f')
+      return static_cast<uint8_t>(c - 'a' + 10);
+    return std::nullopt;
+  }
+
+public:
+  TelegramSplitter(std::string_view data, bool check_crc) : _data(data), _check_crc(check_crc) {}
+
+  // Returns the next telegram with a correct CRC or std::nullopt if there are no more complete telegrams in the buffer.
+  std::optional<DsmrUnencryptedTelegram> next() {
+    while (true) {
+      const auto start = _data.find('/', _pos);
+      const auto end = start == std::string_view::npos ? std::string_view::npos : _data.find('!', start + 1);
+      if (end == std::string_view::npos) {
+        _pos = _data.size();
+        return std::nullopt;
+      }
+
+      // Another '/' before the '!' restarts the telegram
+      const auto restart = _data.substr(start + 1, end - start - 1).rfind('/');
+      if (restart != std::string_view::npos) {
+        _pos = start + 1 + restart;
+        continue;
+      }
+
+      const auto telegram = _data.substr(start, end - start + 1);
+      _pos = end + 1;
+      if (!_check_crc)
+        return DsmrUnencryptedTelegram(telegram);
+
+      if (_data.size() - _pos < 4) {
+        _pos = _data.size();
+        return std::nullopt;
+      }
+
+      uint16_t crc = 0;
+      bool crc_valid = true;
+      for (size_t i = 0; i < 4; ++i) {
+        const char c = _data[_pos];
+        if (c == '/') {
+          crc_valid = false;
+          break;
+        }
+        const auto digit = hex_digit(c);
+        ++_pos;
+        if (!digit) {
+          DSMR_PARSER_LOG(LogLevel::DEBUG, "Incorrect CRC character '%c'", c);
+          crc_valid = false;
+          break;
+        }
+        crc = static_cast<uint16_t>((crc << 4) | *digit);
+      }
+      if (!crc_valid)
+        continue;
+
+      const auto calculated_crc = Crc16::calculate(telegram);
+      if (crc == calculated_crc)
+        return DsmrUnencryptedTelegram(telegram);
+      DSMR_PARSER_LOG(LogLevel::DEBUG, "CRC mismatch: expected %04X, got %04X", crc, calculated_crc);
+    }
+  }
+
+  // Offset in the buffer where the search for the next telegram starts
+  size_t position() const { return _pos; }
+};
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace dsmr_parser {
+
+// A timestamp of the telegram in YYMMDDhhmmssX format, decoded. X is S for summertime (DST) and W for wintertime.
+// Meters send their local time. `local_seconds` is the number of seconds from 1970-01-01 00:00:00 to that local time,
+// so it is the Unix time of a meter in UTC. unix_seconds() converts it for meters in other time zones.
+struct Timestamp final {
+  int64_t local_seconds = 0;
+  bool summer_time = false;
+
+  // The Unix time, for a meter whose wintertime is `standard_offset` seconds ahead of UTC, e.g. 3600 for CET
+  int64_t unix_seconds(int32_t standard_offset) const { return local_seconds - standard_offset - (summer_time ? 3600 : 0); }
+
+  bool operator==(const Timestamp&) const = default;
+};
+
+// Decodes timestamps. The date (YYMMDD) of the last decoded timestamp is cached,
+// so the calendar is only computed again when the day changes. Years are 2000 to 2099.
+class TimestampDecoder final {
+  uint64_t _date = 0; // the YYMMDD characters of the cached date, 0 if there is none
+  int64_t _date_seconds = 0;
+
+  // The value of 2 digits, or -1
+  static int two_digits(const char* text) {
+    const auto tens = text[0] - '0';
+    const auto ones = text[1] - '0';
+    if (tens < 0 || tens > 9 || ones < 0 || ones > 9)
+      return -1;
+    return tens * 10 + ones;
+  }
+
+  // Days from 1970-01-01 to the date, with the algorithm of Howard Hinnant's days_from_civil
+  static int64_t days_from_civil(int year, int month, int day) {
+    year -= month <= 2;
+    const int era = year / 400;
+    const int year_of_era = year - era * 400;
+    const int day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return int64_t{era} * 146097 + day_of_era - 719468;
+  }
+
+  static std::optional<int64_t> date_seconds(const char* text) {
+    const int year = two_digits(text);
+    const int month = two_digits(text + 2);
+    const int day = two_digits(text + 4);
+    if (year < 0 || month < 1 || month > 12 || day < 1)
+      return std::nullopt;
+    constexpr int kDaysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    // Every year from 2000 to 2099 that is divisible by 4 is a leap year
+    if (day > kDaysInMonth[month - 1] + (month == 2 && year % 4 == 0))
+      return std::nullopt;
+    return days_from_civil(2000 + year, month, day) * 86400;
+  }
+
+public:
+  // std::nullopt if `text` is not a valid timestamp
+  std::optional<Timestamp> decode(std::string_view text) {
+    if (text.size() != 13 || (text[12] != 'S' && text[12] != 'W'))
+      return std::nullopt;
+
+    uint64_t date = 0;
+    std::memcpy(&date, text.data(), 6);
+    if (date != _date) {
+      const auto seconds = date_seconds(text.data());
+      if (!seconds)
+        return std::nullopt;
+      _date = date;
+      _date_seconds = *seconds;
+    }
+
+    const int hours = two_digits(text.data() + 6);
+    const int minutes = two_digits(text.data() + 8);
+    const int seconds = two_digits(text.data() + 10);
+    if (hours < 0 || hours > 23 || minutes < 0 || minutes > 59 || seconds < 0 || seconds > 59)
+      return std::nullopt;
+    return Timestamp{_date_seconds + hours * 3600 + minutes * 60 + seconds, text[12] == 'S'};
+  }
+
+  // Decodes a column of timestamps, e.g. the timestamps of ColumnarData, into `out`.
+  // Only the first min(texts.size(), out.size()) timestamps are decoded. Invalid timestamps become std::nullopt.
+  // Returns the number of valid timestamps.
+  size_t decode(std::span<const std::string_view> texts, std::span<std::optional<Timestamp>> out) {
+    const size_t count = std::min(texts.size(), out.size());
+    size_t valid = 0;
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = decode(texts[i]);
+      valid += out[i].has_value();
+    }
+    return valid;
+  }
+
+  // Forgets the cached date
+  void reset() { _date = 0; }
+};
+
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "parse_error.h"
+#include "structural_scanner.h"
+#include "util.h"
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace dsmr_parser {
+
+// Parse OBIS identifier (a-b:c.d.e.f)
+inline std::optional<std::string_view> parse_obis(ObisId& id, std::string_view input, ParseFailure& failure) {
+  size_t pos = 0;
+  uint8_t part = 0;
+  while (pos < input.size()) {
+    char c = input[pos];
+    if (c >= '0' && c <= '9') {
+      auto digit = static_cast<uint8_t>(c - '0');
+      if (id.v[part] > 25 || (id.v[part] == 25 && digit > 5))
+        return failure.set(ParseError::ObisNumberOver255, input.data() + pos);
+      id.v[part] = static_cast<uint8_t>(id.v[part] * 10 + digit);
+    } else if (part == 0 && c == '-') {
+      part++;
+    } else if (part == 1 && c == ':') {
+      part++;
+    } else if (part > 1 && part < 5 && c == '.') {
+      part++;
+    } else {
+      break;
+    }
+    ++pos;
+  }
+
+  if (pos == 0)
+    return failure.set(ParseError::EmptyObisId, input.data());
+
+  for (++part; part < 6; ++part)
+    id.v[part] = 255;
+
+  return input.substr(pos);
+}
+
+inline std::optional<std::string_view> parse_obis(ObisId& id, std::string_view input) {
+  ParseFailure failure;
+  return parse_obis(id, input, failure);
+}
+
+// Decodes an OBIS identifier that spans the whole input. Accepts exactly what parse_obis() accepts, but does not record the error
+// and returns false for anything else, including trailing characters. Used on the hot path where the end of the id is already known.
+inline bool decode_obis(ObisId& id, std::string_view input) {
+  if (input.empty())
+    return false;
+
+  constexpr char kSeparators[] = {'-', ':', '.', '.', '.'};
+  id = ObisId(0, 0, 0, 0, 0, 0);
+  size_t part = 0;
+  unsigned value = 0;
+  for (const char c : input) {
+    const auto digit = static_cast<unsigned>(static_cast<unsigned char>(c) - '0');
+    if (digit < 10) {
+      value = value * 10 + digit;
+      if (value > 255)
+        return false;
+      continue;
+    }
+    if (part == 5 || c != kSeparators[part])
+      return false;
+    id.v[part++] = static_cast<uint8_t>(value);
+    value = 0;
+  }
+  id.v[part] = static_cast<uint8_t>(value);
+  for (++part; part < 6; ++part)
+    id.v[part] = 255;
+  return true;
+}
+
+// One logical line of a telegram. A line can span several physical lines, if a value is broken with CRLF.
+struct TelegramLine final {
+  ObisId id;
+  std::string_view text;  // the whole line without the line ending
+  std::string_view value; // everything after the OBIS id
+  bool identification;    // the first line of the telegram. Its `id` is 255-255:255.255.255.255 and `value` is the whole line.
+};
+
+// Splits a telegram into lines and decodes the OBIS id of every data line.
+// The telegram is walked once. StructuralScanner provides the positions of brackets and line endings,
+// the first '(' of each line marks the end of its OBIS id, so the id is decoded without searching for its end.
+// Empty lines are skipped.
+class TelegramTokenizer final {
+  std::string_view _input;
+  StructuralScanner _scanner;
+  size_t _pos;
+  size_t _line_start = 0;
+  size_t _value_start = StructuralScanner::npos;
+  bool _identification_done = false;
+  bool _open_bracket = false;
+  bool _failed = false;
+  bool _crlf_only;
+  ParseFailure _failure;
+
+  std::optional<TelegramLine> fail(const ParseError error, const size_t pos) {
+    _failure.set(error, _input.data() + pos);
+    return fail();
+  }
+
+  std::optional<TelegramLine> fail() {
+    _failed = true;
+    return std::nullopt;
+  }
+
+  // Whether the CR or LF at `pos` is part of a CRLF
+  bool is_crlf(size_t pos) const { return _input[pos] == '\r' ? pos + 1 < _input.size() && _input[pos + 1] == '\n' : pos > 0 && _input[pos - 1] == '\r'; }
+
+public:
+  // Either CR or LF ends a line. With `crlf_only` a CR or LF that is not part of a CRLF is an error, found on the same pass over the brackets.
+  explicit TelegramTokenizer(DsmrUnencryptedTelegram telegram, bool crlf_only = false)
+      // Strip leading '/' and trailing '!'
+      : _input(telegram.content().substr(1, telegram.content().size() - 2)), _scanner(_input), _pos(_scanner.next()), _crlf_only(crlf_only) {}
+
+  // Builds a data line from its text. `id_length` is the length of the OBIS id, that is the position of the first '('.
+  // Returns std::nullopt if the OBIS id is invalid. The error is recorded in `failure`.
+  static std::optional<TelegramLine> data_line(std::string_view text, size_t id_length, ParseFailure& failure) {
+    TelegramLine line{ObisId(), text, {}, false};
+    if (decode_obis(line.id, text.substr(0, id_length))) {
+      line.value = text.substr(id_length);
+      return line;
+    }
+
+    // Not a plain OBIS id. parse_obis() decides how much of it is valid and records the errors.
+    line.id = ObisId();
+    const auto rest = parse_obis(line.id, text, failure);
+    if (!rest)
+      return std::nullopt;
+    line.value = *rest;
+    return line;
+  }
+
+  static TelegramLine identification_line(std::string_view text) { return TelegramLine{ObisId(255, 255, 255, 255, 255, 255), text, text, true}; }
+
+  // Returns the next line or std::nullopt at the end of the telegram or on error. Use failed() to tell them apart.
+  // The reason of an error is in failure().
+  std::optional<TelegramLine> next() {
+    if (!_identification_done) {
+      _identification_done = true;
+      for (; _pos != StructuralScanner::npos; _pos = _scanner.next()) {
+        if (_input[_pos] == '\r' || _input[_pos] == '\n') {
+          if (_crlf_only && !is_crlf(_pos))
+            return fail(ParseError::InvalidLineEnding, _pos);
+          const auto text = _input.substr(0, _pos);
+          _line_start = _pos + 1;
+          _pos = _scanner.next();
+          return identification_line(text);
+        }
+      }
+    }
+
+    // Track brackets to handle multi-line values and double brackets like ((ER11)).
+    // The state is kept in local variables in the loop and written back when a line is returned.
+    auto scanner = _scanner;
+    auto pos = _pos;
+    auto line_start = _line_start;
+    auto value_start = _value_start;
+    auto open_bracket = _open_bracket;
+    for (; pos != StructuralScanner::npos; pos = scanner.next()) {
+      const char c = _input[pos];
+
+      const bool double_bracket = (c == '(' || c == ')') && pos + 1 < _input.size() && _input[pos + 1] == c;
+      if (double_bracket) {
+        // The second bracket is a structural character too. Consume it.
+        scanner.next();
+      }
+
+      if (c == '(') {
+        if (open_bracket)
+          return fail(ParseError::UnexpectedOpenParenthesis, pos);
+        open_bracket = true;
+        if (value_start == StructuralScanner::npos)
+          value_start = pos;
+      } else if (c == ')') {
+        if (!open_bracket)
+          return fail(ParseError::UnexpectedCloseParenthesis, pos);
+        open_bracket = false;
+      } else {
+        if (_crlf_only && !is_crlf(pos))
+          return fail(ParseError::InvalidLineEnding, pos);
+        bool continuation = open_bracket || ((_input.size() - pos > 2) && (_input[pos + 1] == '(' || _input[pos + 2] == '('));
+        if (continuation)
+          continue;
+
+        const auto text = _input.substr(line_start, pos - line_start);
+        const auto id_length = value_start == StructuralScanner::npos ? text.size() : value_start - line_start;
+        line_start = pos + 1;
+        value_start = StructuralScanner::npos;
+        // The LF of a CRLF would only end an empty line. Consume it, unless the line after it is a continuation for the LF.
+        if (c == '\r' && _input.size() - pos > 1 && _input[pos + 1] == '\n' && !(_input.size() - pos > 3 && _input[pos + 3] == '(')) {
+          scanner.next();
+          ++line_start;
+        }
+        if (text.empty())
+          continue;
+
+        _pos = scanner.next();
+        _scanner = scanner;
+        _line_start = line_start;
+        _value_start = value_start;
+        _open_bracket = open_bracket;
+        auto line = data_line(text, id_length, _failure);
+        if (!line)
+          return fail();
+        return line;
+      }
+    }
+
+    _pos = pos;
+    _line_start = line_start;
+    if (_input.size() != line_start)
+      return fail(ParseError::LastLineNotTerminated, line_start);
+    return std::nullopt;
+  }
+
+  bool failed() const { return _failed; }
+
+  // The reason and the position of the error, if failed()
+  const ParseFailure& failure() const { return _failure; }
+};
+
+}
@@ -1,15 +1,26 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdarg>
 #include <cstdint>
-#include <functional>
+#include <cstring>
 #include <optional>
 #include <string_view>
 #if defined(_MSC_VER)
 #include <sal.h>
 #endif
 
+// Set DSMR_PARSER_CRC16_SLICING to 1 to compute the CRC 4 bytes per step with 2 KB more of tables, or to 0 for one table lookup per byte.
+// The default is 0 on ESP, where the tables would take flash and cache for a CRC that is computed once per telegram.
+#ifndef DSMR_PARSER_CRC16_SLICING
+#if defined(ESP_PLATFORM) || defined(ARDUINO)
+#define DSMR_PARSER_CRC16_SLICING 0
+#else
+#define DSMR_PARSER_CRC16_SLICING 1
+#endif
+#endif
+
 namespace dsmr_parser {
 
 class NonCopyable {
@@ -43,6 +54,14 @@ struct ObisId final {
       : v{a, b, c, d, e, f} {};
   ObisId() = default;
   bool operator==(const ObisId&) const = default;
+
+  // All six value groups packed into one integer. Used as a lookup key.
+  constexpr uint64_t key() const noexcept {
+    uint64_t k = 0;
+    for (const auto part : v)
+      k = (k << 8) | part;
+    return k;
+  }
 };
 
 // Represents an unencrypted DSMR telegram that starts with '/' and ends with '!' without CRC at the end.
@@ -59,6 +78,136 @@ public:
   std::string_view content() const { return data; }
 };
 
+// CRC16/ARC (polynomial 0xA001 reflected, initial value 0) used to protect DSMR telegrams.
+// The CRC covers everything from '/' to '!' inclusive.
+class Crc16 final {
+  static constexpr std::array<uint16_t, 256> kTable = [] {
+    std::array<uint16_t, 256> table{};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+      auto crc = static_cast<uint16_t>(i);
+      for (std::size_t bit = 0; bit < 8; bit++) {
+        if (crc & 1)
+          crc = (crc >> 1) ^ 0xa001;
+        else
+          crc = (crc >> 1);
+      }
+      table[i] = crc;
+    }
+    return table;
+  }();
+
+#if DSMR_PARSER_CRC16_SLICING
+  // Slicing-by-4: kSlices[k][b] is the CRC of byte b followed by k zero bytes, so 4 bytes are folded in with independent lookups
+  static constexpr std::array<std::array<uint16_t, 256>, 4> kSlices = [] {
+    std::array<std::array<uint16_t, 256>, 4> slices{};
+    slices[0] = kTable;
+    for (std::size_t k = 1; k < slices.size(); ++k) {
+      for (std::size_t i = 0; i < 256; ++i)
+        slices[k][i] = static_cast<uint16_t>((slices[k - 1][i] >> 8) ^ kTable[slices[k - 1][i] & 0xFF]);
+    }
+    return slices;
+  }();
+#endif
+
+public:
+  static constexpr uint16_t update(uint16_t crc, uint8_t byte) { return static_cast<uint16_t>((crc >> 8) ^ kTable[(crc ^ byte) & 0xFF]); }
+
+  // The CRC of a whole buffer, 4 bytes per step with DSMR_PARSER_CRC16_SLICING. The same result as update() for every byte.
+  // Pass the CRC of the preceding bytes as `crc` to continue it.
+  static constexpr uint16_t calculate(std::string_view data, uint16_t crc = 0) {
+    size_t i = 0;
+#if DSMR_PARSER_CRC16_SLICING
+    for (; i + 4 <= data.size(); i += 4) {
+      const auto b0 = static_cast<uint8_t>(static_cast<uint8_t>(data[i]) ^ crc);
+      const auto b1 = static_cast<uint8_t>(static_cast<uint8_t>(data[i + 1]) ^ (crc >> 8));
+      const auto b2 = static_cast<uint8_t>(data[i + 2]);
+      const auto b3 = static_cast<uint8_t>(data[i + 3]);
+      crc = static_cast<uint16_t>(kSlices[3][b0] ^ kSlices[2][b1] ^ kSlices[1][b2] ^ kSlices[0][b3]);
+    }
+#endif
+    for (; i < data.size(); ++i)
+      crc = update(crc, static_cast<uint8_t>(data[i]));
+    return crc;
+  }
+};
+
+// Fast 64 bit hash that consumes 8 bytes per step. Used to detect repeated lines and telegrams without keeping a copy of them.
+// Inputs of 32 bytes and more are hashed in four independent lanes, so the multiplications overlap.
+// Not a cryptographic hash, and the values depend on the byte order of the platform.
+class WordHash final {
+  static constexpr uint64_t kMultiplier = 0x9E3779B97F4A7C15ull;
+
+  static uint64_t mix(uint64_t hash) {
+    hash *= kMultiplier;
+    return hash ^ (hash >> 29);
+  }
+
+  static uint64_t load(const char* data) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+  }
+
+public:
+  static uint64_t calculate(std::string_view data, uint64_t seed = 0) {
+    uint64_t hash = seed ^ (data.size() * kMultiplier);
+    size_t pos = 0;
+    if (data.size() >= 32) {
+      std::array<uint64_t, 4> lanes = {hash, hash + 1, hash + 2, hash + 3};
+      for (; pos + 32 <= data.size(); pos += 32) {
+        for (size_t lane = 0; lane < lanes.size(); ++lane)
+          lanes[lane] = mix(lanes[lane] ^ load(data.data() + pos + lane * 8));
+      }
+      hash = mix(mix(mix(lanes[0] ^ lanes[1]) ^ lanes[2]) ^ lanes[3]);
+    }
+    for (; pos + 8 <= data.size(); pos += 8)
+      hash = mix(hash ^ load(data.data() + pos));
+    uint64_t tail = 0;
+    if (pos < data.size())
+      std::memcpy(&tail, data.data() + pos, data.size() - pos);
+    return mix(hash ^ tail);
+  }
+
+  // Hashes `data` in parts while the caller walks it anyway. finish() returns the same value as calculate(data, seed).
+  class Stream final {
+    std::string_view _data;
+    std::array<uint64_t, 4> _lanes;
+    size_t _pos = 0;
+
+  public:
+    explicit Stream(std::string_view data, uint64_t seed = 0) : _data(data) {
+      const uint64_t hash = seed ^ (data.size() * kMultiplier);
+      _lanes = {hash, hash + 1, hash + 2, hash + 3};
+    }
+
+    // Hashes the steps of 32 bytes that end at or before `end`
+    void update(size_t end) {
+      if (_data.size() < 32)
+        return;
+      end = std::min(end, _data.size());
+      for (; _pos + 32 <= end; _pos += 32) {
+        for (size_t lane = 0; lane < _lanes.size(); ++lane)
+          _lanes[lane] = mix(_lanes[lane] ^ load(_data.data() + _pos + lane * 8));
+      }
+    }
+
+    uint64_t finish() {
+      uint64_t hash = _lanes[0];
+      if (_data.size() >= 32) {
+        update(_data.size());
+        hash = mix(mix(mix(_lanes[0] ^ _lanes[1]) ^ _lanes[2]) ^ _lanes[3]);
+      }
+      auto pos = _pos;
+      for (; pos + 8 <= _data.size(); pos += 8)
+        hash = mix(hash ^ load(_data.data() + pos));
+      uint64_t tail = 0;
+      if (pos < _data.size())
+        std::memcpy(&tail, _data.data() + pos, _data.size() - pos);
+      return mix(hash ^ tail);
+    }
+  };
+};
+
 enum class LogLevel {
   VERY_VERBOSE,
   VERBOSE,
@@ -68,10 +217,37 @@ enum class LogLevel {
   ERROR,
 };
 
+// Messages below this level are removed at compile time, including the evaluation of their arguments.
+// 0 = VERY_VERBOSE (log everything) ... 5 = ERROR, 6 = no logging at all.
+#ifndef DSMR_PARSER_MIN_LOG_LEVEL
+#define DSMR_PARSER_MIN_LOG_LEVEL 0
+#endif
+
 class Logger final {
 public:
-  static void set_log_function(std::function<void(LogLevel log_level, const char* fmt, va_list args)> func) { _log_function = std::move(func); }
+  // Receives the messages. `context` is the pointer passed to set_log_function().
+  using LogFunction = void (*)(void* context, LogLevel log_level, const char* fmt, va_list args);
+  using LogFunctionWithoutContext = void (*)(LogLevel log_level, const char* fmt, va_list args);
+
+  static constexpr LogLevel kMinLogLevel = static_cast<LogLevel>(DSMR_PARSER_MIN_LOG_LEVEL);
+
+  // nullptr disables the logging
+  static void set_log_function(LogFunction func, void* context) {
+    _log_function = func;
+    _context = context;
+  }
 
+  static void set_log_function(LogFunctionWithoutContext func) {
+    _log_function_without_context = func;
+    set_log_function(func == nullptr ? nullptr : &call_without_context, nullptr);
+  }
+
+  static constexpr bool compiled_in(LogLevel log_level) { return log_level >= kMinLogLevel; }
+
+  // Whether a message of the level reaches the log function. Allows to skip preparing the arguments of expensive messages.
+  static bool enabled(LogLevel log_level) { return compiled_in(log_level) && _log_function != nullptr; }
+
+  // Prefer the DSMR_PARSER_LOG macro, that removes the call if the level is below DSMR_PARSER_MIN_LOG_LEVEL.
 #if defined(_MSC_VER)
   static void log(LogLevel log_level, _In_z_ _Printf_format_string_ const char* fmt, ...) {
 #elif defined(__clang__) || defined(__GNUC__)
@@ -80,16 +256,39 @@ public:
 #else
   static void log(LogLevel log_level, const char* fmt, ...) {
 #endif
+    if (!enabled(log_level))
+      return;
     va_list args;
     va_start(args, fmt);
-    _log_function(log_level, fmt, args);
+    _log_function(_context, log_level, fmt, args);
     va_end(args);
   }
 
 private:
   Logger() = default;
 
-  inline static std::function<void(LogLevel log_level, const char* fmt, va_list args)> _log_function = [](LogLevel, const char*, va_list) {};
+  static void call_without_context(void*, LogLevel log_level, const char* fmt, va_list args) { _log_function_without_context(log_level, fmt, args); }
+
+  inline static LogFunction _log_function = nullptr;
+  inline static void* _context = nullptr;
+  inline static LogFunctionWithoutContext _log_function_without_context = nullptr;
 };
 
 }
+
+// Keeps a shared function out of its callers, so it is compiled once instead of into every template instantiation that uses it.
+#if defined(_MSC_VER)
+#define DSMR_PARSER_NOINLINE __declspec(noinline)
+#elif defined(__clang__) || defined(__GNUC__)
+#define DSMR_PARSER_NOINLINE __attribute__((noinline))
+#else
+#define DSMR_PARSER_NOINLINE
+#endif
+
+// Logs a message if `level` is at least DSMR_PARSER_MIN_LOG_LEVEL. Otherwise the call and its arguments are removed at compile time.
+// `level` must be a constant.
+#define DSMR_PARSER_LOG(level, ...)                                                                                                                            \
+  do {                                                                                                                                                         \
+    if constexpr (::dsmr_parser::Logger::compiled_in(level))                                                                                                   \
+      ::dsmr_parser::Logger::log(level, __VA_ARGS__);                                                                                                          \
+  } while (false)
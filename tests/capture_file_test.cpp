@@ -0,0 +1,135 @@
+#include "dsmr_parser/fields.h"
+#include "replay/capture_file.h"
+#include "replay/replay.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace dsmr_parser;
+using namespace dsmr_parser::fields;
+using namespace dsmr_replay;
+
+namespace {
+using Data = ParsedData<identification, timestamp, power_delivered>;
+
+std::string make_capture(size_t count) {
+  std::string capture;
+  for (size_t i = 0; i < count; ++i) {
+    char body[128];
+    std::snprintf(body, sizeof(body), "/AAA5MTR\r\n\r\n0-0:1.0.0(2101%02zu%02zu%02zu00W)\r\n1-0:1.7.0(%02zu.000*kW)\r\n!", 1 + i / 1440, (i / 60) % 24, i % 60,
+                  i % 100);
+    char crc[8];
+    std::snprintf(crc, sizeof(crc), "%04X\r\n", Crc16::calculate(body));
+    capture += body;
+    capture += crc;
+  }
+  return capture;
+}
+
+struct TempFile final {
+  std::filesystem::path path;
+
+  explicit TempFile(std::string_view name, std::string_view content) : path(std::filesystem::temp_directory_path() / name) {
+    std::ofstream(path, std::ios::binary).write(content.data(), static_cast<std::streamsize>(content.size()));
+  }
+  ~TempFile() { std::filesystem::remove(path); }
+};
+
+std::vector<size_t> replay_offsets(std::string_view capture, size_t start_offset) {
+  ReplayOptions options;
+  options.threads = 2;
+  options.chunk_size = 1000;
+  options.start_offset = start_offset;
+  std::vector<size_t> offsets;
+  replay_plaintext<Data>(capture, options, [&](const ReplayedTelegram<Data>& telegram) { offsets.push_back(telegram.offset); });
+  return offsets;
+}
+}
+
+TEST_CASE_FIXTURE(LogFixture, "MappedFile maps a capture without copying it") {
+  const auto capture = make_capture(100);
+  const TempFile file("dsmr_parser_mapped_file_test.bin", capture);
+
+  const auto mapped = MappedFile::open(file.path.string().c_str());
+  REQUIRE(mapped);
+  REQUIRE(mapped->text() == capture);
+
+  TelegramSplitter splitter(mapped->text(), true);
+  const auto telegram = splitter.next();
+  REQUIRE(telegram);
+  REQUIRE(telegram->content().data() == mapped->text().data());
+
+  REQUIRE_FALSE(MappedFile::open("/non/existing/file"));
+  REQUIRE(log.contains("Can't open '/non/existing/file'"));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "CaptureIndex allows to start a replay at a timestamp") {
+  const auto capture = make_capture(3000);
+  const auto index = CaptureIndex::build_plaintext(capture, 4096, true);
+  REQUIRE(index.entries().size() > 10);
+  REQUIRE(index.entries().front().offset == 0);
+  REQUIRE(index.entries().front().timestamp == 210101000000);
+
+  // Every entry is the start of a telegram. A replay from there gives the tail of the full replay.
+  const auto all = replay_offsets(capture, 0);
+  for (const auto& entry : index.entries()) {
+    REQUIRE(capture[entry.offset] == '/');
+    const auto tail = replay_offsets(capture, entry.offset);
+    REQUIRE(std::vector<size_t>(all.end() - static_cast<std::ptrdiff_t>(tail.size()), all.end()) == tail);
+  }
+
+  // Telegram 1500 has the timestamp 2101020100. The replay starts at the last entry before it.
+  const auto offset = index.seek(210102010000);
+  REQUIRE(offset > 0);
+  const auto tail = replay_offsets(capture, offset);
+  REQUIRE(tail.front() == offset);
+  REQUIRE(tail.size() > 1500);
+  REQUIRE(tail.size() < 1500 + 100);
+  REQUIRE(index.seek(0) == 0);
+
+  SUBCASE("Save and load") {
+    const TempFile file("dsmr_parser_capture_index_test.idx", "");
+    REQUIRE(index.save(file.path.string().c_str()));
+    const auto loaded = CaptureIndex::load(file.path.string().c_str(), capture.size(), 4096);
+    REQUIRE(loaded);
+    REQUIRE(loaded->entries().size() == index.entries().size());
+    REQUIRE(loaded->seek(210102010000) == offset);
+  }
+
+  SUBCASE("An index of another capture or stride is not loaded") {
+    const TempFile file("dsmr_parser_capture_index_test.idx", "");
+    REQUIRE(index.save(file.path.string().c_str()));
+    REQUIRE_FALSE(CaptureIndex::load(file.path.string().c_str(), capture.size() - 1, 4096));
+    REQUIRE_FALSE(CaptureIndex::load(file.path.string().c_str(), capture.size(), 8192));
+    REQUIRE(log.contains("doesn't match the capture"));
+  }
+
+  SUBCASE("An index file without a header is not loaded") {
+    const TempFile file("dsmr_parser_capture_index_test.idx", "0 210101000000\n");
+    REQUIRE_FALSE(CaptureIndex::load(file.path.string().c_str(), capture.size(), 4096));
+  }
+
+  SUBCASE("An index file with offsets that the capture can't have is not loaded") {
+    const auto header = "dsmr_index " + std::to_string(capture.size()) + " 4096\n";
+    const auto rejected = [&](const std::string& entries) {
+      const TempFile file("dsmr_parser_capture_index_test.idx", header + entries);
+      return !CaptureIndex::load(file.path.string().c_str(), capture.size(), 4096);
+    };
+    REQUIRE_FALSE(rejected("0 210101000000\n4096 0\n"));
+    REQUIRE(rejected("0 210101000000\n" + std::to_string(capture.size()) + " 0\n"));
+    REQUIRE(rejected("4096 0\n0 210101000000\n"));
+    REQUIRE(rejected("0 0\n0 0\n"));
+    REQUIRE(rejected("0 210101000000\n4096 x\n"));
+    REQUIRE(log.contains("has offsets that can't be in the capture"));
+    REQUIRE(log.contains("is damaged"));
+
+    std::string too_many;
+    for (size_t entry = 0; entry <= capture.size() / 4096 + 1; ++entry)
+      too_many += std::to_string(entry) + " 0\n";
+    REQUIRE(rejected(too_many));
+  }
+}
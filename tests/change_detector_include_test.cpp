@@ -0,0 +1,10 @@
+// This code tests that the change_detector header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/change_detector.h"
+
+void ChangeDetector_some_function() {
+  dsmr_parser::ChangeDetector<dsmr_parser::fields::power_delivered> detector;
+  dsmr_parser::ChangeDetector<dsmr_parser::fields::power_delivered>::Data data{};
+  detector.update(data);
+}
@@ -0,0 +1,167 @@
+#include "dsmr_parser/change_detector.h"
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/parser.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <string>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+namespace {
+using Detector = ChangeDetector<equipment_id, power_delivered, voltage_l1, electricity_failures, gas_delivered>;
+
+// The values point into `telegram`, that must outlive them
+Detector::Data parse(const std::string& telegram) {
+  Detector::Data data;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(telegram)));
+  return data;
+}
+
+std::string telegram(const char* power, const char* voltage, const char* gas_timestamp) {
+  return std::string("/AAA5MTR\r\n"
+                     "0-0:96.1.1(12345678)\r\n"
+                     "1-0:1.7.0(") +
+         power +
+         "*kW)\r\n"
+         "1-0:32.7.0(" +
+         voltage +
+         "*V)\r\n"
+         "0-0:96.7.21(00004)\r\n"
+         "0-1:24.2.1(" +
+         gas_timestamp +
+         ")(00473.789*m3)\r\n"
+         "!";
+}
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ChangeDetector reports all present fields of the first telegram") {
+  Detector detector;
+  const auto data_telegram = telegram("00.318", "230.0", "150117180000W");
+  auto data = parse(data_telegram);
+  REQUIRE(detector.update(data)[0] == 0b11111);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ChangeDetector reports only the fields that changed") {
+  Detector detector;
+  const auto first_telegram = telegram("00.318", "230.0", "150117180000W");
+  auto first = parse(first_telegram);
+  detector.update(first);
+
+  // The same values in a different buffer
+  const auto same_telegram = telegram("00.318", "230.0", "150117180000W");
+  auto same = parse(same_telegram);
+  REQUIRE(detector.update(same)[0] == 0);
+
+  const auto power_changed_telegram = telegram("00.320", "230.0", "150117180000W");
+  auto power_changed = parse(power_changed_telegram);
+  detector.update(power_changed);
+  REQUIRE(detector.changed<power_delivered>());
+  REQUIRE_FALSE(detector.changed<equipment_id>());
+  REQUIRE(detector.changes()[0] == 0b00010);
+
+  const auto gas_timestamp_changed_telegram = telegram("00.320", "230.0", "150117190000W");
+  auto gas_timestamp_changed = parse(gas_timestamp_changed_telegram);
+  REQUIRE(detector.update(gas_timestamp_changed)[0] == 0b10000);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ChangeDetector ignores changes within the deadband") {
+  Detector detector;
+  detector.set_deadband<voltage_l1>(500);
+  const auto first_telegram = telegram("00.318", "230.0", "150117180000W");
+  auto first = parse(first_telegram);
+  detector.update(first);
+
+  const auto small_telegram = telegram("00.318", "230.4", "150117180000W");
+  auto small = parse(small_telegram);
+  REQUIRE_FALSE(detector.update(small)[0]);
+
+  // The drift is compared with the last reported value, 230.0
+  const auto drift_telegram = telegram("00.318", "230.5", "150117180000W");
+  auto drift = parse(drift_telegram);
+  detector.update(drift);
+  REQUIRE(detector.changed<voltage_l1>());
+
+  const auto back_telegram = telegram("00.318", "230.1", "150117180000W");
+  auto back = parse(back_telegram);
+  REQUIRE_FALSE(detector.update(back)[0]);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ChangeDetector takes the first value of a field as the reference of the deadband") {
+  Detector detector;
+  detector.set_deadband<power_delivered>(500);
+  const auto first_telegram = telegram("00.300", "230.0", "150117180000W");
+  auto first = parse(first_telegram);
+  detector.update(first);
+  REQUIRE(detector.changed<power_delivered>());
+
+  const auto small_telegram = telegram("00.600", "230.0", "150117180000W");
+  auto small = parse(small_telegram);
+  REQUIRE_FALSE(detector.update(small)[0]);
+
+  // After reset() the next value is the reference again
+  detector.reset();
+  detector.update(small);
+  const auto back_telegram = telegram("00.300", "230.0", "150117180000W");
+  auto back = parse(back_telegram);
+  REQUIRE_FALSE(detector.update(back)[0]);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ChangeDetector reports fields that appear or disappear") {
+  Detector detector;
+  const auto first_telegram = telegram("00.318", "230.0", "150117180000W");
+  auto first = parse(first_telegram);
+  detector.update(first);
+
+  const std::string missing_telegram = "/AAA5MTR\r\n"
+                                       "0-0:96.1.1(12345678)\r\n"
+                                       "1-0:1.7.0(00.318*kW)\r\n"
+                                       "!";
+  auto missing = parse(missing_telegram);
+  REQUIRE(detector.update(missing)[0] == 0b11100);
+
+  const auto back_telegram = telegram("00.318", "230.0", "150117180000W");
+  auto back = parse(back_telegram);
+  REQUIRE(detector.update(back)[0] == 0b11100);
+
+  detector.reset();
+  REQUIRE(detector.update(back)[0] == 0b11111);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ChangeDetector reports a new entry of a profile buffer") {
+  ChangeDetector<electricity_failure_log_entries> detector;
+  const auto parse_log = [](const std::string& text) {
+    ChangeDetector<electricity_failure_log_entries>::Data data;
+    REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(text)));
+    return data;
+  };
+  const std::string one = "/AAA5MTR\r\n1-0:99.97.0(1)(0-0:96.7.19)(101208152415W)(0000000240*s)\r\n!";
+  const std::string same = one;
+  const std::string two = "/AAA5MTR\r\n1-0:99.97.0(2)(0-0:96.7.19)(101208152415W)(0000000240*s)(101209152415W)(0000000010*s)\r\n!";
+
+  auto first = parse_log(one);
+  REQUIRE(detector.update(first)[0] == 1);
+  auto unchanged = parse_log(same);
+  REQUIRE(detector.update(unchanged)[0] == 0);
+  auto added = parse_log(two);
+  REQUIRE(detector.update(added)[0] == 1);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ChangeDetector reports a new reading of an M-Bus device") {
+  ChangeDetector<mbus_devices> detector;
+  const auto parse_devices = [](const std::string& text) {
+    ChangeDetector<mbus_devices>::Data data;
+    REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(text)));
+    return data;
+  };
+  const std::string one = "/AAA5MTR\r\n0-2:24.1.0(003)\r\n0-2:24.2.1(150117180000W)(00473.789*m3)\r\n!";
+  const std::string same = one;
+  const std::string next = "/AAA5MTR\r\n0-2:24.1.0(003)\r\n0-2:24.2.1(150117190000W)(00473.789*m3)\r\n!";
+
+  auto first = parse_devices(one);
+  REQUIRE(detector.update(first)[0] == 1);
+  auto unchanged = parse_devices(same);
+  REQUIRE(detector.update(unchanged)[0] == 0);
+  auto changed = parse_devices(next);
+  REQUIRE(detector.update(changed)[0] == 1);
+}
@@ -0,0 +1,10 @@
+// This code tests that the columnar_data header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/columnar_data.h"
+
+void ColumnarData_some_function() {
+  dsmr_parser::ColumnarData<10, dsmr_parser::fields::power_delivered> columns;
+  dsmr_parser::DsmrUnencryptedTelegram telegrams[] = {dsmr_parser::DsmrUnencryptedTelegram("/msg\r\n!")};
+  dsmr_parser::DsmrParser::parse_batch(columns, telegrams);
+}
@@ -0,0 +1,73 @@
+#include "dsmr_parser/columnar_data.h"
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/parser.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <vector>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+namespace {
+const std::vector<DsmrUnencryptedTelegram> telegrams = {
+    DsmrUnencryptedTelegram("/AAA5MTR\r\n"
+                            "0-0:96.1.1(12345678)\r\n"
+                            "1-0:1.7.0(00.318*kW)\r\n"
+                            "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                            "!"),
+    DsmrUnencryptedTelegram("/AAA5MTR\r\n"
+                            "1-0:1.7.0(01.500*kW)\r\n"
+                            "!"),
+    DsmrUnencryptedTelegram("/AAA5MTR\r\n"
+                            "1-0:1.7.0(02.000*kW)\r\n"
+                            "1-0:1.7.0)\r\n"
+                            "!"),
+    DsmrUnencryptedTelegram("/AAA5MTR\r\n"
+                            "0-0:96.1.1(87654321)\r\n"
+                            "1-0:1.7.0(00123*W)\r\n"
+                            "0-1:24.2.1(150117190000W)(00474.001*m3)\r\n"
+                            "!"),
+};
+}
+
+TEST_CASE_FIXTURE(LogFixture, "parse_batch writes fields into columns") {
+  ColumnarData<8, equipment_id, power_delivered, gas_delivered> columns;
+  REQUIRE(DsmrParser::parse_batch(columns, telegrams) == 4);
+  REQUIRE(columns.size() == 4);
+
+  REQUIRE(columns.valid(0));
+  REQUIRE(columns.valid(1));
+  REQUIRE_FALSE(columns.valid(2));
+  REQUIRE(columns.valid(3));
+  REQUIRE(columns.valid_rows().words()[0] == 0b1011);
+
+  const auto& power = columns.column<power_delivered>();
+  REQUIRE(power.values[0] == 318);
+  REQUIRE(power.values[1] == 1500);
+  REQUIRE(power.values[3] == 123);
+  REQUIRE(power.present.words()[0] == 0b1011);
+
+  const auto& gas = columns.column<gas_delivered>();
+  REQUIRE(gas.present.words()[0] == 0b1001);
+  REQUIRE(gas.values[0] == 473789);
+  REQUIRE(gas.timestamps[0] == "150117180000W");
+  REQUIRE(gas.values[3] == 474001);
+  REQUIRE(gas.timestamps[3] == "150117190000W");
+
+  const auto& equipment = columns.column<equipment_id>();
+  REQUIRE(equipment.present.words()[0] == 0b1001);
+  REQUIRE(equipment.values[0] == "12345678");
+  REQUIRE(equipment.values[3] == "87654321");
+}
+
+TEST_CASE_FIXTURE(LogFixture, "parse_batch stops when the columns are full") {
+  ColumnarData<3, power_delivered> columns;
+  REQUIRE(DsmrParser::parse_batch(columns, telegrams) == 3);
+  REQUIRE(DsmrParser::parse_batch(columns, telegrams) == 0);
+
+  columns.clear();
+  REQUIRE(columns.size() == 0);
+  REQUIRE(DsmrParser::parse_batch(columns, std::span(telegrams).subspan(1)) == 3);
+  REQUIRE(columns.column<power_delivered>().values[0] == 1500);
+  REQUIRE(columns.column<power_delivered>().present.words()[0] == 0b101);
+}
@@ -0,0 +1,10 @@
+// This code tests that the compact_data header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/compact_data.h"
+
+void CompactParsedData_some_function() {
+  dsmr_parser::CompactParsedData<dsmr_parser::fields::power_delivered> data;
+  data.parse(dsmr_parser::DsmrUnencryptedTelegram("/msg\r\n!"));
+  data.reset();
+}
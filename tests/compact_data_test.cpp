@@ -0,0 +1,116 @@
+#include "dsmr_parser/compact_data.h"
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/parser.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <string>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+namespace {
+const auto telegram = DsmrUnencryptedTelegram("/KFM5KAIFA-METER\r\n"
+                                              "\r\n"
+                                              "1-3:0.2.8(40)\r\n"
+                                              "0-0:1.0.0(150117185916W)\r\n"
+                                              "1-0:1.8.1(000671.578*kWh)\r\n"
+                                              "1-0:1.7.0(00.318*kW)\r\n"
+                                              "0-0:96.14.0(0001)\r\n"
+                                              "0-0:96.7.21(00004)\r\n"
+                                              "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                                              "!");
+
+using Data = CompactParsedData<identification, p1_version, timestamp, energy_delivered_tariff1, power_delivered, electricity_tariff,
+                               electricity_failures, gas_delivered>;
+}
+
+TEST_CASE_FIXTURE(LogFixture, "CompactParsedData parses the same values as ParsedData") {
+  Data data;
+  REQUIRE(data.parse(telegram));
+
+  REQUIRE(data.view(data.identification) == "KFM5KAIFA-METER");
+  REQUIRE(data.view(data.p1_version) == "40");
+  REQUIRE(data.view(data.timestamp) == "150117185916W");
+  REQUIRE(data.energy_delivered_tariff1.int_val() == 671578);
+  REQUIRE(data.power_delivered.int_val() == 318);
+  REQUIRE(data.view(data.electricity_tariff) == "0001");
+  REQUIRE(data.electricity_failures == 4);
+  REQUIRE(data.gas_delivered.int_val() == 473789);
+  REQUIRE(data.view(data.gas_delivered.timestamp) == "150117180000W");
+  REQUIRE(data.p1_version.view(telegram.content()) == "40");
+
+  REQUIRE(data.present<power_delivered>());
+  REQUIRE(data.all_present());
+  REQUIRE(data.presence()[0] == 0xFF);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "CompactParsedData is smaller than ParsedData") {
+  using Full = ParsedData<identification, p1_version, timestamp, energy_delivered_tariff1, power_delivered, electricity_tariff, electricity_failures,
+                          gas_delivered>;
+  REQUIRE(sizeof(Data) < sizeof(Full) / 2);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "CompactParsedData reset() clears the presence for the next telegram") {
+  Data data;
+  REQUIRE(data.parse(telegram));
+
+  data.reset();
+  REQUIRE_FALSE(data.present<power_delivered>());
+  REQUIRE(data.presence()[0] == 0);
+
+  const auto next = DsmrUnencryptedTelegram("/AAA5MTR\r\n"
+                                            "1-0:1.7.0(01.500*kW)\r\n"
+                                            "!");
+  REQUIRE(data.parse(next));
+  REQUIRE(data.present<identification>());
+  REQUIRE(data.present<power_delivered>());
+  REQUIRE_FALSE(data.present<gas_delivered>());
+  REQUIRE_FALSE(data.all_present());
+  REQUIRE(data.power_delivered.int_val() == 1500);
+  REQUIRE(data.view(data.identification) == "AAA5MTR");
+}
+
+namespace {
+// A field from a user of the library, without DEFINE_COMPACT_FIELD
+DEFINE_FIELD(custom_tariff, std::string_view, ObisId(0, 0, 96, 14, 0), StringField, 4, 4);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "CompactParsedData gives the values by field type") {
+  CompactParsedData<identification, power_delivered, custom_tariff, gas_delivered> data;
+  REQUIRE(data.parse(telegram));
+
+  REQUIRE(data.get<identification>() == "KFM5KAIFA-METER");
+  REQUIRE(data.get<power_delivered>().int_val() == 318);
+  REQUIRE(data.get<custom_tariff>() == "0001");
+  REQUIRE(data.get<gas_delivered>().int_val() == 473789);
+  REQUIRE(data.get<gas_delivered>().timestamp == "150117180000W");
+}
+
+TEST_CASE_FIXTURE(LogFixture, "CompactParsedData reports errors like ParsedData") {
+  const auto msg = "/AAA5MTR\r\n"
+                   "1-0:1.7.0(00.318*kW)\r\n"
+                   "1-0:1.7.0(00.318*kW)\r\n"
+                   "1-0:1.8.1(000671.578*kVA)\r\n"
+                   "!";
+  Data data;
+  const auto res = data.parse(DsmrUnencryptedTelegram(msg));
+  REQUIRE(res.error == ParseError::DuplicateField);
+  REQUIRE(res.offset == 41);
+  REQUIRE(res.id == ObisId(1, 0, 1, 7, 0));
+
+  ParsedData<identification, p1_version, timestamp, energy_delivered_tariff1, power_delivered, electricity_tariff, electricity_failures, gas_delivered>
+      full;
+  REQUIRE(DsmrParser::parse(full, DsmrUnencryptedTelegram(msg)) == res);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "CompactParsedData rejects strings beyond the 16 bit offset") {
+  std::string msg = "/AAA5MTR\r\n";
+  while (msg.size() < 70000)
+    msg += "1-0:99.99.0(0)\r\n";
+  msg += "0-0:96.14.0(0001)\r\n!";
+
+  CompactParsedData<electricity_tariff> data;
+  const auto res = data.parse(DsmrUnencryptedTelegram(msg));
+  REQUIRE(res.error == ParseError::InvalidValue);
+  REQUIRE(res.id == ObisId(0, 0, 96, 14, 0));
+}
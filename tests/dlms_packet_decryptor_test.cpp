@@ -140,3 +140,34 @@ TEST_CASE_FIXTURE(LogFixture, "Does not crash if decrypt_inplace is called witho
     REQUIRE_FALSE(decryptor.decrypt_inplace({packet.data(), packet.size()}));
   }
 }
+
+TEST_CASE_FIXTURE(LogFixture, "packet_size returns the size of a DLMS packet") {
+  auto packet = get_test_encrypted_packet();
+  REQUIRE(DlmsPacketDecryptor::packet_size(packet) == packet.size());
+  REQUIRE(DlmsPacketDecryptor::packet_size(std::span(packet).first(10)) == std::nullopt);
+
+  packet[0] = 0;
+  REQUIRE(DlmsPacketDecryptor::packet_size(packet) == std::nullopt);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Counts packets and errors in ParserStats") {
+  Aes128GcmMbedTls gcm_decryptor;
+  gcm_decryptor.set_encryption_key(*Aes128GcmDecryptionKey::from_hex("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA"));
+  DlmsPacketDecryptor decryptor(gcm_decryptor);
+  ParserStats stats;
+  decryptor.set_stats(&stats);
+
+  auto packet = get_test_encrypted_packet();
+  REQUIRE(decryptor.decrypt_inplace({packet.data(), packet.size()}));
+
+  auto corrupted_packet = get_test_encrypted_packet();
+  corrupted_packet[50] ^= 0xFF;
+  REQUIRE_FALSE(decryptor.decrypt_inplace({corrupted_packet.data(), corrupted_packet.size()}));
+
+  std::vector<uint8_t> small_dlms_packet(10);
+  REQUIRE_FALSE(decryptor.decrypt_inplace({small_dlms_packet.data(), small_dlms_packet.size()}));
+
+  REQUIRE(stats.dlms_packets.value() == 3);
+  REQUIRE(stats.decryption_errors.value() == 1);
+  REQUIRE(stats.invalid_dlms_packets.value() == 1);
+}
@@ -0,0 +1,10 @@
+// This code tests that the line_cache header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/line_cache.h"
+
+void LineCache_some_function() {
+  dsmr_parser::LineCache<8, dsmr_parser::fields::power_delivered> cache;
+  dsmr_parser::LineCache<8, dsmr_parser::fields::power_delivered>::Data data{};
+  cache.parse(data, dsmr_parser::DsmrUnencryptedTelegram("/msg\r\n!"));
+}
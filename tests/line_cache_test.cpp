@@ -0,0 +1,162 @@
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/line_cache.h"
+#include "dsmr_parser/parser.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <string>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+namespace {
+using Cache = LineCache<16, identification, equipment_id, power_delivered, electricity_failures, gas_delivered>;
+
+std::string telegram(const char* power) {
+  return std::string("/AAA5MTR\r\n"
+                     "0-0:96.1.1(12345678)\r\n"
+                     "1-0:1.7.0(") +
+         power +
+         "*kW)\r\n"
+         "0-0:96.7.21(00004)\r\n"
+         "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+         "!";
+}
+
+void require_values(Cache::Data& data, const std::string& text, int32_t power) {
+  REQUIRE(data.identification == "AAA5MTR");
+  REQUIRE(data.equipment_id == "12345678");
+  REQUIRE(data.power_delivered.int_val() == power);
+  REQUIRE(data.electricity_failures == 4);
+  REQUIRE(data.gas_delivered.int_val() == 473789);
+  REQUIRE(data.gas_delivered.timestamp == "150117180000W");
+  // The strings point into the telegram that was parsed last
+  REQUIRE(data.equipment_id.data() == text.data() + text.find("12345678"));
+  REQUIRE(data.gas_delivered.timestamp.data() == text.data() + text.find("150117180000W"));
+}
+}
+
+TEST_CASE_FIXTURE(LogFixture, "LineCache returns the same values as DsmrParser for repeated and changed telegrams") {
+  Cache cache;
+  ParserStats stats;
+  // Different buffers, the values must point into the current one
+  const auto first_text = telegram("00.318");
+  const auto same_text = telegram("00.318");
+  const auto changed_text = "\r\n" + telegram("01.500");
+
+  Cache::Data first;
+  REQUIRE(cache.parse(first, DsmrUnencryptedTelegram(first_text), false, &stats));
+  require_values(first, first_text, 318);
+
+  Cache::Data same;
+  REQUIRE(cache.parse(same, DsmrUnencryptedTelegram(same_text), false, &stats));
+  require_values(same, same_text, 318);
+
+  // Shifted by two bytes and one changed line
+  const auto changed_telegram = std::string_view(changed_text).substr(2);
+  Cache::Data changed;
+  REQUIRE(cache.parse(changed, DsmrUnencryptedTelegram(changed_telegram), false, &stats));
+  REQUIRE(changed.power_delivered.int_val() == 1500);
+  REQUIRE(changed.equipment_id == "12345678");
+  REQUIRE(changed.equipment_id.data() == changed_text.data() + changed_text.find("12345678"));
+  REQUIRE(changed.gas_delivered.timestamp.data() == changed_text.data() + changed_text.find("150117180000W"));
+
+  Cache::Data again;
+  REQUIRE(cache.parse(again, DsmrUnencryptedTelegram(first_text), false, &stats));
+  require_values(again, first_text, 318);
+  REQUIRE(stats.parsed_telegrams.value() == 4);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "LineCache reports errors and does not reuse a failed telegram") {
+  Cache cache;
+  const auto valid = telegram("00.318");
+  const auto invalid = telegram("00.318*kW)(1");
+
+  Cache::Data first;
+  REQUIRE(cache.parse(first, DsmrUnencryptedTelegram(valid)));
+
+  Cache::Data failed;
+  const auto res = cache.parse(failed, DsmrUnencryptedTelegram(invalid));
+  REQUIRE(res.error == ParseError::TrailingCharacters);
+  Cache::Data uncached;
+  REQUIRE(DsmrParser::parse(uncached, DsmrUnencryptedTelegram(invalid)) == res);
+
+  Cache::Data next;
+  REQUIRE(cache.parse(next, DsmrUnencryptedTelegram(valid)));
+  require_values(next, valid, 318);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "LineCache checks unknown fields again if unknown_error changes") {
+  LineCache<16, identification, power_delivered> cache;
+  const auto text = telegram("00.318");
+
+  LineCache<16, identification, power_delivered>::Data first;
+  REQUIRE(cache.parse(first, DsmrUnencryptedTelegram(text)));
+
+  LineCache<16, identification, power_delivered>::Data second;
+  REQUIRE(cache.parse(second, DsmrUnencryptedTelegram(text), true).error == ParseError::UnknownField);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "LineCache parses the lines beyond its capacity") {
+  LineCache<2, identification, equipment_id, power_delivered, electricity_failures, gas_delivered> cache;
+  const auto first_text = telegram("00.318");
+  const auto second_text = telegram("01.500");
+
+  Cache::Data first;
+  REQUIRE(cache.parse(first, DsmrUnencryptedTelegram(first_text)));
+  Cache::Data second;
+  REQUIRE(cache.parse(second, DsmrUnencryptedTelegram(second_text)));
+  require_values(second, second_text, 1500);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "LineCache moves the timestamps of profile entries to the current telegram") {
+  const auto text = [](const char* power) {
+    return std::string("/AAA5MTR\r\n"
+                       "1-0:1.7.0(") +
+           power +
+           "*kW)\r\n"
+           "1-0:99.97.0(1)(0-0:96.7.19)(101208152415W)(0000000240*s)\r\n"
+           "!";
+  };
+  LineCache<4, power_delivered, electricity_failure_log_entries> cache;
+  const auto first_text = text("00.318");
+  const auto changed_text = text("01.500");
+
+  decltype(cache)::Data first;
+  REQUIRE(cache.parse(first, DsmrUnencryptedTelegram(first_text)));
+  decltype(cache)::Data changed;
+  REQUIRE(cache.parse(changed, DsmrUnencryptedTelegram(changed_text)));
+  REQUIRE(changed.power_delivered.int_val() == 1500);
+  REQUIRE(changed.electricity_failure_log_entries.size() == 1);
+  REQUIRE(changed.electricity_failure_log_entries[0].value == 240);
+  REQUIRE(changed.electricity_failure_log_entries[0].timestamp.data() == changed_text.data() + changed_text.find("101208152415W"));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "LineCache parses the lines of M-Bus devices again") {
+  const auto text = [](const char* gas) {
+    return std::string("/AAA5MTR\r\n"
+                       "1-0:1.7.0(00.318*kW)\r\n"
+                       "0-2:24.1.0(003)\r\n"
+                       "0-2:24.2.1(150117180000W)(") +
+           gas +
+           "*m3)\r\n"
+           "!";
+  };
+  LineCache<4, power_delivered, mbus_devices> cache;
+  const auto first_text = text("00473.789");
+  const auto changed_text = text("00474.000");
+
+  decltype(cache)::Data first;
+  REQUIRE(cache.parse(first, DsmrUnencryptedTelegram(first_text)));
+  decltype(cache)::Data changed;
+  REQUIRE(cache.parse(changed, DsmrUnencryptedTelegram(changed_text)));
+  REQUIRE(changed.power_delivered.int_val() == 318);
+  const auto* gas = changed.mbus_devices.find(MbusMedium::Gas);
+  REQUIRE(gas != nullptr);
+  REQUIRE(gas->delivered.int_val() == 474000);
+  REQUIRE(gas->delivered.timestamp.data() == changed_text.data() + changed_text.find("150117180000W"));
+
+  // A telegram that is the same as the previous one is copied
+  decltype(cache)::Data same;
+  REQUIRE(cache.parse(same, DsmrUnencryptedTelegram(changed_text)));
+  REQUIRE(same.mbus_devices.find(MbusMedium::Gas)->delivered.int_val() == 474000);
+}
@@ -0,0 +1,33 @@
+#include "dsmr_parser/util.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <string>
+
+using namespace dsmr_parser;
+
+// The tests are built with the default DSMR_PARSER_MIN_LOG_LEVEL, that keeps all messages
+static_assert(Logger::compiled_in(LogLevel::VERY_VERBOSE));
+static_assert(Logger::compiled_in(LogLevel::ERROR));
+
+TEST_CASE_FIXTURE(LogFixture, "DSMR_PARSER_LOG passes the message and its arguments to the log function") {
+  DSMR_PARSER_LOG(LogLevel::VERBOSE, "value %d of '%s'", 42, "field");
+  REQUIRE(log.contains("value 42 of 'field'"));
+  REQUIRE(Logger::enabled(LogLevel::VERY_VERBOSE));
+}
+
+namespace {
+std::string last_message;
+
+void log_without_context(LogLevel, const char* fmt, va_list) { last_message = fmt; }
+}
+
+TEST_CASE("Log function without context") {
+  Logger::set_log_function(&log_without_context);
+  Logger::log(LogLevel::ERROR, "message");
+  REQUIRE(last_message == "message");
+
+  Logger::set_log_function(nullptr);
+  REQUIRE_FALSE(Logger::enabled(LogLevel::ERROR));
+  Logger::log(LogLevel::ERROR, "ignored");
+  REQUIRE(last_message == "message");
+}
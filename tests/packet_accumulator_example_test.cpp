@@ -57,9 +57,12 @@ TEST_CASE_FIXTURE(LogFixture, "PacketAccumulator example") {
 
     // Parse the packet.
     MyParsedData data;
-    bool res = DsmrParser::parse(data, dsmrTelegram.value());
+    const ParseResult res = DsmrParser::parse(data, dsmrTelegram.value());
     if (!res) {
-      // Parsing failed
+      // Parsing failed. The result tells why and where, format() builds a message from it.
+      char message[128];
+      res.format(message, dsmrTelegram->content());
+      std::cout << message << '\n';
       continue;
     }
 
@@ -0,0 +1,10 @@
+// This code tests that the parse error header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/parse_error.h"
+
+void ParseResult_some_function() {
+  char buffer[64];
+  const dsmr_parser::ParseResult result{dsmr_parser::ParseError::MissingUnit, 3, dsmr_parser::ObisId(1, 0, 1, 7, 0)};
+  result.format(buffer, "/A\r\n1-0:1.7.0(1)\r\n!");
+}
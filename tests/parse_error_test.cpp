@@ -0,0 +1,112 @@
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/parse_error.h"
+#include "dsmr_parser/parser.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <array>
+#include <string_view>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+namespace {
+// A field from a user of the library. It doesn't record the reason of the failure.
+struct custom_field {
+  bool custom_field_present = false;
+  static constexpr ObisId id = ObisId(1, 0, 99, 99, 0);
+  bool& present() { return custom_field_present; }
+  static std::optional<std::string_view> parse(std::string_view) { return std::nullopt; }
+};
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ParseResult points to the error") {
+  const std::string_view msg = "/AAA5MTR\r\n"
+                               "\r\n"
+                               "1-0:1.7.0(00.318*kW)\r\n"
+                               "1-0:2.7.0(00.100*XX)\r\n"
+                               "!";
+  ParsedData<identification, power_delivered, power_returned> data;
+  const auto res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
+  REQUIRE_FALSE(res);
+  REQUIRE(res.error == ParseError::InvalidUnit);
+  REQUIRE(res.id == ObisId(1, 0, 2, 7, 0));
+  REQUIRE(res.offset == msg.find("XX"));
+  REQUIRE(res.line(msg) == "1-0:2.7.0(00.100*XX)");
+  REQUIRE(std::string_view(res.message()) == "Invalid unit");
+
+  std::array<char, 100> buffer{};
+  REQUIRE(res.format(buffer, msg) > 0);
+  REQUIRE(std::string_view(buffer.data()) == "Invalid unit at offset 51: '1-0:2.7.0(00.100*XX)'");
+
+  // Nothing is formatted unless asked for
+  REQUIRE(log.messages.empty());
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ParseResult converts to true on success") {
+  ParsedData<identification> data;
+  const auto res = DsmrParser::parse(data, DsmrUnencryptedTelegram("/AAA5MTR\r\n!"));
+  REQUIRE(res);
+  REQUIRE(res == ParseResult{});
+  REQUIRE(std::string_view(res.message()) == "No error");
+
+  // Code written for the bool result still compiles
+  ParsedData<identification> data2;
+  const bool ok = DsmrParser::parse(data2, DsmrUnencryptedTelegram("/AAA5MTR\r\n!"));
+  REQUIRE(ok);
+  ParsedData<identification> data3;
+  const bool failed = DsmrParser::parse(data3, DsmrUnencryptedTelegram("/AAA5MTR\r\n1-0:1.7.0(1)!"));
+  REQUIRE_FALSE(failed);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ParseResult::line() handles the first and the last line") {
+  const std::string_view msg = "/AAA5MTR\r\n1-0:1.7.0(1)!";
+  REQUIRE(ParseResult{ParseError::InvalidStringLength, 3, ObisId()}.line(msg) == "/AAA5MTR");
+  REQUIRE(ParseResult{ParseError::LastLineNotTerminated, 10, ObisId()}.line(msg) == "1-0:1.7.0(1)!");
+  REQUIRE(ParseResult{ParseError::LastLineNotTerminated, 100, ObisId()}.line(msg) == "1-0:1.7.0(1)!");
+  REQUIRE(ParseResult{ParseError::MissingOpenParenthesis, 8, ObisId()}.line(msg) == "/AAA5MTR");
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Fields that fail without a reason are reported as an invalid value") {
+  const std::string_view msg = "/AAA5MTR\r\n1-0:1.7.0(1*kW)\r\n1-0:99.99.0(1)\r\n!";
+  ParsedData<power_delivered, custom_field> data;
+  const auto res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
+  REQUIRE(res.error == ParseError::InvalidValue);
+  REQUIRE(res.offset == msg.find("(1)\r\n"));
+  REQUIRE(res.id == ObisId(1, 0, 99, 99, 0));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "ParseFailure reports a position outside of the telegram at offset 0") {
+  const std::string_view msg = "/AAA5MTR\r\n1-0:1.7.0(1*kW)\r\n!";
+  const std::string_view other = "(1*kW)";
+  ParseFailure failure;
+  REQUIRE(failure.result(msg) == ParseResult{});
+
+  failure.set(ParseError::MissingUnit, msg.data() + 20);
+  REQUIRE(failure.result(msg).offset == 20);
+  failure.set(ParseError::MissingUnit, msg.data() + msg.size());
+  REQUIRE(failure.result(msg).offset == msg.size());
+  failure.set(ParseError::MissingUnit, other.data());
+  REQUIRE(failure.result(msg) == ParseResult{ParseError::MissingUnit, 0, ObisId()});
+}
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4996)
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+TEST_CASE_FIXTURE(LogFixture, "parse_num with log_errors logs the reason like before") {
+  int32_t value = 0;
+  REQUIRE(parse_num(value, 3, "kW", "(1.5*kW)", true) == std::string_view());
+  REQUIRE(value == 1500);
+  REQUIRE_FALSE(parse_num(value, 3, "kW", "(1.5*XX)", false));
+  REQUIRE(log.messages.empty());
+  REQUIRE_FALSE(parse_num(value, 3, "kW", "(1.5*XX)", true));
+  REQUIRE(log.contains("Invalid unit '(1.5*XX)'"));
+}
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#else
+#pragma GCC diagnostic pop
+#endif
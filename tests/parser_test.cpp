@@ -7,6 +7,9 @@
 using namespace dsmr_parser;
 using namespace fields;
 
+// The rest of the telegram, starting at the error
+static std::string_view error_position(std::string_view telegram, const ParseResult& result) { return telegram.substr(result.offset); }
+
 TEST_CASE_FIXTURE(LogFixture, "Should parse all fields in the DSMR message correctly") {
   const auto& msg = "/KFM5KAIFA-METER\r\n"
                     "\r\n"
@@ -264,8 +267,8 @@ TEST_CASE_FIXTURE(LogFixture, "Should detect duplicate fields") {
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Duplicate field"));
-  REQUIRE(log.contains("(00.200*kW)"));
+  REQUIRE(res.error == ParseError::DuplicateField);
+  REQUIRE(error_position(msg, res).starts_with("(00.200*kW)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Should error on unknown field when unknown_error is true") {
@@ -280,8 +283,8 @@ TEST_CASE_FIXTURE(LogFixture, "Should error on unknown field when unknown_error
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg), /*unknown_error=*/true);
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Unknown field"));
-  REQUIRE(log.contains("1-0:2.7.0(00.000*kW)"));
+  REQUIRE(res.error == ParseError::UnknownField);
+  REQUIRE(error_position(msg, res).starts_with("1-0:2.7.0(00.000*kW)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Should report OBIS ID numbers over 255") {
@@ -297,8 +300,8 @@ TEST_CASE_FIXTURE(LogFixture, "Should report OBIS ID numbers over 255") {
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Obis ID has number over 255"));
-  REQUIRE(log.contains("6-0:1.7.0(00.100*kW)"));
+  REQUIRE(res.error == ParseError::ObisNumberOver255);
+  REQUIRE(error_position(msg, res).starts_with("6-0:1.7.0(00.100*kW)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Should validate string length bounds (p1_version too short)") {
@@ -314,8 +317,8 @@ TEST_CASE_FIXTURE(LogFixture, "Should validate string length bounds (p1_version
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Invalid string length"));
-  REQUIRE(log.contains("4)"));
+  REQUIRE(res.error == ParseError::InvalidStringLength);
+  REQUIRE(error_position(msg, res).starts_with("(4)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Should validate string length bounds (p1_version too long)") {
@@ -331,8 +334,8 @@ TEST_CASE_FIXTURE(LogFixture, "Should validate string length bounds (p1_version
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Invalid string length"));
-  REQUIRE(log.contains("123)"));
+  REQUIRE(res.error == ParseError::InvalidStringLength);
+  REQUIRE(error_position(msg, res).starts_with("(123)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Should validate units for numeric fields") {
@@ -348,8 +351,8 @@ TEST_CASE_FIXTURE(LogFixture, "Should validate units for numeric fields") {
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Missing unit"));
-  REQUIRE(log.contains("kVA)"));
+  REQUIRE(res.error == ParseError::InvalidUnit);
+  REQUIRE(error_position(msg, res).starts_with("VA)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Should report missing closing parenthesis for StringField") {
@@ -365,7 +368,7 @@ TEST_CASE_FIXTURE(LogFixture, "Should report missing closing parenthesis for Str
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Last dataline not CRLF terminated"));
+  REQUIRE(res.error == ParseError::LastLineNotTerminated);
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Should compute FixedField with decimals and millivolt int_unit correctly") {
@@ -427,7 +430,7 @@ TEST_CASE_FIXTURE(LogFixture, "Should report last dataline not CRLF terminated")
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Last dataline not CRLF terminated"));
+  REQUIRE(res.error == ParseError::LastLineNotTerminated);
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Doesn't crash for a small packet") {
@@ -452,7 +455,7 @@ TEST_CASE_FIXTURE(LogFixture, "Doesn't crash for a small packet 2") {
 
   auto res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Last dataline not CRLF terminated"));
+  REQUIRE(res.error == ParseError::LastLineNotTerminated);
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Trailing characters on data line") {
@@ -462,8 +465,8 @@ TEST_CASE_FIXTURE(LogFixture, "Trailing characters on data line") {
   ParsedData</*String*/ identification, /*FixedValue*/ power_delivered> data;
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Trailing characters on data line"));
-  REQUIRE(log.contains(" trailing"));
+  REQUIRE(res.error == ParseError::TrailingCharacters);
+  REQUIRE(error_position(msg, res).starts_with(" trailing"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Unknown field ignored when unknown_error is false") {
@@ -482,8 +485,8 @@ TEST_CASE_FIXTURE(LogFixture, "Missing unit when required") {
   ParsedData</*String*/ identification, /*FixedValue*/ power_delivered> data;
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Missing unit"));
-  REQUIRE(log.contains(")"));
+  REQUIRE(res.error == ParseError::MissingUnit);
+  REQUIRE(error_position(msg, res).starts_with(")"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Unit present when not expected") {
@@ -493,8 +496,8 @@ TEST_CASE_FIXTURE(LogFixture, "Unit present when not expected") {
   ParsedData</*String*/ identification, /*uint32_t*/ electricity_failures> data;
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Extra data"));
-  REQUIRE(log.contains("*s)"));
+  REQUIRE(res.error == ParseError::ExtraData);
+  REQUIRE(error_position(msg, res).starts_with("*s)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Malformed packet that starts with ')'") {
@@ -510,7 +513,7 @@ TEST_CASE_FIXTURE(LogFixture, "Malformed packet that starts with ')'") {
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Unexpected ')' symbol"));
+  REQUIRE(res.error == ParseError::UnexpectedCloseParenthesis);
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Non-digit in numeric part") {
@@ -526,8 +529,8 @@ TEST_CASE_FIXTURE(LogFixture, "Non-digit in numeric part") {
 
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Missing unit"));
-  REQUIRE(log.contains("A23*kW)"));
+  REQUIRE(res.error == ParseError::InvalidNumber);
+  REQUIRE(error_position(msg, res).starts_with("A23*kW)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "OBIS id empty line") {
@@ -539,8 +542,8 @@ TEST_CASE_FIXTURE(LogFixture, "OBIS id empty line") {
   ParsedData</*String*/ identification, /*FixedValue*/ power_delivered> data;
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("OBIS id Empty"));
-  REQUIRE(log.contains("garbage"));
+  REQUIRE(res.error == ParseError::EmptyObisId);
+  REQUIRE(error_position(msg, res).starts_with("garbage"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Accepts LF-only line endings") {
@@ -610,8 +613,8 @@ TEST_CASE_FIXTURE(LogFixture, "Whitespace after OBIS ID") {
   ParsedData<gas_delivered> data;
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg), /*unknown_error=*/true);
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Missing ("));
-  REQUIRE(log.contains(" (000101000000W)(00000000.0000)"));
+  REQUIRE(res.error == ParseError::MissingOpenParenthesis);
+  REQUIRE(error_position(msg, res).starts_with(" (000101000000W)(00000000.0000)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Use integer fallback unit") {
@@ -673,7 +676,7 @@ TEST_CASE_FIXTURE(LogFixture, "Missing opening parenthesis for numeric field") {
   ParsedData</*String*/ identification, /*FixedValue*/ power_delivered> data;
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Missing ( ''"));
+  REQUIRE(res.error == ParseError::MissingOpenParenthesis);
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Non-digit in integer part of numeric field") {
@@ -685,8 +688,8 @@ TEST_CASE_FIXTURE(LogFixture, "Non-digit in integer part of numeric field") {
   ParsedData</*String*/ identification, /*FixedValue*/ power_delivered> data;
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Invalid number"));
-  REQUIRE(log.contains("A0.123*kW)"));
+  REQUIRE(res.error == ParseError::InvalidNumber);
+  REQUIRE(error_position(msg, res).starts_with("A0.123*kW)"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Unit too short for numeric field") {
@@ -698,8 +701,8 @@ TEST_CASE_FIXTURE(LogFixture, "Unit too short for numeric field") {
   ParsedData</*String*/ identification, /*FixedValue*/ energy_delivered_tariff1> data;
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Missing unit"));
-  REQUIRE(log.contains("kW)"));
+  REQUIRE(res.error == ParseError::InvalidUnit);
+  REQUIRE(error_position(msg, res).starts_with(")"));
 }
 
 TEST_CASE_FIXTURE(LogFixture, "Nested opening parenthesis") {
@@ -711,7 +714,7 @@ TEST_CASE_FIXTURE(LogFixture, "Nested opening parenthesis") {
   ParsedData</*String*/ identification, /*FixedValue*/ power_delivered> data;
   const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
   REQUIRE_FALSE(res);
-  REQUIRE(log.contains("Unexpected '(' symbol"));
+  REQUIRE(res.error == ParseError::UnexpectedOpenParenthesis);
 }
 
 TEST_CASE_FIXTURE(LogFixture, "ParsedData without any fields") {
@@ -727,3 +730,585 @@ TEST_CASE_FIXTURE(LogFixture, "ParsedData without any fields") {
   REQUIRE(res);
   REQUIRE(data.all_present());
 }
+
+namespace {
+template <typename F>
+constexpr bool has_obis_id = requires { F::id; };
+static_assert(has_obis_id<gas_delivered> && !has_obis_id<mbus_devices>);
+} // namespace
+
+TEST_CASE_FIXTURE(LogFixture, "Fields with the same OBIS id are resolved in favor of the first one") {
+  const auto& msg = "/identification\r\n"
+                    "0-1:24.2.1(251129203200W)(3.829*GJ)\r\n"
+                    "!";
+
+  SUBCASE("gas_delivered_gj first") {
+    ParsedData<gas_delivered_gj, gas_delivered> data;
+    const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg), /* unknown_error */ true);
+    REQUIRE(res);
+    REQUIRE(data.gas_delivered_gj == 3.829f);
+    REQUIRE_FALSE(data.gas_delivered_present);
+  }
+
+  SUBCASE("gas_delivered first") {
+    ParsedData<gas_delivered, gas_delivered_gj> data;
+    const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg), /* unknown_error */ true);
+    REQUIRE_FALSE(res);
+    REQUIRE(data.gas_delivered_present);
+    REQUIRE_FALSE(data.gas_delivered_gj_present);
+  }
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Both forms of a line are parsed into separate ParsedData") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "1-0:99.97.0(1)(0-0:96.7.19)(101208152415W)(0000000240*s)\r\n"
+                    "!";
+  ParsedData<electricity_failure_log> raw;
+  ParsedData<electricity_failure_log_entries> entries;
+  REQUIRE(DsmrParser::parse(DsmrUnencryptedTelegram(msg), raw, entries));
+  REQUIRE(raw.electricity_failure_log == "(1)(0-0:96.7.19)(101208152415W)(0000000240*s)");
+  REQUIRE(entries.electricity_failure_log_entries.size() == 1);
+  REQUIRE(entries.electricity_failure_log_entries[0].value == 240);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Values with uncommon layouts are parsed like the common ones") {
+  const auto& msg = "/KMP5 ZABF000000000000\r\n"
+                    "1-0:1.7.0(1.5*KW)\r\n"
+                    "1-0:2.7.0(0)\r\n"
+                    "1-0:1.8.1(12345*wh)\r\n"
+                    "1-0:1.8.2(000441879*Wh)\r\n"
+                    "1-0:2.8.1(0000441879*Wh)\r\n"
+                    "1-0:32.7.0(-230.1*V)\r\n"
+                    "1-0:31.7.0(00001234.5*A)\r\n"
+                    "!";
+  ParsedData<power_delivered, power_returned, energy_delivered_tariff1, energy_delivered_tariff2, energy_returned_tariff1, voltage_l1, current_l1> data;
+  const auto& res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg), /*unknown_error=*/true);
+  REQUIRE(res);
+  REQUIRE(data.power_delivered.int_val() == 1500);
+  REQUIRE(data.power_returned.int_val() == 0);
+  REQUIRE(data.energy_delivered_tariff1.int_val() == 12345);
+  REQUIRE(data.energy_delivered_tariff2.int_val() == 441879);
+  REQUIRE(data.energy_returned_tariff1.int_val() == 441879);
+  REQUIRE(data.voltage_l1.int_val() == -230100);
+  REQUIRE(data.current_l1.int_val() == 1234500);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Numeric values that don't fit the fast path report the same errors") {
+  int32_t value = 0;
+  ParseFailure failure;
+  SUBCASE("too many decimals") {
+    const std::string_view input = "(01.1234*kW)";
+    REQUIRE_FALSE(parse_float_or_int(value, 3, "kW", "W", input, failure));
+    REQUIRE(failure.error == ParseError::MissingUnit);
+    REQUIRE(failure.position == input.data() + 7);
+  }
+  SUBCASE("decimals with the integer unit") {
+    const std::string_view input = "(1.5*W)";
+    REQUIRE_FALSE(parse_float_or_int(value, 3, "kW", "W", input, failure));
+    REQUIRE(failure.error == ParseError::InvalidUnit);
+  }
+  SUBCASE("longer unit") {
+    const std::string_view input = "(1.000*kWh)";
+    REQUIRE_FALSE(parse_num(value, 3, "kW", input, failure));
+    REQUIRE(failure.error == ParseError::ExtraData);
+    REQUIRE(failure.position == input.data() + 9);
+  }
+  SUBCASE("truncated values") {
+    const std::string_view input = "(000441.879*kWh)";
+    for (size_t length = 0; length < input.size(); ++length) {
+      const std::string truncated(input.substr(0, length));
+      REQUIRE_FALSE(parse_num(value, 3, "kWh", truncated));
+    }
+    REQUIRE(parse_num(value, 3, "kWh", input) == std::string_view());
+    REQUIRE(value == 441879);
+  }
+}
+
+TEST_CASE_FIXTURE(LogFixture, "FixedProfileField stores every entry of the peak history") {
+  const auto& msg = "/KMP5 ZABF000000000000\r\n"
+                    "0-0:98.1.0(2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230202000000W)(230214224500W)(04529*W)\r\n"
+                    "!";
+  ParsedData<active_energy_import_maximum_demand_history> data;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg)));
+  const auto& history = data.active_energy_import_maximum_demand_history;
+  REQUIRE(history.size() == 2);
+  REQUIRE_FALSE(history.overflow);
+  REQUIRE(history[0].timestamp == "230117224500W");
+  REQUIRE(history[0].value.int_val() == 4329);
+  REQUIRE(history[1].timestamp == "230214224500W");
+  REQUIRE(history[1].value.int_val() == 4529);
+}
+
+namespace {
+using ShortHistory = ProfileArray<FixedValue, 1>;
+DEFINE_FIELD(short_history, ShortHistory, ObisId(0, 0, 98, 1, 0), FixedProfileField, units::kW, units::W);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "FixedProfileField sets the overflow flag for more entries than the capacity") {
+  const auto& msg = "/KMP5 ZABF000000000000\r\n"
+                    "0-0:98.1.0(2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230202000000W)(230214224500W)(04529*W)\r\n"
+                    "!";
+  ParsedData<short_history> data;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg)));
+  REQUIRE(data.short_history.size() == 1);
+  REQUIRE(data.short_history.overflow);
+  REQUIRE(data.short_history[0].value.int_val() == 4329);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "IntProfileField stores the entries of the power failure log") {
+  const auto& msg = "/KMP5 ZABF000000000000\r\n"
+                    "1-0:99.97.0(2)(0-0:96.7.19)(101208152415W)(0000000240*s)(101208151004W)(2147483647*s)\r\n"
+                    "!";
+  ParsedData<electricity_failure_log_entries> data;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg)));
+  const auto& failures = data.electricity_failure_log_entries;
+  REQUIRE(failures.size() == 2);
+  REQUIRE_FALSE(failures.overflow);
+  REQUIRE(failures[0].timestamp == "101208152415W");
+  REQUIRE(failures[0].value == 240);
+  REQUIRE(failures[1].timestamp == "101208151004W");
+  REQUIRE(failures[1].value == 2147483647);
+  size_t count = 0;
+  for (const auto& entry : failures)
+    count += entry.value > 0;
+  REQUIRE(count == 2);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "IntProfileField accepts an empty power failure log") {
+  const auto& msg = "/KMP5 ZABF000000000000\r\n"
+                    "1-0:99.97.0(0)(0-0:96.7.19)\r\n"
+                    "!";
+  ParsedData<electricity_failure_log_entries> data;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg)));
+  REQUIRE(data.electricity_failure_log_entries_present);
+  REQUIRE(data.electricity_failure_log_entries.empty());
+}
+
+TEST_CASE_FIXTURE(LogFixture, "IntProfileField reports an invalid entry") {
+  const std::string_view msg = "/KMP5 ZABF000000000000\r\n"
+                               "1-0:99.97.0(2)(0-0:96.7.19)(101208152415W)(0000000240*s)(101208151004W)(0000000301*m)\r\n"
+                               "!";
+  ParsedData<electricity_failure_log_entries> data;
+  const auto res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
+  REQUIRE(res.error == ParseError::InvalidUnit);
+  REQUIRE(msg.substr(res.offset).starts_with("m)"));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "MbusDevicesField finds the channels of the devices") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "1-0:1.7.0(00.318*kW)\r\n"
+                    "0-2:24.1.0(003)\r\n"
+                    "0-2:96.1.0(4730303339303031363532303530323136)\r\n"
+                    "0-2:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                    "0-3:24.1.0(007)\r\n"
+                    "0-3:96.1.1(3853414731323334353637383930)\r\n"
+                    "0-3:24.4.0(1)\r\n"
+                    "0-3:24.2.3(150117180000W)(00012345*dm3)\r\n"
+                    "!";
+  ParsedData<power_delivered, mbus_devices> data;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg), true));
+  REQUIRE(data.power_delivered.int_val() == 318);
+  REQUIRE(data.mbus_devices_present);
+
+  const auto& devices = data.mbus_devices;
+  REQUIRE(devices.channel(1) == nullptr);
+  REQUIRE(devices.channel(4) == nullptr);
+  REQUIRE(devices.channel(5) == nullptr);
+
+  const auto* gas = devices.find(MbusMedium::Gas);
+  REQUIRE(gas == devices.channel(2));
+  REQUIRE(gas->type == 3);
+  REQUIRE(gas->equipment_id == "4730303339303031363532303530323136");
+  REQUIRE(gas->delivered.int_val() == 473789);
+  REQUIRE(gas->delivered.timestamp == "150117180000W");
+  REQUIRE(std::string_view(gas->unit) == "m3");
+  REQUIRE_FALSE(gas->valve_position_present);
+
+  const auto* water = devices.find(MbusMedium::Water);
+  REQUIRE(water == devices.channel(3));
+  REQUIRE(water->type == 7);
+  REQUIRE(water->equipment_id == "3853414731323334353637383930");
+  REQUIRE(water->valve_position_present);
+  REQUIRE(water->valve_position == 1);
+  REQUIRE(water->delivered.int_val() == 12345);
+  REQUIRE(std::string_view(water->unit) == "m3");
+
+  REQUIRE(devices.find(MbusMedium::Thermal) == nullptr);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "MbusDevicesField takes the lines that no other field takes") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                    "0-2:24.1.0(004)\r\n"
+                    "0-2:24.2.1(150117180000W)(00001.250*GJ)\r\n"
+                    "!";
+  ParsedData<gas_delivered, mbus_devices> data;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg), true));
+  REQUIRE(data.gas_delivered.int_val() == 473789);
+  REQUIRE(data.mbus_devices.channel(1) == nullptr);
+  const auto* heat = data.mbus_devices.find(MbusMedium::Thermal);
+  REQUIRE(heat == data.mbus_devices.channel(2));
+  REQUIRE(heat->delivered.int_val() == 1250);
+  REQUIRE(std::string_view(heat->unit) == "GJ");
+}
+
+TEST_CASE_FIXTURE(LogFixture, "MbusDevicesField reports errors") {
+  SUBCASE("A duplicate line") {
+    const std::string_view msg = "/KFM5KAIFA-METER\r\n"
+                                 "\r\n"
+                                 "0-2:24.1.0(003)\r\n"
+                                 "0-2:24.1.0(007)\r\n"
+                                 "!";
+    ParsedData<mbus_devices> data;
+    const auto res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
+    REQUIRE(res.error == ParseError::DuplicateField);
+    REQUIRE(msg.substr(res.offset).starts_with("(007)"));
+  }
+  SUBCASE("A unit of another medium") {
+    const std::string_view msg = "/KFM5KAIFA-METER\r\n"
+                                 "\r\n"
+                                 "0-2:24.1.0(003)\r\n"
+                                 "0-2:24.2.1(150117180000W)(00001.250*GJ)\r\n"
+                                 "!";
+    ParsedData<mbus_devices> data;
+    const auto res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
+    REQUIRE(res.error == ParseError::InvalidUnit);
+    REQUIRE(res.id == ObisId(0, 2, 24, 2, 1));
+  }
+  SUBCASE("A reading without a device type") {
+    const std::string_view msg = "/KFM5KAIFA-METER\r\n"
+                                 "\r\n"
+                                 "0-4:24.2.1(150117180000W)(00012.500*kWh)\r\n"
+                                 "!";
+    ParsedData<mbus_devices> data;
+    const auto res = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg));
+    REQUIRE(res.error == ParseError::UnknownDeviceType);
+    REQUIRE(res.id == ObisId(0, 4, 24, 2, 1));
+    REQUIRE(msg.substr(res.offset).starts_with("(150117180000W)"));
+  }
+  SUBCASE("A reading of an unknown device type") {
+    const std::string_view msg = "/KFM5KAIFA-METER\r\n"
+                                 "\r\n"
+                                 "0-2:24.1.0(008)\r\n"
+                                 "0-2:24.2.1(150117180000W)(00012.500*kWh)\r\n"
+                                 "!";
+    ParsedData<mbus_devices> data;
+    REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg)).error == ParseError::UnknownDeviceType);
+  }
+  SUBCASE("Other lines are unknown") {
+    const auto& msg = "/KFM5KAIFA-METER\r\n"
+                      "\r\n"
+                      "0-5:24.1.0(003)\r\n"
+                      "!";
+    ParsedData<mbus_devices> data;
+    REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg), true).error == ParseError::UnknownField);
+    REQUIRE_FALSE(data.mbus_devices_present);
+  }
+}
+
+namespace {
+struct VisitedLine {
+  ObisId id;
+  ObisValue value;
+};
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::visit decodes the values of all lines without fields") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "1-3:0.2.8(40)\r\n"
+                    "0-0:96.1.1(0000000000000000000000000000000000)\r\n"
+                    "1-0:1.8.1(000671.578*kWh)\r\n"
+                    "1-0:2.7.0(-00.5*kw)\r\n"
+                    "0-0:96.13.0()\r\n"
+                    "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                    "1-0:99.97.0(1)(0-0:96.7.19)(101208152415W)(0000000240*s)\r\n"
+                    "1-0:0.0.0(4.2*VeryLongUnit)\r\n"
+                    "!";
+  std::array<VisitedLine, 16> lines{};
+  size_t count = 0;
+  REQUIRE(DsmrParser::visit(DsmrUnencryptedTelegram(msg), [&](const ObisId& id, const ObisValue& value) { lines.at(count++) = {id, value}; }));
+  REQUIRE(count == 9);
+
+  REQUIRE(lines[0].id == ObisId(255, 255, 255, 255, 255, 255));
+  REQUIRE(lines[0].value.kind == ObisValue::Kind::Raw);
+  REQUIRE(lines[0].value.text == "KFM5KAIFA-METER");
+
+  REQUIRE(lines[1].id == ObisId(1, 3, 0, 2, 8));
+  REQUIRE(lines[1].value.kind == ObisValue::Kind::Number);
+  REQUIRE(lines[1].value.number == 40);
+  REQUIRE(lines[1].value.decimals == 0);
+  REQUIRE(lines[1].value.unit.empty());
+
+  REQUIRE(lines[2].value.kind == ObisValue::Kind::String);
+  REQUIRE(lines[2].value.text == "0000000000000000000000000000000000");
+
+  REQUIRE(lines[3].value.kind == ObisValue::Kind::Number);
+  REQUIRE(lines[3].value.number == 671578);
+  REQUIRE(lines[3].value.decimals == 3);
+  REQUIRE(lines[3].value.unit == "kWh");
+
+  REQUIRE(lines[4].value.kind == ObisValue::Kind::Number);
+  REQUIRE(lines[4].value.number == -5);
+  REQUIRE(lines[4].value.decimals == 1);
+  REQUIRE(lines[4].value.unit == "kw");
+
+  REQUIRE(lines[5].value.kind == ObisValue::Kind::String);
+  REQUIRE(lines[5].value.text.empty());
+
+  REQUIRE(lines[6].id == ObisId(0, 1, 24, 2, 1));
+  REQUIRE(lines[6].value.kind == ObisValue::Kind::TimestampedNumber);
+  REQUIRE(lines[6].value.text == "150117180000W");
+  REQUIRE(lines[6].value.number == 473789);
+  REQUIRE(lines[6].value.decimals == 3);
+  REQUIRE(lines[6].value.unit == "m3");
+
+  REQUIRE(lines[7].value.kind == ObisValue::Kind::Raw);
+  REQUIRE(lines[7].value.text == "(1)(0-0:96.7.19)(101208152415W)(0000000240*s)");
+
+  REQUIRE(lines[8].value.kind == ObisValue::Kind::String);
+  REQUIRE(lines[8].value.text == "4.2*VeryLongUnit");
+}
+
+TEST_CASE_FIXTURE(LogFixture, "decode_obis_value only takes numbers that fit") {
+  REQUIRE(decode_obis_value("(999999999*Wh)").number == 999999999);
+  REQUIRE(decode_obis_value("(0000000240*s)").number == 240);
+  REQUIRE(decode_obis_value("(00000.001)").decimals == 3);
+  REQUIRE(decode_obis_value("(1234567890*Wh)").kind == ObisValue::Kind::String);
+  REQUIRE(decode_obis_value("(0000000000000)").kind == ObisValue::Kind::String);
+  REQUIRE(decode_obis_value("(12.*kW)").kind == ObisValue::Kind::String);
+  REQUIRE(decode_obis_value("(.5*kW)").kind == ObisValue::Kind::String);
+  REQUIRE(decode_obis_value("(5*)").kind == ObisValue::Kind::String);
+  REQUIRE(decode_obis_value("(5*kW").kind == ObisValue::Kind::Raw);
+  REQUIRE(decode_obis_value("(150117180000W)(abc)").kind == ObisValue::Kind::Raw);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::visit reports a telegram that can't be split into lines") {
+  const std::string_view msg = "/KFM5KAIFA-METER\r\n"
+                               "\r\n"
+                               "1-0:1.8.1(000671.578*kWh)\r\n"
+                               "1-0:1.8.2(000842.472*kWh\r\n"
+                               "!";
+  size_t count = 0;
+  const auto res = DsmrParser::visit(DsmrUnencryptedTelegram(msg), [&](const ObisId&, const ObisValue&) { ++count; });
+  REQUIRE_FALSE(res);
+  REQUIRE(count == 2);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::parse fills several views from one pass") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "1-0:1.8.1(000671.578*kWh)\r\n"
+                    "1-0:1.7.0(00.318*kW)\r\n"
+                    "1-0:32.32.0(00002)\r\n"
+                    "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                    "0-0:96.13.0()\r\n"
+                    "!";
+  ParsedData<energy_delivered_tariff1, gas_delivered> billing;
+  ParsedData<power_delivered, energy_delivered_tariff1> display;
+  ParsedData<electricity_sags_l1> diagnostics;
+  REQUIRE(DsmrParser::parse(DsmrUnencryptedTelegram(msg), billing, display, diagnostics));
+
+  REQUIRE(billing.all_present());
+  REQUIRE(billing.energy_delivered_tariff1.int_val() == 671578);
+  REQUIRE(billing.gas_delivered.int_val() == 473789);
+  REQUIRE(display.all_present());
+  REQUIRE(display.power_delivered.int_val() == 318);
+  REQUIRE(display.energy_delivered_tariff1.int_val() == 671578);
+  REQUIRE(diagnostics.all_present());
+  REQUIRE(diagnostics.electricity_sags_l1 == 2);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::parse with views gives the results of parsing each view") {
+  const std::string_view msg = "/KFM5KAIFA-METER\r\n"
+                               "\r\n"
+                               "0-0:1.0.0(150117185916W)\r\n"
+                               "0-2:24.1.0(003)\r\n"
+                               "0-2:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                               "1-0:1.7.0(00.318*kW)\r\n"
+                               "1-0:1.7.0(00.400*kW)\r\n"
+                               "!";
+  ParsedData<timestamp, power_delivered> texts;
+  ParsedData<timestamp, mbus_devices> decoded;
+  const auto res = DsmrParser::parse(DsmrUnencryptedTelegram(msg), texts, decoded);
+  REQUIRE(res.error == ParseError::DuplicateField);
+  REQUIRE(error_position(msg, res).starts_with("(00.400*kW)"));
+
+  // A field of both views is decoded once and copied, line fields are parsed by each view
+  REQUIRE(texts.timestamp == "150117185916W");
+  REQUIRE(decoded.timestamp == "150117185916W");
+  REQUIRE(decoded.mbus_devices.find(MbusMedium::Gas)->delivered.int_val() == 473789);
+}
+
+namespace {
+DEFINE_FIELD(gas_reading_time, std::string_view, ObisId(0, 1, 24, 2, 1), TimestampField);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::parse with views reports trailing characters of any view") {
+  const std::string_view msg = "/KFM5KAIFA-METER\r\n"
+                               "\r\n"
+                               "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                               "!";
+  ParsedData<gas_delivered> billing;
+  ParsedData<gas_reading_time> display;
+  auto res = DsmrParser::parse(DsmrUnencryptedTelegram(msg), billing, display);
+  REQUIRE(res.error == ParseError::TrailingCharacters);
+  REQUIRE(error_position(msg, res).starts_with("(00473.789*m3)"));
+
+  // The same error if the field that leaves them is in the first view
+  billing = {};
+  display = {};
+  res = DsmrParser::parse(DsmrUnencryptedTelegram(msg), display, billing);
+  REQUIRE(res.error == ParseError::TrailingCharacters);
+  REQUIRE(error_position(msg, res).starts_with("(00473.789*m3)"));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::parse with views reports lines that are in no view") {
+  const std::string_view msg = "/KFM5KAIFA-METER\r\n"
+                               "\r\n"
+                               "1-0:1.7.0(00.318*kW)\r\n"
+                               "1-0:32.32.0(00002)\r\n"
+                               "!";
+  ParsedData<power_delivered> display;
+  ParsedData<electricity_failures> diagnostics;
+  REQUIRE(DsmrParser::parse(DsmrUnencryptedTelegram(msg), display, diagnostics));
+
+  display = {};
+  diagnostics = {};
+  const auto res = DsmrParser::parse(DsmrUnencryptedTelegram(msg), true, nullptr, display, diagnostics);
+  REQUIRE(res.error == ParseError::UnknownField);
+  REQUIRE(error_position(msg, res).starts_with("1-0:32.32.0"));
+  REQUIRE(display.power_delivered.int_val() == 318);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::validate checks the structure without fields") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "1-0:1.8.1(000671.578*kWh)\r\n"
+                    "1-0:1.7.0(00.318*kW)\r\n"
+                    "0-0:96.13.0(303132333435363738393A3B3C3D3E3F303132333435363738393A3B3C3D3E3F\r\n"
+                    "303132333435363738393A3B3C3D3E3F)\r\n"
+                    "!";
+  const auto result = DsmrParser::validate(DsmrUnencryptedTelegram(msg));
+  REQUIRE(result);
+  REQUIRE(result.lines == 3);
+  REQUIRE(result.fingerprint == WordHash::calculate(msg));
+
+  // The values are not checked
+  REQUIRE(DsmrParser::validate(DsmrUnencryptedTelegram("/AAA5MTR\r\n1-0:1.7.0(00.318*XX)\r\n!")));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::validate reports structural errors") {
+  const std::string_view brackets = "/AAA5MTR\r\n1-0:1.7.0(00(318*kW)\r\n!";
+  auto result = DsmrParser::validate(DsmrUnencryptedTelegram(brackets));
+  REQUIRE(result.error == ParseError::UnexpectedOpenParenthesis);
+  REQUIRE(brackets.substr(result.offset).starts_with("(318"));
+
+  const std::string_view obis = "/AAA5MTR\r\n1-0:1.7.256(00.318*kW)\r\n!";
+  REQUIRE(DsmrParser::validate(DsmrUnencryptedTelegram(obis)).error == ParseError::ObisNumberOver255);
+
+  const std::string_view unterminated = "/AAA5MTR\r\n1-0:1.7.0(00.318*kW)!";
+  REQUIRE(DsmrParser::validate(DsmrUnencryptedTelegram(unterminated)).error == ParseError::LastLineNotTerminated);
+
+  REQUIRE(DsmrParser::validate(DsmrUnencryptedTelegram("AAA5MTR\r\n!")).error == ParseError::InvalidFrame);
+  REQUIRE(DsmrParser::validate(DsmrUnencryptedTelegram("")).error == ParseError::InvalidFrame);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::validate requires CRLF line endings") {
+  const std::string_view lf = "/AAA5MTR\n\n1-0:1.7.0(00.100*kW)\n!";
+  auto result = DsmrParser::validate(DsmrUnencryptedTelegram(lf));
+  REQUIRE(result.error == ParseError::InvalidLineEnding);
+  REQUIRE(result.offset == 8);
+
+  const std::string_view cr = "/AAA5MTR\r\r1-0:1.7.0(1)\r!";
+  result = DsmrParser::validate(DsmrUnencryptedTelegram(cr));
+  REQUIRE(result.error == ParseError::InvalidLineEnding);
+  REQUIRE(result.offset == 8);
+
+  const std::string_view lfcr = "/AAA5MTR\r\n1-0:1.7.0(1)\n\r!";
+  result = DsmrParser::validate(DsmrUnencryptedTelegram(lfcr));
+  REQUIRE(result.error == ParseError::InvalidLineEnding);
+  REQUIRE(lfcr.substr(result.offset).starts_with("\n\r!"));
+
+  // Also inside a value broken over two lines
+  const std::string_view continued = "/AAA5MTR\r\n0-1:24.3.0(120517020000)(08)\n(00124.477)\r\n!";
+  REQUIRE(DsmrParser::validate(DsmrUnencryptedTelegram(continued)).error == ParseError::InvalidLineEnding);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::validate requires an OBIS id followed by value groups") {
+  const std::string_view text_after_id = "/AAA5MTR\r\n1hello(1)\r\n!";
+  auto result = DsmrParser::validate(DsmrUnencryptedTelegram(text_after_id));
+  REQUIRE(result.error == ParseError::MissingOpenParenthesis);
+  REQUIRE(text_after_id.substr(result.offset).starts_with("hello(1)"));
+
+  const std::string_view no_value = "/AAA5MTR\r\n1-0:1.7.0\r\n!";
+  result = DsmrParser::validate(DsmrUnencryptedTelegram(no_value));
+  REQUIRE(result.error == ParseError::MissingOpenParenthesis);
+  REQUIRE(no_value.substr(result.offset).starts_with("\r\n!"));
+
+  const std::string_view trailing = "/AAA5MTR\r\n1-0:1.7.0(00.100*kW) \r\n!";
+  result = DsmrParser::validate(DsmrUnencryptedTelegram(trailing));
+  REQUIRE(result.error == ParseError::TrailingCharacters);
+  REQUIRE(trailing.substr(result.offset).starts_with(" \r\n!"));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser::validate checks the CRC of a received telegram") {
+  const std::string_view telegram = "/KFM5KAIFA-METER\r\n\r\n1-0:1.8.1(000671.578*kWh)\r\n1-0:1.7.0(00.318*kW)\r\n!";
+  const std::string packet = std::string(telegram) + "1E1D\r\n";
+  const auto result = DsmrParser::validate(std::string_view(packet));
+  REQUIRE(result);
+  REQUIRE(result.lines == 2);
+  REQUIRE(result.fingerprint == WordHash::calculate(telegram));
+  REQUIRE(DsmrParser::validate(std::string(telegram) + "1e1d"));
+
+  for (const auto* crc : {"1E1E\r\n", "1E1\r\n", "1E1X", "", "1E1D\r\nX"}) {
+    const auto invalid = DsmrParser::validate(std::string(telegram) + crc);
+    REQUIRE(invalid.error == ParseError::InvalidCrc);
+    REQUIRE(invalid.offset == telegram.size());
+  }
+  REQUIRE(DsmrParser::validate(std::string_view("/AAA5MTR\r\n")).error == ParseError::InvalidFrame);
+}
+
+TEST_CASE("WordHash::Stream gives the same hash as WordHash::calculate") {
+  const std::string text = "/AAA5MTR\r\n1-0:1.8.1(000671.578*kWh)\r\n1-0:1.8.2(000842.472*kWh)\r\n1-0:2.8.1(000000.000*kWh)\r\n!";
+  for (size_t size = 0; size <= text.size(); ++size) {
+    const std::string_view data(text.data(), size);
+    for (size_t step = 1; step <= 40; step += 13) {
+      WordHash::Stream stream(data, 7);
+      for (size_t end = 0; end <= size + step; end += step)
+        stream.update(end);
+      REQUIRE(stream.finish() == WordHash::calculate(data, 7));
+    }
+    REQUIRE(WordHash::Stream(data).finish() == WordHash::calculate(data));
+  }
+}
+
+TEST_CASE_FIXTURE(LogFixture, "The kernels take the groups of a value one at a time") {
+  const std::string_view value = "(2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230202000000W)(230214224500W)(04.529*kW)";
+
+  ParseFailure failure;
+  REQUIRE(find_last_value(ValueGroups(value, failure)) == "(04.529*kW)");
+
+  int32_t average = 0;
+  REQUIRE(parse_average(average, PackedUnit("kW"), PackedUnit("W"), ValueGroups(value, failure)) == "");
+  REQUIRE(average == 4429);
+  REQUIRE(failure.error == ParseError::None);
+
+  const std::string_view too_long = "(1)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(2301172245000000000000W)(04.329*kW)";
+  REQUIRE_FALSE(parse_average(average, PackedUnit("kW"), PackedUnit("W"), ValueGroups(too_long, failure)));
+  REQUIRE(failure.error == ParseError::InvalidStringLength);
+  REQUIRE(failure.position == too_long.data() + too_long.find("(2301"));
+
+  ParseFailure gap_failure;
+  const std::string_view gap = "(1)x(2)";
+  ValueGroups groups(gap, gap_failure);
+  std::string_view out;
+  REQUIRE(groups.string(out, 0, 5) == "x(2)");
+  REQUIRE(out == "1");
+  REQUIRE_FALSE(groups.string(out, 0, 5));
+  REQUIRE(gap_failure.error == ParseError::MissingOpenParenthesis);
+  REQUIRE(gap_failure.position == gap.data() + 3);
+}
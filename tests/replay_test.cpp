@@ -0,0 +1,92 @@
+#include "dsmr_parser/fields.h"
+#include "replay/replay.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+using namespace dsmr_parser;
+using namespace dsmr_parser::fields;
+using namespace dsmr_replay;
+
+namespace {
+using Data = ParsedData<identification, power_delivered>;
+
+// Leaves the data as is. Fails if the tag is not all zeros.
+class FakeGcmDecryptor final : public Aes128GcmDecryptor {
+public:
+  void set_encryption_key(const Aes128GcmDecryptionKey&) override {}
+  bool decrypt_inplace(std::span<const uint8_t, 17>, std::span<const uint8_t, 12>, std::span<uint8_t>, std::span<const uint8_t, 12> tag) override {
+    return std::ranges::all_of(tag, [](uint8_t b) { return b == 0; });
+  }
+};
+
+std::string make_telegram(size_t i, bool valid = true) {
+  const auto body = "/AAA5MTR" + std::to_string(i) + "\r\n1-0:1.7.0(" + std::to_string(i % 100) + ".000*kW)\r\n" + (valid ? "" : "1-0:1.7.0(1)\r\n") + "!";
+  char crc[8];
+  std::snprintf(crc, sizeof(crc), "%04X\r\n", Crc16::calculate(body));
+  return body + crc;
+}
+
+void append_dlms_packet(std::vector<uint8_t>& capture, std::string_view telegram, bool valid_tag) {
+  const auto total_length = telegram.size() + 5 + 12;
+  const uint8_t header[] = {0xDB, 0x08, 'S', 'Y', 'S', 'T', 'E', 'M', 'I', 'D', 0x82, static_cast<uint8_t>(total_length >> 8),
+                            static_cast<uint8_t>(total_length & 0xFF), 0x30, 0, 0, 0, 1};
+  capture.insert(capture.end(), std::begin(header), std::end(header));
+  capture.insert(capture.end(), telegram.begin(), telegram.end());
+  capture.insert(capture.end(), 12, valid_tag ? 0 : 1);
+}
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Plaintext replay returns the telegrams in order") {
+  std::string capture = "noise";
+  std::vector<size_t> offsets;
+  for (size_t i = 0; i < 200; ++i) {
+    if (i % 7 == 3)
+      capture += "/AAA5MTR\r\n1-0:1.7.0(1.000*kW)\r\n!0000\r\n"; // CRC mismatch, skipped
+    offsets.push_back(capture.size());
+    capture += make_telegram(i, i % 10 != 5);
+  }
+
+  ReplayOptions options;
+  options.threads = 4;
+  options.chunk_size = 100;
+  std::vector<std::string> identifications;
+  std::vector<size_t> replayed_offsets;
+  const auto stats = replay_plaintext<Data>(capture, options, [&](const ReplayedTelegram<Data>& telegram) {
+    replayed_offsets.push_back(telegram.offset);
+    identifications.emplace_back(telegram.data.identification);
+    REQUIRE((telegram.status == TelegramStatus::Ok) == (identifications.size() % 10 != 6));
+  });
+
+  REQUIRE(stats.telegrams == 200);
+  REQUIRE(stats.parse_errors == 20);
+  REQUIRE(replayed_offsets == offsets);
+  for (size_t i = 0; i < identifications.size(); ++i)
+    REQUIRE(identifications[i] == "AAA5MTR" + std::to_string(i));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DLMS replay returns the telegrams in order") {
+  std::vector<uint8_t> capture = {1, 2, 3};
+  for (size_t i = 0; i < 100; ++i) {
+    const auto telegram = make_telegram(i);
+    append_dlms_packet(capture, telegram, i % 10 != 9);
+    if (i % 13 == 0)
+      capture.push_back(0xDB); // noise between packets
+  }
+
+  ReplayOptions options;
+  options.threads = 3;
+  options.chunk_size = 200;
+  std::vector<std::string> identifications;
+  const auto key = *Aes128GcmDecryptionKey::from_hex("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA");
+  const auto stats = replay_dlms<Data, FakeGcmDecryptor>(capture, key, options, [&](const ReplayedTelegram<Data>& telegram) {
+    REQUIRE(capture[telegram.offset] == 0xDB);
+    identifications.emplace_back(telegram.status == TelegramStatus::Ok ? std::string(telegram.data.identification) : "error");
+  });
+
+  REQUIRE(stats.telegrams == 100);
+  REQUIRE(stats.decryption_errors == 10);
+  for (size_t i = 0; i < identifications.size(); ++i)
+    REQUIRE(identifications[i] == (i % 10 != 9 ? "AAA5MTR" + std::to_string(i) : "error"));
+}
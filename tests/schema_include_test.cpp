@@ -0,0 +1,11 @@
+// This code tests that the schema header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/schema.h"
+
+void SchemaParser_some_function() {
+  uint16_t slots[4];
+  dsmr_parser::SchemaParser::Units units[1];
+  dsmr_parser::SchemaParser parser(slots, units);
+  parser.compile({}, 0);
+}
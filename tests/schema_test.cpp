@@ -0,0 +1,209 @@
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/schema.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+namespace {
+
+const std::string_view telegram = "/KFM5KAIFA-METER\r\n"
+                                  "\r\n"
+                                  "1-3:0.2.8(40)\r\n"
+                                  "0-0:1.0.0(150117185916W)\r\n"
+                                  "1-0:1.8.1(000671.578*kWh)\r\n"
+                                  "1-0:1.7.0(00.318*kW)\r\n"
+                                  "0-0:96.7.21(00004)\r\n"
+                                  "0-0:98.1.0(2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230202000000W)(230214224500W)(04.529*kW)\r\n"
+                                  "1-0:1.6.0(230201000000W)(04.329*kW)\r\n"
+                                  "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                                  "!";
+
+// The values of a meter configuration that is only known at runtime
+struct MeterValues {
+  std::string_view identification;
+  bool identification_present;
+  std::string_view p1_version;
+  bool p1_version_present;
+  std::string_view timestamp;
+  bool timestamp_present;
+  FixedValue energy_delivered_tariff1;
+  bool energy_delivered_tariff1_present;
+  FixedValue power_delivered;
+  bool power_delivered_present;
+  uint32_t electricity_failures;
+  bool electricity_failures_present;
+  FixedValue max_demand;
+  bool max_demand_present;
+  FixedValue last_demand;
+  bool last_demand_present;
+  FixedValue gas_delivered;
+  bool gas_delivered_present;
+  std::string_view gas_timestamp;
+};
+
+#define VALUE(name) offsetof(MeterValues, name), offsetof(MeterValues, name##_present)
+
+constexpr std::array schema = {
+    SchemaField::raw(ObisId(255, 255, 255, 255, 255, 255), VALUE(identification)),
+    SchemaField::string(ObisId(1, 3, 0, 2, 8), 2, 2, VALUE(p1_version)),
+    SchemaField::timestamp(ObisId(0, 0, 1, 0, 0), VALUE(timestamp)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 1, 8, 1), units::kWh, units::Wh, VALUE(energy_delivered_tariff1)),
+    SchemaField::fixed(FieldKind::Fixed, ObisId(1, 0, 1, 7, 0), units::kW, units::W, VALUE(power_delivered)),
+    SchemaField::integer(ObisId(0, 0, 96, 7, 21), units::none, VALUE(electricity_failures)),
+    SchemaField::fixed(FieldKind::AveragedFixed, ObisId(0, 0, 98, 1, 0), units::kW, units::W, VALUE(max_demand)),
+    SchemaField::fixed(FieldKind::LastFixed, ObisId(1, 0, 1, 6, 0), units::kW, units::W, VALUE(last_demand)),
+    SchemaField::timestamped_fixed(ObisId(0, 1, 24, 2, 1), units::m3, units::dm3, VALUE(gas_delivered), offsetof(MeterValues, gas_timestamp)),
+};
+
+}
+
+TEST_CASE_FIXTURE(LogFixture, "SchemaParser parses the same values as ParsedData") {
+  std::array<uint16_t, SchemaParser::slot_count(schema.size())> slots;
+  std::array<SchemaParser::Units, schema.size()> units;
+  SchemaParser parser(slots, units);
+  REQUIRE(parser.compile(schema, sizeof(MeterValues)));
+
+  MeterValues values{};
+  REQUIRE(parser.parse(&values, DsmrUnencryptedTelegram(telegram)));
+
+  ParsedData<identification, p1_version, timestamp, energy_delivered_tariff1, power_delivered, electricity_failures,
+             active_energy_import_maximum_demand_last_13_months, gas_delivered>
+      data;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(telegram)));
+
+  REQUIRE(values.identification == data.identification);
+  REQUIRE(values.p1_version == data.p1_version);
+  REQUIRE(values.timestamp == data.timestamp);
+  REQUIRE(values.energy_delivered_tariff1.int_val() == data.energy_delivered_tariff1.int_val());
+  REQUIRE(values.power_delivered.int_val() == data.power_delivered.int_val());
+  REQUIRE(values.electricity_failures == data.electricity_failures);
+  REQUIRE(values.max_demand.int_val() == data.active_energy_import_maximum_demand_last_13_months.int_val());
+  REQUIRE(values.last_demand.int_val() == 4329);
+  REQUIRE(values.gas_delivered.int_val() == data.gas_delivered.int_val());
+  REQUIRE(values.gas_timestamp == data.gas_delivered.timestamp);
+  REQUIRE(values.identification_present);
+  REQUIRE(values.gas_delivered_present);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "SchemaParser reports errors like DsmrParser") {
+  std::array<uint16_t, SchemaParser::slot_count(schema.size())> slots;
+  std::array<SchemaParser::Units, schema.size()> units;
+  SchemaParser parser(slots, units);
+  REQUIRE(parser.compile(schema, sizeof(MeterValues)));
+
+  SUBCASE("Invalid unit") {
+    const std::string_view msg = "/AAA5MTR\r\n1-0:1.7.0(00.318*kVA)\r\n!";
+    MeterValues values{};
+    const auto res = parser.parse(&values, DsmrUnencryptedTelegram(msg));
+    REQUIRE(res.error == ParseError::InvalidUnit);
+    REQUIRE(res.id == ObisId(1, 0, 1, 7, 0));
+  }
+
+  SUBCASE("Duplicate field") {
+    const std::string_view msg = "/AAA5MTR\r\n1-0:1.7.0(00.318*kW)\r\n1-0:1.7.0(00.318*kW)\r\n!";
+    MeterValues values{};
+    REQUIRE(parser.parse(&values, DsmrUnencryptedTelegram(msg)).error == ParseError::DuplicateField);
+  }
+
+  SUBCASE("Unknown field") {
+    const std::string_view msg = "/AAA5MTR\r\n1-0:2.7.0(00.318*kW)\r\n!";
+    MeterValues values{};
+    REQUIRE(parser.parse(&values, DsmrUnencryptedTelegram(msg)));
+    values = {};
+    REQUIRE(parser.parse(&values, DsmrUnencryptedTelegram(msg), /*unknown_error=*/true).error == ParseError::UnknownField);
+  }
+}
+
+TEST_CASE_FIXTURE(LogFixture, "SchemaParser rejects schemas that don't fit") {
+  SUBCASE("Too few slots") {
+    std::array<uint16_t, 8> slots;
+    std::array<SchemaParser::Units, schema.size()> units;
+    SchemaParser parser(slots, units);
+    REQUIRE_FALSE(parser.compile(schema, sizeof(MeterValues)));
+    REQUIRE(log.contains("The schema has too many fields"));
+
+    // A failed compile leaves an empty schema, that ignores all lines
+    MeterValues values{};
+    REQUIRE(parser.parse(&values, DsmrUnencryptedTelegram(telegram)));
+    REQUIRE_FALSE(values.power_delivered_present);
+  }
+
+  SUBCASE("Too few units") {
+    std::array<uint16_t, SchemaParser::slot_count(schema.size())> slots;
+    std::array<SchemaParser::Units, schema.size() - 1> units;
+    SchemaParser parser(slots, units);
+    REQUIRE_FALSE(parser.compile(schema, sizeof(MeterValues)));
+    REQUIRE(log.contains("units of 8 fields, 9 are needed"));
+  }
+
+  SUBCASE("Unsupported integer size") {
+    const std::array fields = {SchemaField::integer(ObisId(0, 0, 96, 7, 21), units::none, VALUE(electricity_failures), 3)};
+    std::array<uint16_t, SchemaParser::slot_count(fields.size())> slots;
+    std::array<SchemaParser::Units, fields.size()> units;
+    SchemaParser parser(slots, units);
+    REQUIRE_FALSE(parser.compile(fields, sizeof(MeterValues)));
+    REQUIRE(log.contains("has 3 bytes"));
+  }
+
+  SUBCASE("Field outside of the struct") {
+    std::array<uint16_t, SchemaParser::slot_count(schema.size())> slots;
+    std::array<SchemaParser::Units, schema.size()> units;
+    SchemaParser parser(slots, units);
+    REQUIRE_FALSE(parser.compile(schema, offsetof(MeterValues, gas_timestamp)));
+    REQUIRE(log.contains("outside of the struct"));
+  }
+}
+
+TEST_CASE_FIXTURE(LogFixture, "SchemaParser finds every field of a large schema") {
+  struct Values {
+    std::array<uint32_t, 200> values;
+    std::array<bool, 200> present;
+  };
+  std::array<SchemaField, 200> fields{};
+  for (size_t i = 0; i < fields.size(); ++i) {
+    fields[i] = SchemaField::integer(ObisId(1, 0, static_cast<uint8_t>(i), 7, 0), units::none, offsetof(Values, values) + i * sizeof(uint32_t),
+                                     offsetof(Values, present) + i);
+  }
+  std::array<uint16_t, SchemaParser::slot_count(200)> slots;
+  std::array<SchemaParser::Units, 200> units;
+  SchemaParser parser(slots, units);
+  REQUIRE(parser.compile(fields, sizeof(Values)));
+  for (size_t i = 0; i < fields.size(); ++i)
+    REQUIRE(parser.find_field(fields[i].id) == &fields[i]);
+  REQUIRE(parser.find_field(ObisId(1, 0, 1, 8, 0)) == nullptr);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "SchemaParser writes integers of the size of the field") {
+  struct Values {
+    uint8_t small;
+    bool small_present;
+    uint16_t medium;
+    bool medium_present;
+    uint32_t large;
+    bool large_present;
+    uint8_t next; // not overwritten by `small`
+  };
+  const std::array fields = {
+      SchemaField::integer(ObisId(0, 0, 96, 7, 21), units::none, offsetof(Values, small), offsetof(Values, small_present), sizeof(uint8_t)),
+      SchemaField::integer(ObisId(0, 0, 96, 7, 9), units::none, offsetof(Values, medium), offsetof(Values, medium_present), sizeof(uint16_t)),
+      SchemaField::integer(ObisId(1, 0, 32, 32, 0), units::none, offsetof(Values, large), offsetof(Values, large_present)),
+  };
+  std::array<uint16_t, SchemaParser::slot_count(fields.size())> slots;
+  std::array<SchemaParser::Units, fields.size()> units;
+  SchemaParser parser(slots, units);
+  REQUIRE(parser.compile(fields, sizeof(Values)));
+
+  const std::string_view msg = "/AAA5MTR\r\n0-0:96.7.21(00004)\r\n0-0:96.7.9(01000)\r\n1-0:32.32.0(70000)\r\n!";
+  Values values{};
+  values.next = 42;
+  REQUIRE(parser.parse(&values, DsmrUnencryptedTelegram(msg)));
+  REQUIRE(values.small == 4);
+  REQUIRE(values.medium == 1000);
+  REQUIRE(values.large == 70000);
+  REQUIRE(values.next == 42);
+}
@@ -0,0 +1,9 @@
+// This code tests that the stats header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/stats.h"
+
+void ParserStats_some_function() {
+  dsmr_parser::ParserStats stats;
+  dsmr_parser::StatsHandle(&stats).count(&dsmr_parser::ParserStats::bytes);
+}
@@ -0,0 +1,145 @@
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/packet_accumulator.h"
+#include "dsmr_parser/parser.h"
+#include "dsmr_parser/stats.h"
+#include "dsmr_parser/streaming_parser.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace dsmr_parser;
+using namespace dsmr_parser::fields;
+
+// The test target is built with DSMR_PARSER_STATS=1
+static_assert(kStatsEnabled);
+
+namespace {
+void feed(PacketAccumulator& accumulator, std::string_view bytes) {
+  for (const char byte : bytes)
+    accumulator.process_byte(static_cast<uint8_t>(byte));
+}
+
+bool parse(std::string_view telegram, ParserStats& stats, bool unknown_error = false) {
+  ParsedData<identification, power_delivered, voltage_l1> data;
+  return static_cast<bool>(DsmrParser::parse(data, DsmrUnencryptedTelegram(telegram), unknown_error, &stats));
+}
+}
+
+TEST_CASE_FIXTURE(LogFixture, "PacketAccumulator counts bytes, telegrams and rejects") {
+  std::vector<uint8_t> buffer(100);
+  PacketAccumulator accumulator(buffer, true);
+  ParserStats stats;
+  accumulator.set_stats(&stats);
+
+  const std::string overflow = "/" + std::string(120, 'x');
+  const std::string input = "garbage"
+                                 "/KFM5KAIFA-METER\r\n\r\n1-0:1.8.1(000671.578*kWh)\r\n1-0:1.7.0(00.318*kW)\r\n!1E1D\r\n" // ok
+                                 "/some data!0000"                                                                 // CRC mismatch
+                                 "/some data!G"                                                                    // incorrect CRC character
+                            + overflow;                                                                            // buffer overflow
+  feed(accumulator, input);
+  REQUIRE(stats.bytes.value() == input.size());
+  REQUIRE(stats.telegrams.value() == 1);
+  REQUIRE(stats.crc_errors.value() == 2);
+  REQUIRE(stats.buffer_overflows.value() == 1);
+
+  stats.reset();
+  REQUIRE(stats.bytes.value() == 0);
+  accumulator.set_stats(nullptr);
+  feed(accumulator, "/a!");
+  REQUIRE(stats.bytes.value() == 0);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser counts parse errors by reason") {
+  ParserStats stats;
+  REQUIRE(parse("/AAA5MTR\r\n\r\n1-0:1.7.0(00.318*kW)\r\n1-0:32.7.0(230.1*V)\r\n1-0:2.7.0(00.000*kW)\r\n!", stats));
+  REQUIRE_FALSE(parse("/AAA5MTR\r\n\r\n1-0:1.7.0(00.318*kW)\r\n1-0:1.7.0(00.318*kW)\r\n!", stats));
+  REQUIRE_FALSE(parse("/AAA5MTR\r\n\r\n1-0:1.7.0(00.318*V)\r\n!", stats));
+  REQUIRE_FALSE(parse("/AAA5MTR\r\n\r\n1-0:1.7.0(00.318*kW)x\r\n!", stats));
+  REQUIRE_FALSE(parse("/AAA5MTR\r\n\r\n1-0:2.7.0(00.000*kW)\r\n!", stats, true));
+  REQUIRE_FALSE(parse("/AAA5MTR\r\n\r\n1-0:1.7.0(00.318*kW)\r\n1-0:1.7.0(00.318*kW!", stats));
+  REQUIRE_FALSE(parse("/AAA5MTR\r\n\r\n1-0:256.7.0(00.318*kW)\r\n!", stats));
+
+  REQUIRE(stats.parsed_telegrams.value() == 1);
+  REQUIRE(stats.parse_errors.value() == 6);
+  REQUIRE(stats.duplicate_fields.value() == 1);
+  REQUIRE(stats.invalid_values.value() == 1);
+  REQUIRE(stats.trailing_characters.value() == 1);
+  REQUIRE(stats.unknown_fields.value() == 1);
+  REQUIRE(stats.invalid_lines.value() == 2);
+  REQUIRE(stats.unknown_obis_ids.value() == 2);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "DsmrParser counts the results of parsing into views") {
+  ParserStats stats;
+  ParsedData<identification, power_delivered> display;
+  ParsedData<voltage_l1> diagnostics;
+  const std::string_view telegram = "/AAA5MTR\r\n\r\n1-0:1.7.0(00.318*kW)\r\n1-0:32.7.0(230.1*V)\r\n1-0:2.7.0(00.000*kW)\r\n!";
+  REQUIRE(DsmrParser::parse(DsmrUnencryptedTelegram(telegram), false, &stats, display, diagnostics));
+  display = {};
+  diagnostics = {};
+  REQUIRE_FALSE(DsmrParser::parse(DsmrUnencryptedTelegram(telegram), true, &stats, display, diagnostics));
+
+  REQUIRE(stats.parsed_telegrams.value() == 1);
+  REQUIRE(stats.parse_errors.value() == 1);
+  REQUIRE(stats.unknown_fields.value() == 1);
+  REQUIRE(stats.unknown_obis_ids.value() == 2);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "StreamingParser counts like PacketAccumulator followed by DsmrParser") {
+  std::vector<uint8_t> buffer(1000);
+  StreamingParser<identification, power_delivered> parser(buffer, false);
+  ParserStats stats;
+  parser.set_stats(&stats);
+
+  const std::string_view input = "/AAA5MTR\r\n\r\n1-0:1.7.0(00.318*kW)\r\n!"
+                                 "/AAA5MTR\r\n\r\n1-0:1.7.0(00.318*kW)\r\n1-0:1.7.0(00.318*kW)\r\n!"
+                                 "/AAA5MTR\r\n\r\n1-0:1.7.0)1)\r\n!";
+  for (const char byte : input)
+    parser.process_byte(static_cast<uint8_t>(byte));
+  REQUIRE(stats.bytes.value() == input.size());
+  REQUIRE(stats.telegrams.value() == 3);
+  REQUIRE(stats.parsed_telegrams.value() == 1);
+  REQUIRE(stats.parse_errors.value() == 2);
+  REQUIRE(stats.duplicate_fields.value() == 1);
+  REQUIRE(stats.invalid_lines.value() == 1);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "StreamingParser counts no reasons for a telegram with a wrong CRC") {
+  std::vector<uint8_t> buffer(1000);
+  StreamingParser<identification, power_delivered> parser(buffer, true);
+  ParserStats stats;
+  parser.set_stats(&stats);
+
+  const std::string_view input = "/AAA5MTR\r\n\r\n1-0:2.7.0(00.000*kW)\r\n1-0:1.7.0(00.318*kW)\r\n1-0:1.7.0(00.318*kW)\r\n!0000\r\n";
+  for (const char byte : input)
+    parser.process_byte(static_cast<uint8_t>(byte));
+  REQUIRE(stats.crc_errors.value() == 1);
+  REQUIRE(stats.parse_errors.value() == 0);
+  REQUIRE(stats.duplicate_fields.value() == 0);
+  REQUIRE(stats.unknown_obis_ids.value() == 0);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Stats can be read while another thread updates them") {
+  ParserStats stats;
+  std::vector<uint8_t> buffer(100);
+  PacketAccumulator accumulator(buffer, false);
+  accumulator.set_stats(&stats);
+
+  constexpr uint32_t kTelegrams = 10000;
+  std::jthread writer([&] {
+    for (uint32_t i = 0; i < kTelegrams; ++i)
+      feed(accumulator, "/a!");
+  });
+  uint32_t last = 0;
+  while (last < kTelegrams) {
+    const auto telegrams = stats.telegrams.value();
+    REQUIRE(telegrams >= last);
+    last = telegrams;
+  }
+  writer.join();
+  REQUIRE(stats.bytes.value() == 3 * kTelegrams);
+}
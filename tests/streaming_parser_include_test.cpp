@@ -0,0 +1,10 @@
+// This code tests that the streaming_parser header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/streaming_parser.h"
+
+void StreamingParser_some_function() {
+  uint8_t buffer[10];
+  dsmr_parser::StreamingParser<> parser(buffer, true);
+  parser.process_byte('/');
+}
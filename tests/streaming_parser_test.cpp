@@ -0,0 +1,127 @@
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/streaming_parser.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <string_view>
+#include <vector>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+namespace {
+using Data = ParsedData<identification, p1_version, power_delivered, gas_delivered_text, fw_core_version>;
+
+const auto telegram = "/KFM5KAIFA-METER\r\n"
+                      "\r\n"
+                      "1-3:0.2.8(40)\r\n"
+                      "1-0:1.7.0(00.318*kW)\r\n"
+                      "0-1:24.3.0(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)\r\n"
+                      "(00124.477)\r\n"
+                      "1-0:0.2.0((ER11))\r\n"
+                      "!ED21\r\n";
+
+template <typename Parser>
+std::optional<DsmrUnencryptedTelegram> feed(Parser& parser, std::string_view bytes) {
+  std::optional<DsmrUnencryptedTelegram> result;
+  for (const char byte : bytes) {
+    if (const auto res = parser.process_byte(static_cast<uint8_t>(byte)))
+      result = res;
+  }
+  return result;
+}
+
+void check_values(const Data& data) {
+  REQUIRE(data.identification == "KFM5KAIFA-METER");
+  REQUIRE(data.p1_version == "40");
+  REQUIRE(data.power_delivered == 0.318f);
+  REQUIRE(data.gas_delivered_text == "(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)\r\n(00124.477)");
+  REQUIRE(data.fw_core_version == "(ER11)");
+}
+}
+
+TEST_CASE_FIXTURE(LogFixture, "StreamingParser parses a telegram") {
+  std::vector<uint8_t> buffer(1000);
+  StreamingParser<identification, p1_version, power_delivered, gas_delivered_text, fw_core_version> parser(buffer, true);
+
+  const auto result = feed(parser, telegram);
+  REQUIRE(result);
+  REQUIRE(result->content() == std::string_view(telegram).substr(0, std::string_view(telegram).find('!') + 1));
+  check_values(parser.data());
+  auto data = parser.data();
+  REQUIRE(data.all_present());
+}
+
+TEST_CASE_FIXTURE(LogFixture, "StreamingParser gives the same result as DsmrParser::parse") {
+  std::vector<uint8_t> buffer(1000);
+  StreamingParser<identification, p1_version, power_delivered, gas_delivered_text, fw_core_version> parser(buffer, false);
+  REQUIRE(feed(parser, telegram));
+
+  Data data;
+  const std::string_view msg = telegram;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg.substr(0, msg.find('!') + 1))));
+  check_values(data);
+  check_values(parser.data());
+}
+
+TEST_CASE_FIXTURE(LogFixture, "StreamingParser parses lines before the end of the telegram") {
+  std::vector<uint8_t> buffer(1000);
+  StreamingParser<identification, power_delivered> parser(buffer, false);
+
+  REQUIRE_FALSE(feed(parser, "/AAA5MTR\r\n"
+                             "1-0:1.7.0(00.318*kW)\r\n"
+                             "1-0:1.7.0(00.318*kW)\r\n"
+                             "1-0"));
+  REQUIRE(parser.error().error == ParseError::DuplicateField);
+  REQUIRE(parser.error().offset == 41);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "StreamingParser keeps the previous values if a telegram is invalid") {
+  std::vector<uint8_t> buffer(1000);
+  StreamingParser<identification, p1_version, power_delivered, gas_delivered_text, fw_core_version> parser(buffer, true);
+  REQUIRE(feed(parser, telegram));
+
+  SUBCASE("CRC mismatch") {
+    REQUIRE_FALSE(feed(parser, "/XXX5MTR\r\n1-0:1.7.0(00.100*kW)\r\n!0000\r\n"));
+    REQUIRE(log.contains("CRC mismatch"));
+  }
+
+  SUBCASE("Parse error") {
+    REQUIRE_FALSE(feed(parser, "/XXX5MTR\r\n1-0:1.7.0(00.100*XX)\r\n!0000\r\n"));
+    REQUIRE(parser.error().error == ParseError::InvalidUnit);
+    REQUIRE(parser.error().id == ObisId(1, 0, 1, 7, 0));
+  }
+
+  SUBCASE("Telegram restarted") {
+    REQUIRE_FALSE(feed(parser, "/XXX5MTR\r\n1-0:1.7.0(00.100*kW)\r\n"));
+    REQUIRE(feed(parser, telegram));
+  }
+
+  SUBCASE("Buffer overflow") {
+    std::vector<uint8_t> small_buffer(20);
+    StreamingParser<identification, p1_version, power_delivered, gas_delivered_text, fw_core_version> small_parser(small_buffer, true);
+    REQUIRE_FALSE(feed(small_parser, telegram));
+    REQUIRE(log.contains("Buffer overflow"));
+    REQUIRE_FALSE(small_parser.data().identification_present);
+    return;
+  }
+
+  // String values point into the buffer, which now holds the new telegram
+  REQUIRE(parser.data().power_delivered == 0.318f);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "StreamingParser reports the same errors as DsmrParser::parse") {
+  for (const std::string_view msg : {"/AAA5MTR\r\n1-0:1.7.0(00.318*kW)!", "/AAA5MTR!", "/!", "/AAA5MTR\r\n1-0:1.7.0(1(2)\r\n!",
+                                     "/AAA5MTR\r\n1-0:1.7.0)1)\r\n!", "/AAA5MTR\r\n1-0:256.7.0(00.318*kW)\r\n!", "/AAA5MTR\r\n(1)\r\n!",
+                                     "/AAA5MTR\r\n1-0:1.7.0(00.318*kW)\r\n1-0:2.7.0(00.318*kW)\r\n!", "/AAA5MTR\r\n1-0:1.7.0(00.318*kW)\r\n\r\n(1)\r\n!"}) {
+    CAPTURE(msg);
+    ParsedData<identification, power_delivered> data;
+    const auto expected = DsmrParser::parse(data, DsmrUnencryptedTelegram(msg), true);
+
+    std::vector<uint8_t> buffer(1000);
+    StreamingParser<identification, power_delivered> parser(buffer, false, true);
+    const auto result = feed(parser, msg);
+
+    REQUIRE(result.has_value() == static_cast<bool>(expected));
+    REQUIRE(parser.error() == expected);
+  }
+}
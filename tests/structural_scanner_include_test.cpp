@@ -0,0 +1,6 @@
+// This code tests that the structural_scanner header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/structural_scanner.h"
+
+void StructuralScanner_some_function() { dsmr_parser::StructuralScanner("msg").next(); }
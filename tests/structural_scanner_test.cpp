@@ -0,0 +1,77 @@
+#include "dsmr_parser/structural_scanner.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace dsmr_parser;
+
+namespace {
+std::vector<size_t> scan_all(std::string_view input) {
+  std::vector<size_t> positions;
+  StructuralScanner scanner(input);
+  for (size_t pos = scanner.next(); pos != StructuralScanner::npos; pos = scanner.next())
+    positions.push_back(pos);
+  return positions;
+}
+
+std::vector<size_t> scan_all_naive(std::string_view input) {
+  std::vector<size_t> positions;
+  for (size_t i = 0; i < input.size(); ++i) {
+    if (input[i] == '(' || input[i] == ')' || input[i] == '\r' || input[i] == '\n')
+      positions.push_back(i);
+  }
+  return positions;
+}
+}
+
+TEST_CASE_FIXTURE(LogFixture, "StructuralScanner finds all structural characters") {
+  SUBCASE("Empty input") { REQUIRE(scan_all("").empty()); }
+
+  SUBCASE("Short input") {
+    const std::string_view input = "1-0:1.7.0(00.318*kW)\r\n";
+    REQUIRE(scan_all(input) == std::vector<size_t>{9, 19, 20, 21});
+  }
+
+  SUBCASE("Input spanning several blocks") {
+    const std::string_view input = "/KFM5KAIFA-METER\r\n"
+                                   "\r\n"
+                                   "1-3:0.2.8(40)\r\n"
+                                   "0-0:1.0.0(150117185916W)\r\n"
+                                   "0-0:96.1.1(0000000000000000000000000000000000)\r\n"
+                                   "1-0:1.8.1(000671.578*kWh)\r\n"
+                                   "1-0:0.2.0((ER11))\r\n"
+                                   "0-0:96.13.0(303132333435363738393A3B3C3D3E3F303132333435363738393A3B3C3D3E3F\r\n"
+                                   "303132333435363738393A3B3C3D3E3F)\r\n";
+    REQUIRE(scan_all(input) == scan_all_naive(input));
+  }
+
+  SUBCASE("Structural characters at block boundaries") {
+    std::string input(200, 'x');
+    for (const size_t pos : std::vector<size_t>{0, 63, 64, 127, 128, 191, 199})
+      input[pos] = '(';
+    REQUIRE(scan_all(input) == std::vector<size_t>{0, 63, 64, 127, 128, 191, 199});
+  }
+}
+
+TEST_CASE_FIXTURE(LogFixture, "StructuralScanner SIMD and scalar implementations agree") {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> any_byte(0, 255);
+  std::uniform_int_distribution<size_t> pick(0, 6);
+  const char interesting[] = {'(', ')', '\r', '\n', '(' - 1, ')' + 1, '\0'};
+
+  for (int round = 0; round < 1000; ++round) {
+    char block[StructuralScanner::kBlockSize];
+    for (auto& c : block)
+      c = (round % 2 == 0) ? static_cast<char>(any_byte(rng)) : interesting[pick(rng)];
+
+    uint64_t expected = 0;
+    for (size_t i = 0; i < StructuralScanner::kBlockSize; ++i) {
+      if (block[i] == '(' || block[i] == ')' || block[i] == '\r' || block[i] == '\n')
+        expected |= uint64_t{1} << i;
+    }
+    REQUIRE(StructuralScanner::structural_mask(block) == expected);
+    REQUIRE(StructuralScanner::structural_mask_scalar(block) == expected);
+  }
+}
@@ -0,0 +1,11 @@
+// This code tests that the telegram_filter header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/telegram_filter.h"
+
+void TelegramFilter_some_function() {
+  const dsmr_parser::ObisId keep[] = {dsmr_parser::ObisId(1, 0, 1, 7, 0)};
+  char out[64];
+  const dsmr_parser::TelegramFilter filter(keep);
+  (void)filter.filter(dsmr_parser::DsmrUnencryptedTelegram("/AAA5MTR\r\n!"), out);
+}
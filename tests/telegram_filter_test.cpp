@@ -0,0 +1,123 @@
+#include "dsmr_parser/telegram_filter.h"
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/packet_accumulator.h"
+#include "dsmr_parser/parser.h"
+#include "test_util.h"
+#include <array>
+#include <cstdio>
+#include <doctest.h>
+#include <string>
+#include <string_view>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+namespace {
+const std::string_view telegram = "/KFM5KAIFA-METER\r\n"
+                                  "\r\n"
+                                  "1-3:0.2.8(42)\r\n"
+                                  "0-0:1.0.0(150117185916W)\r\n"
+                                  "1-0:1.8.1(000671.578*kWh)\r\n"
+                                  "1-0:1.7.0(00.318*kW)\r\n"
+                                  "1-0:99.97.0(1)(0-0:96.7.19)(000101000001W)(2147483647*s)\r\n"
+                                  "0-0:96.13.0(303132333435363738393A3B3C3D3E3F303132333435363738393A3B3C3D3E3F\r\n"
+                                  "303132333435363738393A3B3C3D3E3F)\r\n"
+                                  "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                                  "!";
+
+const std::array<ObisId, 3> keep = {ObisId(1, 0, 1, 8, 1), ObisId(1, 0, 1, 7, 0), ObisId(0, 1, 24, 2, 1)};
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramFilter keeps the allowed lines and appends a new CRC") {
+  std::array<char, 512> out{};
+  const TelegramFilter filter(keep);
+  const auto filtered = filter.filter(DsmrUnencryptedTelegram(telegram), out);
+  REQUIRE(filtered);
+
+  const std::string_view expected = "/KFM5KAIFA-METER\r\n"
+                                    "\r\n"
+                                    "1-0:1.8.1(000671.578*kWh)\r\n"
+                                    "1-0:1.7.0(00.318*kW)\r\n"
+                                    "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                                    "!";
+  char crc[8];
+  std::snprintf(crc, sizeof(crc), "%04X\r\n", Crc16::calculate(expected));
+  REQUIRE(*filtered == std::string(expected) + crc);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "A filtered telegram is accepted by PacketAccumulator and parsed like the original") {
+  std::array<char, 512> out{};
+  const TelegramFilter filter(keep);
+  const auto filtered = filter.filter(DsmrUnencryptedTelegram(telegram), out);
+  REQUIRE(filtered);
+
+  std::array<uint8_t, 512> buffer{};
+  PacketAccumulator accumulator(buffer, true);
+  std::optional<DsmrUnencryptedTelegram> received;
+  for (const char byte : *filtered) {
+    if (const auto result = accumulator.process_byte(static_cast<uint8_t>(byte)))
+      received = result;
+  }
+  REQUIRE(received);
+
+  ParsedData<identification, energy_delivered_tariff1, power_delivered, gas_delivered, message_long> data;
+  REQUIRE(DsmrParser::parse(data, *received));
+  REQUIRE(data.identification == "KFM5KAIFA-METER");
+  REQUIRE(data.energy_delivered_tariff1.int_val() == 671578);
+  REQUIRE(data.power_delivered.int_val() == 318);
+  REQUIRE(data.gas_delivered.int_val() == 473789);
+  REQUIRE_FALSE(data.message_long_present);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramFilter keeps only the identification line with an empty allow-list") {
+  std::array<char, 64> out{};
+  const TelegramFilter filter({});
+  const auto filtered = filter.filter(DsmrUnencryptedTelegram(telegram), out);
+  REQUIRE(filtered);
+  REQUIRE(filtered->starts_with("/KFM5KAIFA-METER\r\n\r\n!"));
+  REQUIRE(filtered->size() == 27);
+  REQUIRE(DsmrParser::validate(*filtered));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramFilter keeps the original line endings") {
+  const std::string_view bare_lf = "/KFM5KAIFA-METER\n"
+                                   "\n"
+                                   "1-0:1.8.1(000671.578*kWh)\n"
+                                   "1-0:1.8.2(000842.472*kWh)\n"
+                                   "1-0:1.7.0(00.318*kW)\n"
+                                   "!";
+  std::array<char, 512> out{};
+  const TelegramFilter filter(keep);
+  const auto filtered = filter.filter(DsmrUnencryptedTelegram(bare_lf), out);
+  REQUIRE(filtered);
+  REQUIRE(filtered->starts_with("/KFM5KAIFA-METER\n\n1-0:1.8.1(000671.578*kWh)\n1-0:1.7.0(00.318*kW)\n!"));
+
+  // Nothing filtered out: only the CRC and its line ending are added
+  const std::array<ObisId, 3> all = {ObisId(1, 0, 1, 8, 1), ObisId(1, 0, 1, 8, 2), ObisId(1, 0, 1, 7, 0)};
+  const auto copy = TelegramFilter(all).filter(DsmrUnencryptedTelegram(bare_lf), out);
+  REQUIRE(copy);
+  REQUIRE(copy->size() == bare_lf.size() + 6);
+  REQUIRE(copy->starts_with(bare_lf));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramFilter reports an output buffer that is too small") {
+  std::array<char, 512> out{};
+  const TelegramFilter filter(keep);
+  const auto size = filter.filter(DsmrUnencryptedTelegram(telegram), out)->size();
+  REQUIRE(filter.filter(DsmrUnencryptedTelegram(telegram), std::span(out).first(size)));
+  REQUIRE_FALSE(filter.filter(DsmrUnencryptedTelegram(telegram), std::span(out).first(size - 1)));
+  REQUIRE_FALSE(filter.filter(DsmrUnencryptedTelegram(telegram), std::span(out).first(10)));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramFilter reports a telegram that can't be split into lines") {
+  const std::string_view invalid = "/KFM5KAIFA-METER\r\n"
+                                   "\r\n"
+                                   "1-0:1.8.1(000671(578*kWh)\r\n"
+                                   "!";
+  std::array<char, 512> out{};
+  const TelegramFilter filter(keep);
+  ParseResult error;
+  REQUIRE_FALSE(filter.filter(DsmrUnencryptedTelegram(invalid), out, &error));
+  REQUIRE(error.error == ParseError::UnexpectedOpenParenthesis);
+  REQUIRE(error.offset == invalid.find("(578"));
+}
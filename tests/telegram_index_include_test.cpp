@@ -0,0 +1,9 @@
+// This code tests that the telegram_index header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/telegram_index.h"
+
+void TelegramIndex_some_function() {
+  dsmr_parser::TelegramLine lines[10];
+  dsmr_parser::TelegramIndex(lines).build(dsmr_parser::DsmrUnencryptedTelegram("/msg\r\n!"));
+}
@@ -0,0 +1,108 @@
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/telegram_index.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <array>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+namespace {
+const auto msg = "/KFM5KAIFA-METER\r\n"
+                 "\r\n"
+                 "1-3:0.2.8(40)\r\n"
+                 "1-0:1.8.1(000671.578*kWh)\r\n"
+                 "1-0:1.7.0(00.318*kW)\r\n"
+                 "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                 "1-0:32.7.0(abc*V)\r\n"
+                 "1-0:52.7.0(230.0*V)(1)\r\n"
+                 "!";
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramIndex records every line") {
+  std::array<TelegramLine, 10> buffer;
+  TelegramIndex index(buffer);
+  REQUIRE(index.build(DsmrUnencryptedTelegram(msg)));
+
+  REQUIRE(index.lines().size() == 7);
+  REQUIRE(index.lines()[0].identification);
+  REQUIRE(index.find(ObisId(1, 0, 1, 7, 0))->value == "(00.318*kW)");
+  REQUIRE(index.find(ObisId(1, 0, 2, 7, 0)) == nullptr);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramIndex fails on malformed telegrams") {
+  std::array<TelegramLine, 3> buffer;
+  TelegramIndex index(buffer);
+
+  SUBCASE("Too many lines") {
+    REQUIRE_FALSE(index.build(DsmrUnencryptedTelegram(msg)));
+    REQUIRE(log.contains("Too many lines in the telegram"));
+  }
+
+  SUBCASE("Syntax error") {
+    REQUIRE_FALSE(index.build(DsmrUnencryptedTelegram("/AAA5MTR\r\n1-0:1.7.0)1)\r\n!")));
+    REQUIRE(index.error().error == ParseError::UnexpectedCloseParenthesis);
+    REQUIRE(index.error().offset == 19);
+  }
+
+  REQUIRE(index.lines().empty());
+}
+
+TEST_CASE_FIXTURE(LogFixture, "LazyParsedData decodes fields on access") {
+  std::array<TelegramLine, 10> buffer;
+  TelegramIndex index(buffer);
+  REQUIRE(index.build(DsmrUnencryptedTelegram(msg)));
+
+  LazyParsedData<identification, p1_version, energy_delivered_tariff1, power_delivered, power_returned, gas_delivered, voltage_l1, voltage_l2> data(index);
+  REQUIRE(*data.get<identification>() == "KFM5KAIFA-METER");
+  REQUIRE(*data.get<p1_version>() == "40");
+  REQUIRE(*data.get<energy_delivered_tariff1>() == 671.578f);
+  REQUIRE(*data.get<power_delivered>() == 0.318f);
+  REQUIRE(data.get<gas_delivered>()->timestamp == "150117180000W");
+  REQUIRE(*data.get<gas_delivered>() == 473.789f);
+  REQUIRE(log.messages.empty());
+
+  // Missing field
+  REQUIRE(data.get<power_returned>() == nullptr);
+
+  // Invalid values are decoded only when accessed, and only once
+  REQUIRE(data.get<voltage_l1>() == nullptr);
+  REQUIRE(data.failure().error == ParseError::InvalidNumber);
+  const auto* position = data.failure().position;
+  REQUIRE(data.get<voltage_l1>() == nullptr);
+  REQUIRE(data.failure().position == position);
+  REQUIRE(data.get<voltage_l2>() == nullptr);
+  REQUIRE(data.failure().error == ParseError::TrailingCharacters);
+  REQUIRE(log.messages.empty());
+}
+
+TEST_CASE_FIXTURE(LogFixture, "LazyParsedData takes the first line of a field like TelegramIndex::find") {
+  const auto& twice = "/AAA5MTR\r\n"
+                      "1-0:1.7.0(00.318*kW)\r\n"
+                      "1-0:1.7.0(01.500*kW)\r\n"
+                      "!";
+  std::array<TelegramLine, 10> buffer;
+  TelegramIndex index(buffer);
+  REQUIRE(index.build(DsmrUnencryptedTelegram(twice)));
+
+  LazyParsedData<power_returned, power_delivered> data(index);
+  REQUIRE(index.find(ObisId(1, 0, 1, 7, 0))->value == "(00.318*kW)");
+  REQUIRE(data.get<power_delivered>()->int_val() == 318);
+  REQUIRE(data.get<power_returned>() == nullptr);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "LazyParsedData decodes the line of fields with the same OBIS id for each of them") {
+  const auto& failures = "/AAA5MTR\r\n"
+                         "1-0:1.7.0(00.318*kW)\r\n"
+                         "1-0:99.97.0(1)(0-0:96.7.19)(101208152415W)(0000000240*s)\r\n"
+                         "!";
+  std::array<TelegramLine, 10> buffer;
+  TelegramIndex index(buffer);
+  REQUIRE(index.build(DsmrUnencryptedTelegram(failures)));
+
+  LazyParsedData<electricity_failure_log, power_delivered, electricity_failure_log_entries> data(index);
+  REQUIRE(data.get<electricity_failure_log_entries>()->size() == 1);
+  REQUIRE((*data.get<electricity_failure_log_entries>())[0].value == 240);
+  REQUIRE(*data.get<electricity_failure_log>() == "(1)(0-0:96.7.19)(101208152415W)(0000000240*s)");
+  REQUIRE(data.get<power_delivered>()->int_val() == 318);
+}
@@ -0,0 +1,6 @@
+// This code tests that the telegram_splitter header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/telegram_splitter.h"
+
+void TelegramSplitter_some_function() { dsmr_parser::TelegramSplitter("/msg\r\n!", false).next(); }
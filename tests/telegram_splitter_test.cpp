@@ -0,0 +1,81 @@
+#include "dsmr_parser/packet_accumulator.h"
+#include "dsmr_parser/telegram_splitter.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace dsmr_parser;
+
+namespace {
+std::vector<std::string> split_all(std::string_view capture, bool check_crc) {
+  std::vector<std::string> telegrams;
+  TelegramSplitter splitter(capture, check_crc);
+  while (const auto telegram = splitter.next())
+    telegrams.emplace_back(telegram->content());
+  return telegrams;
+}
+
+std::vector<std::string> accumulate_all(std::string_view capture, bool check_crc) {
+  std::vector<std::string> telegrams;
+  std::vector<uint8_t> buffer(1000);
+  PacketAccumulator accumulator(buffer, check_crc);
+  for (const char byte : capture) {
+    if (const auto telegram = accumulator.process_byte(static_cast<uint8_t>(byte)))
+      telegrams.emplace_back(telegram->content());
+  }
+  return telegrams;
+}
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Crc16 matches the CRC of a real telegram") {
+  REQUIRE(Crc16::calculate("/KFM5KAIFA-METER\r\n\r\n1-0:1.8.1(000671.578*kWh)\r\n1-0:1.7.0(00.318*kW)\r\n!") == 0x1E1D);
+  REQUIRE(Crc16::calculate("") == 0);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Crc16::calculate gives the same CRC as update() for every length") {
+  const std::string_view text = "/KFM5KAIFA-METER\r\n\r\n1-0:1.8.1(000671.578*kWh)\r\n\xFF\x80!";
+  for (size_t length = 0; length <= text.size(); ++length) {
+    uint16_t crc = 0;
+    for (const char c : text.substr(0, length))
+      crc = Crc16::update(crc, static_cast<uint8_t>(c));
+    REQUIRE(Crc16::calculate(text.substr(0, length)) == crc);
+  }
+  static_assert(Crc16::calculate("123456789") == 0xBB3D);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramSplitter finds the same telegrams as PacketAccumulator") {
+  const std::string_view capture = "garbage"
+                                   "/KFM5KAIFA-METER\r\n\r\n1-0:1.8.1(000671.578*kWh)\r\n1-0:1.7.0(00.318*kW)\r\n!1E1D\r\n"
+                                   "/AAA5MTR\r\n1-0:1.7.0(00.100*kW)\r\n!0000\r\n"                                      // CRC mismatch
+                                   "/AAA5MTR\r\n1-0:1.7.0(00.100*kW)\r\n!G000\r\n"                                      // incorrect CRC character
+                                   "/AAA5MTR\r\n1-0:1.7.0(00.100*kW)\r\n!1E/KFM5KAIFA-METER\r\n"                        // '/' in CRC
+                                   "\r\n1-0:1.8.1(000671.578*kWh)\r\n1-0:1.7.0(00.318*kW)\r\n!1e1d\r\n"
+                                   "/AAA5MTR\r\n/KFM5KAIFA-METER\r\n\r\n1-0:1.8.1(000671.578*kWh)\r\n1-0:1.7.0(00.318*kW)\r\n!1E1D" // restart
+                                   "/AAA5MTR\r\n1-0:1.7.0(00.100*kW)\r\n!1E";                                            // incomplete
+
+  SUBCASE("With CRC check") {
+    const auto telegrams = split_all(capture, true);
+    REQUIRE(telegrams.size() == 3);
+    REQUIRE(telegrams == accumulate_all(capture, true));
+    REQUIRE(log.contains("CRC mismatch"));
+    REQUIRE(log.contains("Incorrect CRC character 'G'"));
+  }
+
+  SUBCASE("Without CRC check") {
+    const auto telegrams = split_all(capture, false);
+    REQUIRE(telegrams.size() == 7);
+    REQUIRE(telegrams == accumulate_all(capture, false));
+  }
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramSplitter does not copy the telegrams") {
+  const std::string_view capture = "/AAA5MTR\r\n!";
+  TelegramSplitter splitter(capture, false);
+  const auto telegram = splitter.next();
+  REQUIRE(telegram);
+  REQUIRE(telegram->content().data() == capture.data());
+  REQUIRE(splitter.position() == capture.size());
+  REQUIRE_FALSE(splitter.next());
+}
@@ -3,27 +3,32 @@
 #include "dsmr_parser/util.h"
 #include "dsmr_parser/packet_accumulator.h"
 #include <cstdio>
+#include <mutex>
 #include <string>
 #include <vector>
 
 class LogCapturer {
 public:
   LogCapturer() {
-    dsmr_parser::Logger::set_log_function([this](dsmr_parser::LogLevel, const char* fmt, va_list args) {
-      char buf[1024];
+    dsmr_parser::Logger::set_log_function(
+        [](void* context, dsmr_parser::LogLevel, const char* fmt, va_list args) {
+          char buf[1024];
 #if defined(__clang__)
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wformat-nonliteral"
 #endif
-      vsnprintf(buf, sizeof(buf), fmt, args);
+          vsnprintf(buf, sizeof(buf), fmt, args);
 #if defined(__clang__)
 #pragma clang diagnostic pop
 #endif
-      messages.emplace_back(buf);
-    });
+          auto& capturer = *static_cast<LogCapturer*>(context);
+          std::lock_guard lock(capturer.mutex); // the replay tests log from several threads
+          capturer.messages.emplace_back(buf);
+        },
+        this);
   }
 
-  ~LogCapturer() { dsmr_parser::Logger::set_log_function([](dsmr_parser::LogLevel, const char*, va_list) {}); }
+  ~LogCapturer() { dsmr_parser::Logger::set_log_function(nullptr, nullptr); }
 
   bool contains(const std::string& substr) const {
     for (const auto& msg : messages) {
@@ -36,6 +41,7 @@ public:
   void clear() { messages.clear(); }
 
   std::vector<std::string> messages;
+  std::mutex mutex;
 };
 
 struct LogFixture {
@@ -0,0 +1,9 @@
+// This code tests that the timestamp header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/timestamp.h"
+
+void TimestampDecoder_some_function() {
+  dsmr_parser::TimestampDecoder decoder;
+  (void)decoder.decode("150117185916W");
+}
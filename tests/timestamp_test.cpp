@@ -0,0 +1,84 @@
+#include "dsmr_parser/timestamp.h"
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/parser.h"
+#include "test_util.h"
+#include <array>
+#include <doctest.h>
+#include <optional>
+#include <string_view>
+
+using namespace dsmr_parser;
+using namespace fields;
+
+TEST_CASE_FIXTURE(LogFixture, "TimestampDecoder decodes to the seconds since 1970") {
+  TimestampDecoder decoder;
+  REQUIRE(decoder.decode("150117185916W") == Timestamp{1421521156, false});
+  REQUIRE(decoder.decode("000101000000W") == Timestamp{946684800, false});
+  REQUIRE(decoder.decode("240229000000S") == Timestamp{1709164800, true});
+  REQUIRE(decoder.decode("991231235959W") == Timestamp{4102444799, false});
+}
+
+TEST_CASE_FIXTURE(LogFixture, "Timestamp converts the local time of the meter to Unix time") {
+  REQUIRE(Timestamp{1421521156, false}.unix_seconds(3600) == 1421521156 - 3600);
+  REQUIRE(Timestamp{1421521156, true}.unix_seconds(3600) == 1421521156 - 7200);
+  REQUIRE(Timestamp{1421521156, false}.unix_seconds(0) == 1421521156);
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TimestampDecoder rejects invalid timestamps") {
+  TimestampDecoder decoder;
+  REQUIRE_FALSE(decoder.decode(""));
+  REQUIRE_FALSE(decoder.decode("150117185916"));
+  REQUIRE_FALSE(decoder.decode("150117185916WW"));
+  REQUIRE_FALSE(decoder.decode("150117185916X"));
+  REQUIRE_FALSE(decoder.decode("151317185916W"));
+  REQUIRE_FALSE(decoder.decode("150017185916W"));
+  REQUIRE_FALSE(decoder.decode("150100185916W"));
+  REQUIRE_FALSE(decoder.decode("150431185916W"));
+  REQUIRE_FALSE(decoder.decode("230229000000W"));
+  REQUIRE_FALSE(decoder.decode("1501171A5916W"));
+  REQUIRE_FALSE(decoder.decode("150117240000W"));
+  REQUIRE_FALSE(decoder.decode("150117236000W"));
+  REQUIRE_FALSE(decoder.decode("150117235960W"));
+  REQUIRE_FALSE(decoder.decode("15-117185916W"));
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TimestampDecoder gives the same results with a cached date") {
+  TimestampDecoder decoder;
+  REQUIRE(decoder.decode("150117185916W") == Timestamp{1421521156, false});
+  REQUIRE(decoder.decode("150117185917W") == Timestamp{1421521157, false});
+  REQUIRE_FALSE(decoder.decode("150117245917W"));
+  REQUIRE_FALSE(decoder.decode("151317185916W"));
+  REQUIRE(decoder.decode("150117185918W") == Timestamp{1421521158, false});
+  REQUIRE(decoder.decode("150118000000W") == Timestamp{1421539200, false});
+  decoder.reset();
+  REQUIRE(decoder.decode("150117185916W") == Timestamp{1421521156, false});
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TimestampDecoder decodes a column of timestamps") {
+  const std::array<std::string_view, 4> texts = {"150117185916W", "", "150117185917S", "150117185960W"};
+  std::array<std::optional<Timestamp>, 4> out;
+  TimestampDecoder decoder;
+  REQUIRE(decoder.decode(texts, out) == 2);
+  REQUIRE(out[0] == Timestamp{1421521156, false});
+  REQUIRE_FALSE(out[1]);
+  REQUIRE(out[2] == Timestamp{1421521157, true});
+  REQUIRE_FALSE(out[3]);
+
+  // Stops at the end of the shorter span
+  std::array<std::optional<Timestamp>, 1> short_out;
+  REQUIRE(decoder.decode(texts, short_out) == 1);
+  REQUIRE(short_out[0] == Timestamp{1421521156, false});
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TimestampDecoder decodes the timestamps of a ParsedData") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "0-0:1.0.0(150117185916W)\r\n"
+                    "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                    "!";
+  ParsedData<timestamp, gas_delivered> data;
+  REQUIRE(DsmrParser::parse(data, DsmrUnencryptedTelegram(msg)));
+  TimestampDecoder decoder;
+  REQUIRE(decoder.decode(data.timestamp) == Timestamp{1421521156, false});
+  REQUIRE(decoder.decode(data.gas_delivered.timestamp) == Timestamp{1421517600, false});
+}
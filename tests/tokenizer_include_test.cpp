@@ -0,0 +1,6 @@
+// This code tests that the tokenizer header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "dsmr_parser/tokenizer.h"
+
+void TelegramTokenizer_some_function() { dsmr_parser::TelegramTokenizer(dsmr_parser::DsmrUnencryptedTelegram("/msg\r\n!")).next(); }
@@ -0,0 +1,143 @@
+#include "dsmr_parser/tokenizer.h"
+#include "test_util.h"
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+using namespace dsmr_parser;
+
+namespace {
+std::vector<TelegramLine> tokenize_all(TelegramTokenizer& tokenizer) {
+  std::vector<TelegramLine> lines;
+  while (const auto line = tokenizer.next())
+    lines.push_back(*line);
+  return lines;
+}
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramTokenizer splits a telegram into lines") {
+  const auto msg = "/KFM5KAIFA-METER\r\n"
+                   "\r\n"
+                   "1-3:0.2.8(40)\r\n"
+                   "0-0:96.7.21(00010)\r\n"
+                   "0-1:24.3.0(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)\r\n"
+                   "(00124.477)\r\n"
+                   "0-0:96.13.0(303132)\r\n"
+                   "1-0:99.97.0(0)(0-0:96.7.19)\r\n"
+                   "1-0:1.7.0(00.318*kW)\r\n"
+                   "!";
+  TelegramTokenizer tokenizer{DsmrUnencryptedTelegram(msg)};
+  const auto lines = tokenize_all(tokenizer);
+  REQUIRE_FALSE(tokenizer.failed());
+  REQUIRE(log.messages.empty());
+  REQUIRE(lines.size() == 7);
+
+  REQUIRE(lines[0].identification);
+  REQUIRE(lines[0].text == "KFM5KAIFA-METER");
+  REQUIRE(lines[0].value == "KFM5KAIFA-METER");
+
+  REQUIRE_FALSE(lines[1].identification);
+  REQUIRE(lines[1].id == ObisId(1, 3, 0, 2, 8));
+  REQUIRE(lines[1].text == "1-3:0.2.8(40)");
+  REQUIRE(lines[1].value == "(40)");
+
+  REQUIRE(lines[2].id == ObisId(0, 0, 96, 7, 21));
+  REQUIRE(lines[2].value == "(00010)");
+
+  // A value broken with CRLF is one line
+  REQUIRE(lines[3].id == ObisId(0, 1, 24, 3, 0));
+  REQUIRE(lines[3].value == "(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)\r\n(00124.477)");
+
+  REQUIRE(lines[4].id == ObisId(0, 0, 96, 13, 0));
+  REQUIRE(lines[5].id == ObisId(1, 0, 99, 97, 0));
+  REQUIRE(lines[5].value == "(0)(0-0:96.7.19)");
+  REQUIRE(lines[6].id == ObisId(1, 0, 1, 7, 0));
+  REQUIRE(lines[6].value == "(00.318*kW)");
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramTokenizer handles short and unusual OBIS ids") {
+  const auto msg = "/AAA5MTR\r\n"
+                   "1-0:1.7(1)\r\n"
+                   "1-0:1.7.0.255(2)\r\n"
+                   "0-0:96.13.1(())\r\n"
+                   "!";
+  TelegramTokenizer tokenizer{DsmrUnencryptedTelegram(msg)};
+  const auto lines = tokenize_all(tokenizer);
+  REQUIRE_FALSE(tokenizer.failed());
+  REQUIRE(lines.size() == 4);
+  REQUIRE(lines[1].id == ObisId(1, 0, 1, 7, 255, 255));
+  REQUIRE(lines[2].id == ObisId(1, 0, 1, 7, 0, 255));
+  REQUIRE(lines[3].id == ObisId(0, 0, 96, 13, 1));
+  REQUIRE(lines[3].value == "(())");
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramTokenizer reports errors") {
+  SUBCASE("Unexpected '('") {
+    TelegramTokenizer tokenizer{DsmrUnencryptedTelegram("/AAA5MTR\r\n1-0:1.7.0(1(2)\r\n!")};
+    tokenize_all(tokenizer);
+    REQUIRE(tokenizer.failed());
+    REQUIRE(tokenizer.failure().error == ParseError::UnexpectedOpenParenthesis);
+  }
+
+  SUBCASE("Unexpected ')'") {
+    TelegramTokenizer tokenizer{DsmrUnencryptedTelegram("/AAA5MTR\r\n1-0:1.7.0)1)\r\n!")};
+    tokenize_all(tokenizer);
+    REQUIRE(tokenizer.failed());
+    REQUIRE(tokenizer.failure().error == ParseError::UnexpectedCloseParenthesis);
+  }
+
+  SUBCASE("Last line is not terminated") {
+    TelegramTokenizer tokenizer{DsmrUnencryptedTelegram("/AAA5MTR\r\n1-0:1.7.0(1)!")};
+    tokenize_all(tokenizer);
+    REQUIRE(tokenizer.failed());
+    REQUIRE(tokenizer.failure().error == ParseError::LastLineNotTerminated);
+  }
+
+  SUBCASE("OBIS id is over 255") {
+    TelegramTokenizer tokenizer{DsmrUnencryptedTelegram("/AAA5MTR\r\n1-0:256.7.0(1)\r\n!")};
+    tokenize_all(tokenizer);
+    REQUIRE(tokenizer.failed());
+    REQUIRE(tokenizer.failure().error == ParseError::ObisNumberOver255);
+  }
+
+  SUBCASE("Empty OBIS id") {
+    TelegramTokenizer tokenizer{DsmrUnencryptedTelegram("/AAA5MTR\r\n(1)\r\n!")};
+    tokenize_all(tokenizer);
+    REQUIRE(tokenizer.failed());
+    REQUIRE(tokenizer.failure().error == ParseError::EmptyObisId);
+  }
+}
+
+TEST_CASE("decode_obis accepts the same ids as parse_obis") {
+  for (const std::string_view input : {"1-0:1.7.0", "1-0:1.7.0.255", "0-1:24.2.1", "1-0:1", "1", "255-255:255.255.255.255"}) {
+    ObisId decoded;
+    ObisId parsed;
+    REQUIRE(decode_obis(decoded, input));
+    REQUIRE(parse_obis(parsed, input) == std::string_view());
+    REQUIRE(decoded == parsed);
+  }
+
+  for (const std::string_view input : {"", "1-0:256.7.0", "1-0:1.7.0x", "1:0-1.7.0", "1-0:1.7.0.1.2", "a"}) {
+    ObisId decoded;
+    REQUIRE_FALSE(decode_obis(decoded, input));
+  }
+}
+
+TEST_CASE_FIXTURE(LogFixture, "TelegramTokenizer requires CRLF if asked to") {
+  const auto mixed = "/AAA5MTR\r\n1-0:1.7.0(00.318*kW)\n1-0:2.7.0(00.000*kW)\r\n!";
+  TelegramTokenizer lenient{DsmrUnencryptedTelegram(mixed)};
+  REQUIRE(tokenize_all(lenient).size() == 3);
+  REQUIRE_FALSE(lenient.failed());
+
+  TelegramTokenizer strict{DsmrUnencryptedTelegram(mixed), true};
+  REQUIRE(tokenize_all(strict).size() == 1);
+  REQUIRE(strict.failed());
+  REQUIRE(strict.failure().error == ParseError::InvalidLineEnding);
+  REQUIRE(strict.failure().result(mixed).offset == std::string_view(mixed).find(")\n") + 1);
+
+  // Also in the identification line
+  const auto cr = "/AAA5MTR\r1-0:1.7.0(00.318*kW)\r\n!";
+  TelegramTokenizer identification{DsmrUnencryptedTelegram(cr), true};
+  REQUIRE(tokenize_all(identification).empty());
+  REQUIRE(identification.failure().result(cr).offset == 8);
+}
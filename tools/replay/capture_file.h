@@ -0,0 +1,263 @@
+#pragma once
+
+#include "dsmr_parser/dlms_packet_decryptor.h"
+#include "dsmr_parser/telegram_splitter.h"
+#include "dsmr_parser/util.h"
+#include "replay.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dsmr_replay {
+
+// A file mapped read-only into memory. The telegrams of a plaintext capture can be parsed directly from the mapping.
+class MappedFile final : dsmr_parser::NonCopyable {
+  const char* _data = nullptr;
+  size_t _size = 0;
+
+  MappedFile(const char* data, size_t size) : _data(data), _size(size) {}
+
+  void unmap() {
+    if (_data == nullptr)
+      return;
+#if defined(_WIN32)
+    UnmapViewOfFile(_data);
+#else
+    munmap(const_cast<char*>(_data), _size);
+#endif
+    _data = nullptr;
+  }
+
+public:
+  MappedFile(MappedFile&& other) noexcept : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)) {}
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    unmap();
+    _data = std::exchange(other._data, nullptr);
+    _size = std::exchange(other._size, 0);
+    return *this;
+  }
+  ~MappedFile() { unmap(); }
+
+  // Returns std::nullopt if the file can't be opened or mapped. The error is logged.
+  static std::optional<MappedFile> open(const char* path) {
+#if defined(_WIN32)
+    const auto file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      DSMR_PARSER_LOG(dsmr_parser::LogLevel::ERROR, "Can't open '%s'", path);
+      return std::nullopt;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+      CloseHandle(file);
+      DSMR_PARSER_LOG(dsmr_parser::LogLevel::ERROR, "Can't get the size of '%s'", path);
+      return std::nullopt;
+    }
+    if (size.QuadPart == 0) {
+      CloseHandle(file);
+      return MappedFile(nullptr, 0);
+    }
+    const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    const auto* data = mapping == nullptr ? nullptr : static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (mapping != nullptr)
+      CloseHandle(mapping);
+    if (data == nullptr) {
+      DSMR_PARSER_LOG(dsmr_parser::LogLevel::ERROR, "Can't map '%s'", path);
+      return std::nullopt;
+    }
+    return MappedFile(data, static_cast<size_t>(size.QuadPart));
+#else
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+      DSMR_PARSER_LOG(dsmr_parser::LogLevel::ERROR, "Can't open '%s'", path);
+      return std::nullopt;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+      close(fd);
+      return MappedFile(nullptr, 0);
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      DSMR_PARSER_LOG(dsmr_parser::LogLevel::ERROR, "Can't map '%s'", path);
+      return std::nullopt;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    return MappedFile(static_cast<const char*>(data), size);
+#endif
+  }
+
+  std::string_view text() const { return {_data, _size}; }
+  std::span<const uint8_t> bytes() const { return {reinterpret_cast<const uint8_t*>(_data), _size}; }
+};
+
+// Converts the "YYMMDDhhmmssX" timestamp of a telegram to the number YYMMDDhhmmss, that can be compared.
+// The daylight saving flag X is ignored. Returns std::nullopt if the format is wrong.
+inline std::optional<uint64_t> timestamp_key(std::string_view timestamp) {
+  if (timestamp.size() < 12)
+    return std::nullopt;
+  uint64_t key = 0;
+  for (const char c : timestamp.substr(0, 12)) {
+    if (c < '0' || c > '9')
+      return std::nullopt;
+    key = key * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return key;
+}
+
+// Returns the timestamp (0-0:1.0.0) of the telegram as timestamp_key(), or 0 if the telegram has none.
+inline uint64_t telegram_timestamp(dsmr_parser::DsmrUnencryptedTelegram telegram) {
+  constexpr std::string_view kTimestampLine = "\n0-0:1.0.0(";
+  const auto content = telegram.content();
+  const auto pos = content.find(kTimestampLine);
+  if (pos == std::string_view::npos)
+    return 0;
+  return timestamp_key(content.substr(pos + kTimestampLine.size())).value_or(0);
+}
+
+// Sparse index of a capture: the offset and timestamp of about one telegram every `stride` bytes.
+// Every offset is the start of a telegram (or a DLMS packet), so a replay can start there and get the same telegrams as a replay from the beginning.
+// A plaintext capture is indexed without reading it completely: at every stride the next telegram is looked up.
+// The index knows the size of the capture and the stride it was built for, so a stale index file is detected.
+// Part of the dsmr_replay tool, like MappedFile. The library itself reads no files.
+class CaptureIndex final {
+public:
+  struct Entry final {
+    size_t offset;
+    uint64_t timestamp; // timestamp_key() of the telegram or 0 if unknown
+  };
+
+  CaptureIndex() = default;
+  CaptureIndex(std::vector<Entry> entries, size_t capture_size, size_t stride)
+      : _entries(std::move(entries)), _capture_size(capture_size), _stride(stride) {}
+
+  static CaptureIndex build_plaintext(std::string_view capture, size_t stride, bool check_crc) {
+    std::vector<Entry> entries;
+    size_t pos = 0;
+    while (pos < capture.size()) {
+      const auto start = capture.find('/', pos);
+      if (start == std::string_view::npos)
+        break;
+      dsmr_parser::TelegramSplitter splitter(capture.substr(start), check_crc);
+      const auto telegram = splitter.next();
+      if (!telegram)
+        break;
+      const auto offset = static_cast<size_t>(telegram->content().data() - capture.data());
+      entries.push_back({offset, telegram_timestamp(*telegram)});
+      pos = std::max(offset + 1, start + std::max<size_t>(stride, 1));
+    }
+    return CaptureIndex(std::move(entries), capture.size(), stride);
+  }
+
+  // The packets of a DLMS capture are found by walking the headers. The packets at the index entries are decrypted to get their timestamps.
+  template <typename GcmDecryptor>
+  static CaptureIndex build_dlms(std::span<const uint8_t> capture, const dsmr_parser::Aes128GcmDecryptionKey& key, size_t stride) {
+    GcmDecryptor gcm_decryptor;
+    gcm_decryptor.set_encryption_key(key);
+    dsmr_parser::DlmsPacketDecryptor decryptor(gcm_decryptor);
+
+    std::vector<Entry> entries;
+    std::vector<uint8_t> packet;
+    size_t next = 0;
+    walk_dlms_packets(capture, [&](size_t offset, size_t size) {
+      if (offset < next)
+        return;
+      packet.assign(capture.begin() + static_cast<std::ptrdiff_t>(offset), capture.begin() + static_cast<std::ptrdiff_t>(offset + size));
+      const auto telegram = decryptor.decrypt_inplace(packet);
+      entries.push_back({offset, telegram ? telegram_timestamp(*telegram) : 0});
+      next = offset + std::max<size_t>(stride, 1);
+    });
+    return CaptureIndex(std::move(entries), capture.size(), stride);
+  }
+
+  // Returns the offset to start a replay from, to get all telegrams with a timestamp at or after `timestamp`.
+  // The timestamps in the capture are expected to increase. Entries without a timestamp are skipped.
+  size_t seek(uint64_t timestamp) const {
+    size_t offset = 0;
+    for (const auto& entry : _entries) {
+      if (entry.timestamp == 0)
+        continue;
+      if (entry.timestamp >= timestamp)
+        break;
+      offset = entry.offset;
+    }
+    return offset;
+  }
+
+  std::span<const Entry> entries() const { return _entries; }
+  size_t capture_size() const { return _capture_size; }
+  size_t stride() const { return _stride; }
+
+  // The index is stored as text: a "dsmr_index capture_size stride" header, then one "offset timestamp" line per entry.
+  bool save(const char* path) const {
+    auto* file = std::fopen(path, "w");
+    if (file == nullptr) {
+      DSMR_PARSER_LOG(dsmr_parser::LogLevel::ERROR, "Can't write '%s'", path);
+      return false;
+    }
+    std::fprintf(file, "dsmr_index %zu %zu\n", _capture_size, _stride);
+    for (const auto& entry : _entries)
+      std::fprintf(file, "%zu %llu\n", entry.offset, static_cast<unsigned long long>(entry.timestamp));
+    return std::fclose(file) == 0;
+  }
+
+  // Returns std::nullopt if the file can't be read, or if it was built for a capture of another size or with another stride.
+  // The offsets of such an index would point anywhere in the capture, so it must be built again.
+  // The entries are checked against what build_plaintext() and build_dlms() can produce for the capture: increasing offsets
+  // inside the capture, at most one per `stride` bytes. A damaged file is rejected instead of seeking to a wrong offset.
+  static std::optional<CaptureIndex> load(const char* path, size_t capture_size, size_t stride) {
+    auto* file = std::fopen(path, "r");
+    if (file == nullptr)
+      return std::nullopt;
+    const auto reject = [&](const char* reason) -> std::optional<CaptureIndex> {
+      std::fclose(file);
+      DSMR_PARSER_LOG(dsmr_parser::LogLevel::INFO, "The index '%s' %s", path, reason);
+      return std::nullopt;
+    };
+    size_t saved_capture_size;
+    size_t saved_stride;
+    if (std::fscanf(file, "dsmr_index %zu %zu", &saved_capture_size, &saved_stride) != 2 || saved_capture_size != capture_size || saved_stride != stride)
+      return reject("doesn't match the capture");
+
+    const auto max_entries = capture_size / std::max<size_t>(stride, 1) + 1;
+    std::vector<Entry> entries;
+    size_t offset;
+    unsigned long long timestamp;
+    while (std::fscanf(file, "%zu %llu", &offset, &timestamp) == 2) {
+      if (offset >= capture_size || (!entries.empty() && offset <= entries.back().offset) || entries.size() == max_entries)
+        return reject("has offsets that can't be in the capture");
+      entries.push_back({offset, timestamp});
+    }
+    if (!std::feof(file))
+      return reject("is damaged");
+    std::fclose(file);
+    return CaptureIndex(std::move(entries), capture_size, stride);
+  }
+
+private:
+  std::vector<Entry> _entries;
+  size_t _capture_size = 0;
+  size_t _stride = 0;
+};
+
+}
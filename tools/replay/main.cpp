@@ -0,0 +1,155 @@
+// Usage: dsmr_replay [options] capture_file
+// Parses all telegrams of a capture of the P1 port on all cores and prints statistics.
+//   --threads N      number of worker threads. Default, or 0: number of cores
+//   --chunk-size N   bytes of the capture per work item. Default: 1 MiB
+//   --key HEX        the capture contains DLMS packets encrypted with this key
+//   --no-crc         don't check the CRC of plaintext telegrams
+//   --index FILE     sparse index of the capture with one entry per chunk. Built and saved to FILE if it doesn't exist
+//   --from TIME      start at the telegrams with timestamp TIME (YYMMDDhhmmss) or later. Uses the index
+//   --from-offset N  start at offset N. Must be the start of a telegram or a DLMS packet, e.g. printed by --list
+//   --list           print the offset, status and identification of every telegram
+//   --verbose        print parse errors
+// The capture is mapped into memory. Plaintext telegrams are parsed in place.
+
+#include "dsmr_parser/decryption/aes128gcm_mbedtls.h"
+#include "dsmr_parser/fields.h"
+#include "replay/capture_file.h"
+#include "replay/replay.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace dsmr_parser;
+using namespace dsmr_parser::fields;
+
+namespace {
+
+// The fields to parse. Edit this list to replay the captures with other fields.
+using ReplayData = ParsedData<identification, p1_version, timestamp, equipment_id, energy_delivered_tariff1, energy_delivered_tariff2,
+                              energy_returned_tariff1, energy_returned_tariff2, electricity_tariff, power_delivered, power_returned,
+                              electricity_failures, electricity_long_failures, electricity_failure_log, electricity_sags_l1, electricity_swells_l1,
+                              voltage_l1, voltage_l2, voltage_l3, current_l1, current_l2, current_l3, power_delivered_l1, power_delivered_l2,
+                              power_delivered_l3, power_returned_l1, power_returned_l2, power_returned_l3, gas_device_type, gas_equipment_id,
+                              gas_delivered>;
+
+const char* status_name(dsmr_replay::TelegramStatus status) {
+  switch (status) {
+  case dsmr_replay::TelegramStatus::Ok:
+    return "ok";
+  case dsmr_replay::TelegramStatus::ParseError:
+    return "parse_error";
+  case dsmr_replay::TelegramStatus::DecryptionError:
+    return "decryption_error";
+  }
+  return "unknown";
+}
+
+int usage() {
+  std::fprintf(stderr, "Usage: dsmr_replay [--threads N] [--chunk-size N] [--key HEX] [--no-crc] [--index FILE] [--from YYMMDDhhmmss] [--from-offset N] "
+                       "[--list] [--verbose] capture_file\n");
+  return 2;
+}
+
+}
+
+int main(int argc, char** argv) {
+  dsmr_replay::ReplayOptions options;
+  std::optional<Aes128GcmDecryptionKey> key;
+  bool list = false;
+  bool verbose = false;
+  const char* path = nullptr;
+  const char* index_path = nullptr;
+  std::optional<uint64_t> from;
+
+  const std::vector<std::string_view> arguments(argv + 1, argv + argc);
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    const auto has_value = i + 1 < arguments.size();
+    if (arguments[i] == "--threads" && has_value) {
+      options.threads = std::strtoul(arguments[++i].data(), nullptr, 10);
+    } else if (arguments[i] == "--chunk-size" && has_value) {
+      options.chunk_size = std::strtoul(arguments[++i].data(), nullptr, 10);
+    } else if (arguments[i] == "--key" && has_value) {
+      key = Aes128GcmDecryptionKey::from_hex(arguments[++i]);
+      if (!key) {
+        std::fprintf(stderr, "Invalid key\n");
+        return 2;
+      }
+    } else if (arguments[i] == "--index" && has_value) {
+      index_path = arguments[++i].data();
+    } else if (arguments[i] == "--from" && has_value) {
+      from = dsmr_replay::timestamp_key(arguments[++i]);
+      if (!from) {
+        std::fprintf(stderr, "Invalid timestamp\n");
+        return 2;
+      }
+    } else if (arguments[i] == "--from-offset" && has_value) {
+      options.start_offset = std::strtoull(arguments[++i].data(), nullptr, 10);
+    } else if (arguments[i] == "--no-crc") {
+      options.check_crc = false;
+    } else if (arguments[i] == "--list") {
+      list = true;
+    } else if (arguments[i] == "--verbose") {
+      verbose = true;
+    } else if (!arguments[i].starts_with("--") && path == nullptr) {
+      path = arguments[i].data();
+    } else {
+      return usage();
+    }
+  }
+  if (path == nullptr)
+    return usage();
+  if (options.threads == 0)
+    options.threads = dsmr_replay::ReplayOptions().threads;
+
+  const auto file = dsmr_replay::MappedFile::open(path);
+  if (!file) {
+    std::fprintf(stderr, "Can't open '%s'\n", path);
+    return 1;
+  }
+
+  if (index_path != nullptr || from) {
+    const auto build_index = [&] {
+      // One entry per work item
+      return key ? dsmr_replay::CaptureIndex::build_dlms<Aes128GcmMbedTls>(file->bytes(), *key, options.chunk_size)
+                 : dsmr_replay::CaptureIndex::build_plaintext(file->text(), options.chunk_size, options.check_crc);
+    };
+    auto index = index_path != nullptr ? dsmr_replay::CaptureIndex::load(index_path, file->text().size(), options.chunk_size) : std::nullopt;
+    if (!index) {
+      index = build_index();
+      if (index_path != nullptr && !index->save(index_path)) {
+        std::fprintf(stderr, "Can't save the index to '%s'\n", index_path);
+        return 1;
+      }
+    }
+    if (from)
+      options.start_offset = std::max(options.start_offset, index->seek(*from));
+  }
+
+  const auto sink = [&](const dsmr_replay::ReplayedTelegram<ReplayData>& telegram) {
+    if (from && telegram.status == dsmr_replay::TelegramStatus::Ok && dsmr_replay::timestamp_key(telegram.data.timestamp).value_or(0) < *from)
+      return;
+    if (list) {
+      std::printf("%zu %s %.*s\n", telegram.offset, status_name(telegram.status), static_cast<int>(telegram.data.identification.size()),
+                  telegram.data.identification.data());
+    }
+    if (verbose && telegram.status == dsmr_replay::TelegramStatus::ParseError) {
+      char message[256];
+      telegram.parse_result.format(message, telegram.telegram.content());
+      std::fprintf(stderr, "%zu: %s\n", telegram.offset, message);
+    }
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto stats = key ? dsmr_replay::replay_dlms<ReplayData, Aes128GcmMbedTls>(file->bytes(), *key, options, sink)
+                         : dsmr_replay::replay_plaintext<ReplayData>(file->text(), options, sink);
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::fprintf(stderr, "telegrams: %zu, parse errors: %zu, decryption errors: %zu\n", stats.telegrams, stats.parse_errors, stats.decryption_errors);
+  const auto bytes = file->text().size() - std::min(options.start_offset, file->text().size());
+  std::fprintf(stderr, "%.3f s, %.1f MB/s, %.0f telegrams/s, %zu threads\n", seconds, static_cast<double>(bytes) / 1e6 / seconds,
+               static_cast<double>(stats.telegrams) / seconds, options.threads);
+  return 0;
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include "dsmr_parser/decryption/aes128gcm.h"
+#include "dsmr_parser/dlms_packet_decryptor.h"
+#include "dsmr_parser/parser.h"
+#include "dsmr_parser/telegram_splitter.h"
+#include "dsmr_parser/util.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Replays capture files of the P1 port: splits them at telegram boundaries, parses the telegrams on a pool of threads
+// and hands the results over in the order of the capture.
+namespace dsmr_replay {
+
+enum class TelegramStatus { Ok, ParseError, DecryptionError };
+
+template <typename Data>
+struct ReplayedTelegram final {
+  size_t offset; // position of the telegram or the DLMS packet in the capture
+  TelegramStatus status;
+  dsmr_parser::DsmrUnencryptedTelegram telegram; // empty if the DLMS packet can't be decrypted
+  Data data;
+  dsmr_parser::ParseResult parse_result; // why the telegram has the ParseError status
+};
+
+struct ReplayOptions final {
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t chunk_size = size_t{1} << 20; // bytes of the capture per work item
+  bool check_crc = true;               // plaintext captures only. DLMS packets are authenticated by the decryption.
+  bool unknown_error = false;
+  size_t start_offset = 0; // start of a telegram or a DLMS packet to start from, e.g. from CaptureIndex::seek()
+};
+
+struct ReplayStats final {
+  size_t telegrams = 0;
+  size_t parse_errors = 0;
+  size_t decryption_errors = 0;
+};
+
+struct Chunk final {
+  size_t begin;
+  size_t end;
+};
+
+// Runs `process(chunk_index)` on `threads` threads and `consume(result)` on the calling thread in the order of the chunks.
+// At most 2 chunks per thread are processed ahead of the consumer, to bound the memory used by the results.
+template <typename Result, typename Process, typename Consume>
+void run_ordered(size_t chunk_count, size_t threads, Process process, Consume consume) {
+  std::vector<std::optional<Result>> results(chunk_count);
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t next_chunk = 0;
+  size_t consumed = 0;
+  const size_t window = std::max<size_t>(threads, 1) * 2;
+
+  const auto worker = [&] {
+    while (true) {
+      size_t chunk;
+      {
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [&] { return next_chunk == chunk_count || next_chunk < consumed + window; });
+        if (next_chunk == chunk_count)
+          return;
+        chunk = next_chunk++;
+      }
+      auto result = process(chunk);
+      {
+        std::lock_guard lock(mutex);
+        results[chunk] = std::move(result);
+      }
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::jthread> pool;
+  for (size_t i = 0; i < std::min(std::max<size_t>(threads, 1), chunk_count); ++i)
+    pool.emplace_back(worker);
+
+  for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+    Result result;
+    {
+      std::unique_lock lock(mutex);
+      cv.wait(lock, [&] { return results[chunk].has_value(); });
+      result = std::move(*results[chunk]);
+      results[chunk].reset();
+    }
+    consume(result);
+    {
+      std::lock_guard lock(mutex);
+      ++consumed;
+    }
+    cv.notify_all();
+  }
+}
+
+// Cuts a plaintext capture into chunks of about `chunk_size` bytes, starting at `begin`. Every chunk except the first one starts with '/'.
+// PacketAccumulator drops the current telegram on every '/', so the chunks can be split independently with the same result.
+inline std::vector<Chunk> split_plaintext(std::string_view capture, size_t chunk_size, size_t begin = 0) {
+  std::vector<Chunk> chunks;
+  while (begin < capture.size()) {
+    auto end = begin + std::max<size_t>(chunk_size, 1);
+    end = end >= capture.size() ? capture.size() : std::min(capture.find('/', end), capture.size());
+    chunks.push_back({begin, end});
+    begin = end;
+  }
+  return chunks;
+}
+
+// Calls `on_packet(offset, size)` for every DLMS packet in `capture`. Bytes that don't start a valid DLMS header are skipped one by one.
+template <typename OnPacket>
+void walk_dlms_packets(std::span<const uint8_t> capture, OnPacket on_packet) {
+  size_t pos = 0;
+  while (pos < capture.size()) {
+    const auto size = dsmr_parser::DlmsPacketDecryptor::packet_size(capture.subspan(pos));
+    if (!size || *size > capture.size() - pos) {
+      ++pos;
+      continue;
+    }
+    on_packet(pos, *size);
+    pos += *size;
+  }
+}
+
+// Cuts a DLMS capture into chunks of about `chunk_size` bytes at packet boundaries, starting at `begin`.
+// DLMS packets have no start symbol, so the capture is walked from header to header. That touches only the headers.
+inline std::vector<Chunk> split_dlms(std::span<const uint8_t> capture, size_t chunk_size, size_t begin = 0) {
+  std::vector<Chunk> chunks;
+  const auto start = std::min(begin, capture.size());
+  begin = start;
+  walk_dlms_packets(capture.subspan(start), [&](size_t relative_offset, size_t size) {
+    const auto offset = start + relative_offset;
+    if (offset + size - begin >= chunk_size) {
+      chunks.push_back({begin, offset + size});
+      begin = offset + size;
+    }
+  });
+  if (begin < capture.size())
+    chunks.push_back({begin, capture.size()});
+  return chunks;
+}
+
+template <typename Data>
+void parse_telegram(ReplayedTelegram<Data>& result, const ReplayOptions& options, ReplayStats& stats) {
+  result.parse_result = dsmr_parser::DsmrParser::parse(result.data, result.telegram, options.unknown_error);
+  if (!result.parse_result) {
+    result.status = TelegramStatus::ParseError;
+    ++stats.parse_errors;
+  }
+}
+
+// Replays a capture of unencrypted telegrams. `sink(const ReplayedTelegram<Data>&)` is called for every telegram with a correct CRC,
+// in the order of the capture, on the calling thread. String values point into the capture.
+template <typename Data, typename Sink>
+ReplayStats replay_plaintext(std::string_view capture, const ReplayOptions& options, Sink sink) {
+  using Result = std::vector<ReplayedTelegram<Data>>;
+  const auto chunks = split_plaintext(capture, options.chunk_size, options.start_offset);
+  ReplayStats stats;
+  std::mutex stats_mutex;
+
+  run_ordered<Result>(
+      chunks.size(), options.threads,
+      [&](size_t index) {
+        Result result;
+        ReplayStats chunk_stats;
+        const auto chunk = chunks[index];
+        dsmr_parser::TelegramSplitter splitter(capture.substr(chunk.begin, chunk.end - chunk.begin), options.check_crc);
+        while (const auto telegram = splitter.next()) {
+          auto& replayed = result.emplace_back(
+              ReplayedTelegram<Data>{static_cast<size_t>(telegram->content().data() - capture.data()), TelegramStatus::Ok, *telegram, Data{}, {}});
+          parse_telegram(replayed, options, chunk_stats);
+        }
+        std::lock_guard lock(stats_mutex);
+        stats.parse_errors += chunk_stats.parse_errors;
+        return result;
+      },
+      [&](const Result& result) {
+        stats.telegrams += result.size();
+        for (const auto& telegram : result)
+          sink(telegram);
+      });
+  return stats;
+}
+
+// Replays a capture of DLMS packets encrypted with `key`. GcmDecryptor is one of the Aes128GcmDecryptor implementations.
+// Every thread decrypts a copy of its chunk, the string values point into that copy and are valid only during the `sink` call.
+template <typename Data, typename GcmDecryptor, typename Sink>
+ReplayStats replay_dlms(std::span<const uint8_t> capture, const dsmr_parser::Aes128GcmDecryptionKey& key, const ReplayOptions& options, Sink sink) {
+  struct Result final {
+    std::vector<uint8_t> bytes;
+    std::vector<ReplayedTelegram<Data>> telegrams;
+  };
+  const auto chunks = split_dlms(capture, options.chunk_size, options.start_offset);
+  ReplayStats stats;
+  std::mutex stats_mutex;
+
+  run_ordered<Result>(
+      chunks.size(), options.threads,
+      [&](size_t index) {
+        GcmDecryptor gcm_decryptor;
+        gcm_decryptor.set_encryption_key(key);
+        dsmr_parser::DlmsPacketDecryptor decryptor(gcm_decryptor);
+
+        Result result;
+        ReplayStats chunk_stats;
+        const auto chunk = chunks[index];
+        const auto bytes = capture.subspan(chunk.begin, chunk.end - chunk.begin);
+        result.bytes.assign(bytes.begin(), bytes.end());
+        walk_dlms_packets(bytes, [&](size_t offset, size_t size) {
+          auto& replayed = result.telegrams.emplace_back(
+              ReplayedTelegram<Data>{chunk.begin + offset, TelegramStatus::Ok, dsmr_parser::DsmrUnencryptedTelegram({}), Data{}, {}});
+          const auto telegram = decryptor.decrypt_inplace(std::span(result.bytes).subspan(offset, size));
+          if (!telegram) {
+            replayed.status = TelegramStatus::DecryptionError;
+            ++chunk_stats.decryption_errors;
+            return;
+          }
+          replayed.telegram = *telegram;
+          parse_telegram(replayed, options, chunk_stats);
+        });
+        std::lock_guard lock(stats_mutex);
+        stats.parse_errors += chunk_stats.parse_errors;
+        stats.decryption_errors += chunk_stats.decryption_errors;
+        return result;
+      },
+      [&](const Result& result) {
+        stats.telegrams += result.telegrams.size();
+        for (const auto& telegram : result.telegrams)
+          sink(telegram);
+      });
+  return stats;
+}
+
+}
@@ -0,0 +1,27 @@
+// A program that parses a telegram into a ParsedData with DSMR_SIZE_REPORT_FIELDS fields: 10, 50 or 154 (all fields of fields.h).
+// Compiled by size_report.py to measure the code size and the compile time of the parser for different numbers of fields.
+
+#include "dsmr_parser/fields.h"
+#include "dsmr_parser/parser.h"
+#include "field_sets.h"
+#include <cstdio>
+#include <cstring>
+
+#if DSMR_SIZE_REPORT_FIELDS == 10
+using Data = bench::Fields10;
+#elif DSMR_SIZE_REPORT_FIELDS == 50
+using Data = bench::Fields50;
+#elif DSMR_SIZE_REPORT_FIELDS == 154
+using Data = bench::FieldsAll;
+#else
+#error "DSMR_SIZE_REPORT_FIELDS must be 10, 50 or 154"
+#endif
+
+int main(int argc, char** argv) {
+  if (argc < 2)
+    return 2;
+  Data data;
+  const auto result = dsmr_parser::DsmrParser::parse(data, dsmr_parser::DsmrUnencryptedTelegram({argv[1], std::strlen(argv[1])}));
+  std::printf("%d\n", static_cast<int>(result.error));
+  return result ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Reports the code size and the compile time of a program that parses telegrams into a ParsedData with 10, 50 and 154 fields.
+#   tools/size_report/size_report.py [--compiler g++] [--flags "-Os"] [--size size]
+# Built by the dsmr_parser_size_report CMake target with the compiler of the build.
+# The size is the sum of the code sections of the object file, as reported by `size -A`. GCC and Clang only.
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+FIELD_COUNTS = [10, 50, 154]
+
+
+def code_size(size_tool, path):
+    output = subprocess.run([size_tool, "-A", path], check=True, capture_output=True, text=True).stdout
+    total = 0
+    for line in output.splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[0].startswith(".text") and parts[1].isdigit():
+            total += int(parts[1])
+    return total
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--compiler", default=os.environ.get("CXX", "g++"))
+    parser.add_argument("--flags", default="-Os", help="optimization flags, e.g. the ones of the target platform")
+    parser.add_argument("--size", default="size", help="the size tool of the toolchain")
+    args = parser.parse_args()
+
+    source = os.path.join(ROOT, "tools", "size_report", "parse_fields.cpp")
+    includes = ["-I" + os.path.join(ROOT, "src"), "-I" + os.path.join(ROOT, "bench")]
+    print(f"{'fields':>8} {'code bytes':>12} {'compile s':>10}")
+    with tempfile.TemporaryDirectory() as directory:
+        for count in FIELD_COUNTS:
+            obj = os.path.join(directory, f"parse_fields_{count}.o")
+            command = [args.compiler, "-std=c++20", *args.flags.split(), *includes, f"-DDSMR_SIZE_REPORT_FIELDS={count}", "-c", source, "-o", obj]
+            start = time.perf_counter()
+            result = subprocess.run(command)
+            seconds = time.perf_counter() - start
+            if result.returncode != 0:
+                return result.returncode
+            print(f"{count:>8} {code_size(args.size, obj):>12} {seconds:>10.2f}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())